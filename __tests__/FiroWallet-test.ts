@@ -0,0 +1,413 @@
+/**
+ * @format
+ */
+
+import RNLelantus from '../react-native-lelantus';
+import {FiroWallet} from '../src/core/FiroWallet';
+import {LelantusCoin} from '../src/data/LelantusCoin';
+import {LelantusEntry} from '../src/data/LelantusEntry';
+
+jest.mock('../react-native-lelantus', () => ({
+  __esModule: true,
+  default: {
+    openAnonymitySetStore: jest.fn(),
+    selectSpendCoins: jest.fn(),
+    getSpendProvingCost: jest.fn(),
+    getJMintBundle: jest.fn(),
+    getSpendScript: jest.fn(),
+    getMultiRecipientSpendScript: jest.fn(),
+    startSpeculativeSpend: jest.fn(),
+    discardSpeculativeSpend: jest.fn(),
+    planConsolidation: jest.fn(),
+    getConsolidationScript: jest.fn(),
+    markWalletCoinsUsed: jest.fn(),
+  },
+}));
+jest.mock('../src/core/FiroElectrum', () => ({
+  firoElectrum: {getLatestBlockHeight: () => 400000},
+}));
+jest.mock('../src/utils/logger', () => ({
+  __esModule: true,
+  default: {
+    debug: jest.fn(),
+    info: jest.fn(),
+    warn: jest.fn(),
+    error: jest.fn(),
+  },
+}));
+jest.mock('react-native-fs', () => ({DocumentDirectoryPath: '/documents'}));
+
+const mockRNLelantus = RNLelantus as {[method: string]: jest.Mock};
+
+const MNEMONIC = Array(11).fill('abandon').concat('about').join(' ');
+
+const FEE = 8913;
+const PUBLIC_COIN = '11'.repeat(34);
+const JMINT_SCRIPT = 'c7' + PUBLIC_COIN + '22'.repeat(16);
+
+function makeCoin(index: number, value: number, anonymitySetId: number) {
+  const coin = new LelantusCoin();
+  coin.index = index;
+  coin.value = value;
+  coin.anonymitySetId = anonymitySetId;
+  coin.txId = index.toString(16).padStart(64, '0');
+  return coin;
+}
+
+// selects the coins at the given positions of the unspent coins
+function mockSelection(positions: number[], changeToMint: number) {
+  mockRNLelantus.selectSpendCoins.mockImplementation(
+    (...args: any[]) => args[args.length - 1](FEE, changeToMint, positions),
+  );
+}
+
+function spentIndexes(entries: LelantusEntry[]) {
+  return entries.map(entry => entry.index);
+}
+
+// native calls every test needs, the proofs resolve with dummy scripts
+function mockNativeCalls() {
+  jest.clearAllMocks();
+  mockRNLelantus.openAnonymitySetStore.mockImplementation(
+    (directory: string, budget: number, callback: Function) =>
+      callback([1, 2]),
+  );
+  mockRNLelantus.getSpendProvingCost.mockImplementation(
+    (setIds: number[], callback: Function) => callback(1, 2, 3),
+  );
+  mockRNLelantus.getJMintBundle.mockImplementation(
+    (value: number, xprv: string, index: number, callback: Function) =>
+      callback(JMINT_SCRIPT, PUBLIC_COIN, '33'.repeat(32), '44'.repeat(32), 7),
+  );
+  mockRNLelantus.discardSpeculativeSpend.mockImplementation(
+    (callback: Function) => callback(),
+  );
+  mockRNLelantus.markWalletCoinsUsed.mockImplementation(
+    (indexes: number[], callback: Function) => callback(0),
+  );
+  mockRNLelantus.getSpendScript.mockResolvedValue('aa'.repeat(100));
+  mockRNLelantus.getMultiRecipientSpendScript.mockResolvedValue(
+    'bb'.repeat(100),
+  );
+  mockRNLelantus.startSpeculativeSpend.mockResolvedValue(undefined);
+  mockRNLelantus.getConsolidationScript.mockResolvedValue('cc'.repeat(100));
+}
+
+// three unspent coins, 3 and 7 in set 1 and 5 in set 2
+async function makeWallet() {
+  const wallet = new FiroWallet();
+  await wallet.setSecret(MNEMONIC);
+  wallet._coin_table_loaded = true;
+  wallet._unspent_coins = [
+    makeCoin(3, 100000000, 1),
+    makeCoin(5, 20000000, 2),
+    makeCoin(7, 50000000, 1),
+  ];
+  wallet.next_free_mint_index = 9;
+  return wallet;
+}
+
+describe('FiroWallet lelantus spends', () => {
+  let wallet: FiroWallet;
+  let address: string;
+
+  beforeEach(async () => {
+    mockNativeCalls();
+    wallet = await makeWallet();
+    address = await wallet._getExternalAddressByIndex(0);
+  });
+
+  it('proves the spend over the selected coins with their fee', async () => {
+    mockSelection([0, 2], 30000000 - FEE);
+
+    const tx = await wallet.createLelantusSpendTx({
+      spendAmount: 120000000,
+      subtractFeeFromAmount: false,
+      address,
+    });
+
+    expect(mockRNLelantus.getSpendScript).toHaveBeenCalledTimes(1);
+    const [value, subtract, fee, , index, coins] =
+      mockRNLelantus.getSpendScript.mock.calls[0];
+    expect(value).toBe(120000000);
+    expect(subtract).toBe(false);
+    expect(fee).toBe(FEE);
+    expect(index).toBe(9);
+    expect(spentIndexes(coins)).toEqual([3, 7]);
+
+    expect(tx.fee).toBe(FEE);
+    expect(tx.value).toBe(120000000);
+    expect(tx.jmintValue).toBe(30000000 - FEE);
+    expect(tx.spendCoinIndexes).toEqual([3, 7]);
+    expect(tx.mintIndex).toBe(9);
+  });
+
+  it('takes the fee from the amount when asked to', async () => {
+    mockSelection([0], 0);
+
+    const tx = await wallet.createLelantusSpendTx({
+      spendAmount: 100000000,
+      subtractFeeFromAmount: true,
+      address,
+    });
+
+    expect(mockRNLelantus.getSpendScript.mock.calls[0][1]).toBe(true);
+    expect(tx.value).toBe(100000000 - FEE);
+  });
+
+  it('rejects a spend the coins do not cover', async () => {
+    mockSelection([], 0);
+
+    await expect(
+      wallet.createLelantusSpendTx({
+        spendAmount: 1000000000,
+        subtractFeeFromAmount: false,
+        address,
+      }),
+    ).rejects.toThrow('Insufficient funds');
+    expect(mockRNLelantus.getSpendScript).not.toHaveBeenCalled();
+  });
+
+  it('passes native errors on', async () => {
+    mockSelection([0], 0);
+    mockRNLelantus.getSpendScript.mockRejectedValue(
+      new Error('Insufficient funds'),
+    );
+
+    await expect(
+      wallet.createLelantusSpendTx({
+        spendAmount: 100000000,
+        subtractFeeFromAmount: true,
+        address,
+      }),
+    ).rejects.toThrow('Insufficient funds');
+  });
+
+  it('pays every recipient from one proof', async () => {
+    mockSelection([0, 1], 100000);
+
+    const tx = await wallet.createLelantusPayoutTx({
+      outputs: [
+        {address, value: 70000000},
+        {address, value: 40000000},
+      ],
+    });
+
+    expect(
+      mockRNLelantus.getMultiRecipientSpendScript,
+    ).toHaveBeenCalledTimes(1);
+    const [outputValues, fee, , , coins] =
+      mockRNLelantus.getMultiRecipientSpendScript.mock.calls[0];
+    expect(outputValues).toEqual([70000000, 40000000]);
+    expect(fee).toBe(FEE);
+    expect(spentIndexes(coins)).toEqual([3, 5]);
+    expect(tx.value).toBe(110000000);
+    // outputCount of the selection
+    expect(mockRNLelantus.selectSpendCoins.mock.calls[0][6]).toBe(2);
+  });
+
+  it('rejects a payout without outputs', async () => {
+    await expect(wallet.createLelantusPayoutTx({outputs: []})).rejects.toThrow(
+      'No outputs to pay',
+    );
+    expect(wallet.isSpendPending()).toBe(false);
+  });
+
+  it('keeps a spend pending while it is proved', async () => {
+    mockSelection([0], 0);
+    let pendingWhileProving = false;
+    mockRNLelantus.getSpendScript.mockImplementation(async () => {
+      pendingWhileProving = wallet.isSpendPending();
+      return 'aa'.repeat(100);
+    });
+    expect(wallet.isSpendPending()).toBe(false);
+
+    await wallet.createLelantusSpendTx({
+      spendAmount: 100000000,
+      subtractFeeFromAmount: true,
+      address,
+    });
+    expect(pendingWhileProving).toBe(true);
+    expect(wallet.isSpendPending()).toBe(false);
+  });
+
+  it('is not cleared by coins a sync marks spent', async () => {
+    mockSelection([0], 0);
+    let pendingAfterSync = false;
+    mockRNLelantus.getSpendScript.mockImplementation(async () => {
+      await wallet.markCoinsSpend([5]);
+      pendingAfterSync = wallet.isSpendPending();
+      return 'aa'.repeat(100);
+    });
+
+    await wallet.createLelantusSpendTx({
+      spendAmount: 100000000,
+      subtractFeeFromAmount: true,
+      address,
+    });
+    expect(pendingAfterSync).toBe(true);
+    expect(mockRNLelantus.markWalletCoinsUsed.mock.calls[0][0]).toEqual([5]);
+  });
+
+  it('is no longer pending after a failed spend', async () => {
+    mockSelection([0], 0);
+    mockRNLelantus.getSpendScript.mockRejectedValue(
+      new Error('Unknown native error'),
+    );
+
+    await expect(
+      wallet.createLelantusSpendTx({
+        spendAmount: 100000000,
+        subtractFeeFromAmount: true,
+        address,
+      }),
+    ).rejects.toThrow('Unknown native error');
+    expect(wallet.isSpendPending()).toBe(false);
+  });
+
+  it('is no longer pending after a failed payout', async () => {
+    mockSelection([], 0);
+
+    await expect(
+      wallet.createLelantusPayoutTx({outputs: [{address, value: 1000000000}]}),
+    ).rejects.toThrow('Insufficient funds');
+    expect(wallet.isSpendPending()).toBe(false);
+  });
+
+  it('keeps a speculative spend pending until it is discarded', async () => {
+    mockSelection([2], 0);
+
+    const locktime = await wallet.startSpeculativeSpend({
+      spendAmount: 50000000,
+      subtractFeeFromAmount: true,
+      address,
+    });
+    expect(locktime).toBe(400000);
+    expect(wallet.isSpendPending()).toBe(true);
+    const [, , fee, , , coins] =
+      mockRNLelantus.startSpeculativeSpend.mock.calls[0];
+    expect(fee).toBe(FEE);
+    expect(spentIndexes(coins)).toEqual([7]);
+
+    // a sync marking coins spent leaves the proof pending
+    await wallet.markCoinsSpend([5]);
+    expect(wallet.isSpendPending()).toBe(true);
+
+    await wallet.discardSpeculativeSpend();
+    expect(wallet.isSpendPending()).toBe(false);
+  });
+
+  it('is no longer pending when a speculative spend fails to start', async () => {
+    mockSelection([2], 0);
+    mockRNLelantus.startSpeculativeSpend.mockRejectedValue(
+      new Error('Unknown native error'),
+    );
+
+    await expect(
+      wallet.startSpeculativeSpend({
+        spendAmount: 50000000,
+        subtractFeeFromAmount: true,
+        address,
+      }),
+    ).rejects.toThrow('Unknown native error');
+    expect(wallet.isSpendPending()).toBe(false);
+  });
+});
+
+const CONSOLIDATION_STEP = {
+  positions: [0, 2],
+  anonymitySetId: 1,
+  fee: FEE,
+  mintValue: 150000000 - FEE,
+  provingCost: {deserializedPoints: 10, provedPoints: 20, setBytes: 340},
+};
+
+describe('FiroWallet consolidation', () => {
+  let wallet: FiroWallet;
+
+  beforeEach(async () => {
+    mockNativeCalls();
+    mockRNLelantus.planConsolidation.mockImplementation(
+      (...args: any[]) => args[args.length - 1]([CONSOLIDATION_STEP]),
+    );
+    wallet = await makeWallet();
+  });
+
+  it('plans steps over the unspent coins', async () => {
+    const steps = await wallet.planConsolidation();
+
+    const [amounts, setIds] = mockRNLelantus.planConsolidation.mock.calls[0];
+    expect(amounts).toEqual([100000000, 20000000, 50000000]);
+    expect(setIds).toEqual([1, 2, 1]);
+    expect(steps).toEqual([
+      {
+        spendCoinIndexes: [3, 7],
+        fee: FEE,
+        mintValue: 150000000 - FEE,
+        provingCost: CONSOLIDATION_STEP.provingCost,
+      },
+    ]);
+  });
+
+  it('merges the coins of a step into one jmint', async () => {
+    const [step] = await wallet.planConsolidation();
+
+    const tx = await wallet.createConsolidationTx(step);
+
+    expect(mockRNLelantus.getJMintBundle.mock.calls[0][0]).toBe(
+      150000000 - FEE,
+    );
+    const [, index, coins] =
+      mockRNLelantus.getConsolidationScript.mock.calls[0];
+    expect(index).toBe(9);
+    expect(spentIndexes(coins)).toEqual([3, 7]);
+    expect(tx.value).toBe(0);
+    expect(tx.fee).toBe(FEE);
+    expect(tx.jmintValue).toBe(150000000 - FEE);
+    expect(tx.spendCoinIndexes).toEqual([3, 7]);
+  });
+
+  it('drops a step whose coins were spent since', async () => {
+    const [step] = await wallet.planConsolidation();
+    wallet._unspent_coins = wallet._unspent_coins.slice(0, 2);
+
+    await expect(wallet.createConsolidationTx(step)).rejects.toThrow(
+      'Consolidated coins are not unspent',
+    );
+    expect(mockRNLelantus.getConsolidationScript).not.toHaveBeenCalled();
+  });
+
+  it('passes native errors on', async () => {
+    const [step] = await wallet.planConsolidation();
+    mockRNLelantus.getConsolidationScript.mockRejectedValue(
+      new Error('Unknown native error'),
+    );
+
+    await expect(wallet.createConsolidationTx(step)).rejects.toThrow(
+      'Unknown native error',
+    );
+    expect(wallet.isSpendPending()).toBe(false);
+  });
+
+  it('keeps its coins out of spends while it is proved', async () => {
+    const [step] = await wallet.planConsolidation();
+    mockSelection([0], 0);
+    let pendingWhileProving = false;
+    mockRNLelantus.getConsolidationScript.mockImplementation(async () => {
+      pendingWhileProving = wallet.isSpendPending();
+      await wallet.estimateJoinSplitFee({
+        spendAmount: 10000000,
+        subtractFeeFromAmount: true,
+      });
+      return 'cc'.repeat(100);
+    });
+
+    await wallet.createConsolidationTx(step);
+    expect(pendingWhileProving).toBe(true);
+    expect(wallet.isSpendPending()).toBe(false);
+    // only coin 5 of set 2 was left to select from
+    const [amounts, setIds] = mockRNLelantus.selectSpendCoins.mock.calls[0];
+    expect(amounts).toEqual([20000000]);
+    expect(setIds).toEqual([2]);
+  });
+});
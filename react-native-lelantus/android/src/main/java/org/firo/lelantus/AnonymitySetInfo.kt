@@ -0,0 +1,7 @@
+package org.firo.lelantus
+
+class AnonymitySetInfo(
+    val setHash: String,
+    val blockHash: String,
+    val size: Int
+)
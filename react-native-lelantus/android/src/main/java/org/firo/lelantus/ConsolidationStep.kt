@@ -0,0 +1,11 @@
+package org.firo.lelantus
+
+class ConsolidationStep(
+    val positions: IntArray,
+    val anonymitySetId: Int,
+    val fee: Long,
+    val mintValue: Long,
+    val deserializedPoints: Long,
+    val provedPoints: Long,
+    val setBytes: Long
+)
@@ -44,29 +44,45 @@ object Lelantus {
         return jCreateJMintScript(value, privateKey, index, seed, privateKeyAES)
     }
 
+    fun createJMintBundle(value: Long, xprv: String, index: Int): MintBundle {
+        return jCreateJMintBundle(value, xprv, index)
+    }
+
     fun createSpendScript(
         spendAmount: Long,
         subtractFeeFromAmount: Boolean,
+        fee: Long,
         privateKey: String,
         index: Int,
         coins: Array<LelantusEntry>,
-        txHash: String,
-        setIds: IntArray,
-        anonymitySets: Array<Array<String>>,
-        anonymitySetHashes: Array<String>,
-        groupBlockHashes: Array<String>
+        txHash: String
     ): String {
         return jCreateSpendScript(
             spendAmount,
             subtractFeeFromAmount,
+            fee,
             privateKey,
             index,
             coins,
-            txHash,
-            setIds,
-            anonymitySets,
-            anonymitySetHashes,
-            groupBlockHashes
+            txHash
+        )
+    }
+
+    fun createMultiRecipientSpendScript(
+        outputValues: LongArray,
+        fee: Long,
+        privateKey: String,
+        index: Int,
+        coins: Array<LelantusEntry>,
+        txHash: String
+    ): String {
+        return jCreateMultiRecipientSpendScript(
+            outputValues,
+            fee,
+            privateKey,
+            index,
+            coins,
+            txHash
         )
     }
 
@@ -74,6 +90,187 @@ object Lelantus {
         return jDecryptMintAmount(privateKeyAES, encryptedValue)
     }
 
+    fun createTagBatch(xprv: String, startIndex: Int, count: Int): Array<String> {
+        return jCreateTagBatch(xprv, startIndex, count)
+    }
+
+    fun createMintsBatch(
+        xprv: String,
+        indexes: IntArray,
+        values: LongArray
+    ): Array<MintBundle> {
+        return jCreateMintsBatch(xprv, indexes, values)
+    }
+
+    fun openUsedSerialSet(path: String): Long {
+        return jOpenUsedSerialSet(path)
+    }
+
+    fun appendUsedSerials(serials: Array<String>): Long {
+        return jAppendUsedSerials(serials)
+    }
+
+    fun getAnonymitySetInfo(setId: Int): AnonymitySetInfo {
+        return jGetAnonymitySetInfo(setId)
+    }
+
+    fun mergeAnonymitySetResponse(setId: Int, response: String): LongArray? {
+        return jMergeAnonymitySetResponse(setId, response)
+    }
+
+    fun updateAnonymitySet(
+        setId: Int,
+        setHash: String,
+        blockHash: String,
+        publicCoins: Array<String>,
+        tags: Array<String>,
+        values: LongArray,
+        encryptedValues: Array<String>,
+        txIds: Array<String>
+    ) {
+        jUpdateAnonymitySet(
+            setId,
+            setHash,
+            blockHash,
+            publicCoins,
+            tags,
+            values,
+            encryptedValues,
+            txIds
+        )
+    }
+
+    fun scanMints(xprv: String, startIndex: Int, gapLimit: Int): Array<ScannedMint> {
+        return jScanMints(xprv, startIndex, gapLimit)
+    }
+
+    fun selectSpendCoins(
+        amounts: LongArray,
+        setIds: IntArray,
+        heights: IntArray,
+        spendAmount: Long,
+        subtractFeeFromAmount: Boolean,
+        strategy: Int,
+        outputCount: Int
+    ): JoinSplitData {
+        return jSelectSpendCoins(
+            amounts,
+            setIds,
+            heights,
+            spendAmount,
+            subtractFeeFromAmount,
+            strategy,
+            outputCount
+        )
+    }
+
+    fun benchmarkCoinSelection(coinCount: Int, rounds: Int): String {
+        return jBenchmarkCoinSelection(coinCount, rounds)
+    }
+
+    fun quickEstimateFee(
+        amounts: LongArray,
+        setIds: IntArray,
+        spendAmount: Long,
+        subtractFeeFromAmount: Boolean
+    ): Long {
+        return jQuickEstimateFee(amounts, setIds, spendAmount, subtractFeeFromAmount)
+    }
+
+    fun getSpendProvingCost(setIds: IntArray): LongArray {
+        return jGetSpendProvingCost(setIds)
+    }
+
+    fun openAnonymitySetStore(directory: String, memoryBudgetMb: Int): IntArray {
+        return jOpenAnonymitySetStore(directory, memoryBudgetMb)
+    }
+
+    fun containsMintTags(tags: Array<String>): BooleanArray {
+        return jContainsMintTags(tags)
+    }
+
+    fun cacheAnonymitySetPoints(setIds: IntArray): Long {
+        return jCacheAnonymitySetPoints(setIds)
+    }
+
+    fun startSpendPrewarm(setIds: IntArray) {
+        jStartSpendPrewarm(setIds)
+    }
+
+    fun startSpeculativeSpend(
+        spendAmount: Long,
+        subtractFeeFromAmount: Boolean,
+        fee: Long,
+        privateKey: String,
+        index: Int,
+        coins: Array<LelantusEntry>,
+        txHash: String
+    ) {
+        jStartSpeculativeSpend(
+            spendAmount,
+            subtractFeeFromAmount,
+            fee,
+            privateKey,
+            index,
+            coins,
+            txHash
+        )
+    }
+
+    fun discardSpeculativeSpend() {
+        jDiscardSpeculativeSpend()
+    }
+
+    fun loadWalletCoins(coins: Array<LelantusCoin>): Long {
+        return jLoadWalletCoins(coins)
+    }
+
+    fun putWalletCoins(coins: Array<LelantusCoin>): Long {
+        return jPutWalletCoins(coins)
+    }
+
+    fun markWalletCoinsUsed(indexes: IntArray): Long {
+        return jMarkWalletCoinsUsed(indexes)
+    }
+
+    fun markSpentWalletCoins(xprv: String): Long {
+        return jMarkSpentWalletCoins(xprv)
+    }
+
+    fun updateWalletCoinSetIds(): Array<String> {
+        return jUpdateWalletCoinSetIds()
+    }
+
+    fun getWalletCoins(filter: Int): Array<LelantusCoin> {
+        return jGetWalletCoins(filter)
+    }
+
+    fun getUnspentCoinSetIds(): IntArray {
+        return jGetUnspentCoinSetIds()
+    }
+
+    fun parseJoinSplits(rawTxs: Array<String>): Array<ParsedJoinSplit> {
+        return jParseJoinSplits(rawTxs)
+    }
+
+    fun planConsolidation(
+        amounts: LongArray,
+        setIds: IntArray,
+        minCoins: Int,
+        maxInputs: Int
+    ): Array<ConsolidationStep> {
+        return jPlanConsolidation(amounts, setIds, minCoins, maxInputs)
+    }
+
+    fun createConsolidationScript(
+        privateKey: String,
+        index: Int,
+        coins: Array<LelantusEntry>,
+        txHash: String
+    ): String {
+        return jCreateConsolidationScript(privateKey, index, coins, txHash)
+    }
+
     external fun jCreateMintScript(
         value: Long,
         privateKey: String,
@@ -117,21 +314,129 @@ object Lelantus {
         privateKeyAES: String
     ): String
 
+    external fun jCreateJMintBundle(value: Long, xprv: String, index: Int): MintBundle
+
     external fun jCreateSpendScript(
         spendAmount: Long,
         subtractFeeFromAmount: Boolean,
+        fee: Long,
         privateKey: String,
         index: Int,
         coins: Array<LelantusEntry>,
-        txHash: String,
-        setIds: IntArray,
-        anonymitySets: Array<Array<String>>,
-        anonymitySetHashes: Array<String>,
-        groupBlockHashes: Array<String>
+        txHash: String
+    ): String
+
+    external fun jCreateMultiRecipientSpendScript(
+        outputValues: LongArray,
+        fee: Long,
+        privateKey: String,
+        index: Int,
+        coins: Array<LelantusEntry>,
+        txHash: String
     ): String
 
     external fun jDecryptMintAmount(
         privateKeyAES: String,
         encryptedValue: String
     ): Long
-}
\ No newline at end of file
+
+    external fun jCreateTagBatch(xprv: String, startIndex: Int, count: Int): Array<String>
+
+    external fun jCreateMintsBatch(
+        xprv: String,
+        indexes: IntArray,
+        values: LongArray
+    ): Array<MintBundle>
+
+    external fun jOpenUsedSerialSet(path: String): Long
+
+    external fun jAppendUsedSerials(serials: Array<String>): Long
+
+    external fun jGetAnonymitySetInfo(setId: Int): AnonymitySetInfo
+
+    external fun jMergeAnonymitySetResponse(setId: Int, response: String): LongArray?
+
+    external fun jUpdateAnonymitySet(
+        setId: Int,
+        setHash: String,
+        blockHash: String,
+        publicCoins: Array<String>,
+        tags: Array<String>,
+        values: LongArray,
+        encryptedValues: Array<String>,
+        txIds: Array<String>
+    )
+
+    external fun jScanMints(xprv: String, startIndex: Int, gapLimit: Int): Array<ScannedMint>
+
+    external fun jSelectSpendCoins(
+        amounts: LongArray,
+        setIds: IntArray,
+        heights: IntArray,
+        spendAmount: Long,
+        subtractFeeFromAmount: Boolean,
+        strategy: Int,
+        outputCount: Int
+    ): JoinSplitData
+
+    external fun jBenchmarkCoinSelection(coinCount: Int, rounds: Int): String
+
+    external fun jQuickEstimateFee(
+        amounts: LongArray,
+        setIds: IntArray,
+        spendAmount: Long,
+        subtractFeeFromAmount: Boolean
+    ): Long
+
+    external fun jGetSpendProvingCost(setIds: IntArray): LongArray
+
+    external fun jOpenAnonymitySetStore(directory: String, memoryBudgetMb: Int): IntArray
+
+    external fun jContainsMintTags(tags: Array<String>): BooleanArray
+
+    external fun jCacheAnonymitySetPoints(setIds: IntArray): Long
+
+    external fun jStartSpendPrewarm(setIds: IntArray)
+
+    external fun jStartSpeculativeSpend(
+        spendAmount: Long,
+        subtractFeeFromAmount: Boolean,
+        fee: Long,
+        privateKey: String,
+        index: Int,
+        coins: Array<LelantusEntry>,
+        txHash: String
+    )
+
+    external fun jDiscardSpeculativeSpend()
+
+    external fun jLoadWalletCoins(coins: Array<LelantusCoin>): Long
+
+    external fun jPutWalletCoins(coins: Array<LelantusCoin>): Long
+
+    external fun jMarkWalletCoinsUsed(indexes: IntArray): Long
+
+    external fun jMarkSpentWalletCoins(xprv: String): Long
+
+    external fun jUpdateWalletCoinSetIds(): Array<String>
+
+    external fun jGetWalletCoins(filter: Int): Array<LelantusCoin>
+
+    external fun jGetUnspentCoinSetIds(): IntArray
+
+    external fun jParseJoinSplits(rawTxs: Array<String>): Array<ParsedJoinSplit>
+
+    external fun jPlanConsolidation(
+        amounts: LongArray,
+        setIds: IntArray,
+        minCoins: Int,
+        maxInputs: Int
+    ): Array<ConsolidationStep>
+
+    external fun jCreateConsolidationScript(
+        privateKey: String,
+        index: Int,
+        coins: Array<LelantusEntry>,
+        txHash: String
+    ): String
+}
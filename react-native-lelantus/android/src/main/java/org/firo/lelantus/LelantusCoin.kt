@@ -0,0 +1,10 @@
+package org.firo.lelantus
+
+class LelantusCoin(
+    val index: Int,
+    val value: Long,
+    val publicCoin: String,
+    val txId: String,
+    val anonymitySetId: Int,
+    val isUsed: Boolean
+)
@@ -2,15 +2,21 @@ package org.firo.lelantus;
 
 import com.facebook.react.bridge.Arguments;
 import com.facebook.react.bridge.Callback;
+import com.facebook.react.bridge.Promise;
 import com.facebook.react.bridge.ReactApplicationContext;
 import com.facebook.react.bridge.ReactContextBaseJavaModule;
 import com.facebook.react.bridge.ReactMethod;
 import com.facebook.react.bridge.ReadableArray;
 import com.facebook.react.bridge.ReadableMap;
+import com.facebook.react.bridge.ReadableType;
 import com.facebook.react.bridge.WritableArray;
+import com.facebook.react.bridge.WritableMap;
 
 public class LelantusModule extends ReactContextBaseJavaModule {
 
+	// code of the rejection when the native code can't build a spend
+	private static final String SPEND_ERROR = "E_SPEND";
+
 	private final ReactApplicationContext reactContext;
 
 	static {
@@ -128,80 +134,588 @@ public class LelantusModule extends ReactContextBaseJavaModule {
 		callback.invoke(script, publicCoin);
 	}
 
+	@ReactMethod
+	public void getJMintBundle(
+			double value,
+			String xprv,
+			int index,
+			Callback callback
+	) {
+		MintBundle bundle = Lelantus.INSTANCE.createJMintBundle((long) value, xprv, index);
+		callback.invoke(
+				bundle.getScript(),
+				bundle.getPublicCoin(),
+				bundle.getTag(),
+				bundle.getSerialNumber(),
+				(double) bundle.getKeyPath());
+	}
+
 	@ReactMethod
 	public void getSpendScript(
 			double spendAmount,
 			boolean subtractFeeFromAmount,
+			double fee,
+			String privateKey,
+			int index,
+			ReadableArray coinsArray,
+			String txHash,
+			Promise promise
+	) {
+		LelantusEntry[] coins = toLelantusEntries(coinsArray);
+		try {
+			String script = Lelantus.INSTANCE.createSpendScript(
+					(long) spendAmount,
+					subtractFeeFromAmount,
+					(long) fee,
+					privateKey,
+					index,
+					coins,
+					txHash);
+			promise.resolve(script);
+		} catch (RuntimeException e) {
+			promise.reject(SPEND_ERROR, e.getMessage(), e);
+		}
+	}
+
+	@ReactMethod
+	public void getMultiRecipientSpendScript(
+			ReadableArray outputValuesArray,
+			double fee,
 			String privateKey,
 			int index,
 			ReadableArray coinsArray,
 			String txHash,
+			Promise promise
+	) {
+		long[] outputValues = new long[outputValuesArray.size()];
+		for (int i = 0; i < outputValuesArray.size(); i++) {
+			outputValues[i] = (long) outputValuesArray.getDouble(i);
+		}
+		try {
+			String script = Lelantus.INSTANCE.createMultiRecipientSpendScript(
+					outputValues,
+					(long) fee,
+					privateKey,
+					index,
+					toLelantusEntries(coinsArray),
+					txHash);
+			promise.resolve(script);
+		} catch (RuntimeException e) {
+			promise.reject(SPEND_ERROR, e.getMessage(), e);
+		}
+	}
+
+	@ReactMethod
+	public void decryptMintAmount(
+			String privateKeyAES,
+			String encryptedValue,
+			Callback callback
+	) {
+		double amount = Lelantus.INSTANCE.decryptMintAmount(privateKeyAES, encryptedValue);
+		callback.invoke(amount);
+	}
+
+	@ReactMethod
+	public void getMintTagBatch(
+			String xprv,
+			int startIndex,
+			int count,
+			Callback callback
+	) {
+		String[] tags = Lelantus.INSTANCE.createTagBatch(xprv, startIndex, count);
+		WritableArray result = Arguments.createArray();
+		for (String tag : tags) {
+			result.pushString(tag);
+		}
+		callback.invoke(result);
+	}
+
+	@ReactMethod
+	public void createMintsBatch(
+			String xprv,
+			ReadableArray indexesArray,
+			ReadableArray valuesArray,
+			Callback callback
+	) {
+		int[] indexes = new int[indexesArray.size()];
+		long[] values = new long[indexesArray.size()];
+		for (int i = 0; i < indexesArray.size(); i++) {
+			indexes[i] = indexesArray.getInt(i);
+			values[i] = (long) valuesArray.getDouble(i);
+		}
+		MintBundle[] bundles = Lelantus.INSTANCE.createMintsBatch(xprv, indexes, values);
+		WritableArray result = Arguments.createArray();
+		for (MintBundle bundle : bundles) {
+			WritableMap bundleMap = Arguments.createMap();
+			bundleMap.putString("script", bundle.getScript());
+			bundleMap.putString("publicCoin", bundle.getPublicCoin());
+			bundleMap.putString("tag", bundle.getTag());
+			bundleMap.putString("serialNumber", bundle.getSerialNumber());
+			bundleMap.putDouble("keyPath", (double) bundle.getKeyPath());
+			result.pushMap(bundleMap);
+		}
+		callback.invoke(result);
+	}
+
+	@ReactMethod
+	public void openUsedSerialSet(
+			String path,
+			Callback callback
+	) {
+		double count = (double) Lelantus.INSTANCE.openUsedSerialSet(path);
+		callback.invoke(count);
+	}
+
+	@ReactMethod
+	public void appendUsedSerials(
+			ReadableArray serialsArray,
+			Callback callback
+	) {
+		String[] serials = new String[serialsArray.size()];
+		for (int i = 0; i < serialsArray.size(); i++) {
+			serials[i] = serialsArray.getString(i);
+		}
+		double count = (double) Lelantus.INSTANCE.appendUsedSerials(serials);
+		callback.invoke(count);
+	}
+
+	@ReactMethod
+	public void getAnonymitySetInfo(
+			int setId,
+			Callback callback
+	) {
+		AnonymitySetInfo info = Lelantus.INSTANCE.getAnonymitySetInfo(setId);
+		callback.invoke(info.getSetHash(), info.getBlockHash(), info.getSize());
+	}
+
+	@ReactMethod
+	public void mergeAnonymitySetResponse(
+			int setId,
+			String response,
+			Callback callback
+	) {
+		long[] range = Lelantus.INSTANCE.mergeAnonymitySetResponse(setId, response);
+		if (range == null) {
+			callback.invoke();
+			return;
+		}
+		callback.invoke((double) range[0], (double) range[1]);
+	}
+
+	@ReactMethod
+	public void updateAnonymitySet(
+			int setId,
+			String setHash,
+			String blockHash,
+			ReadableArray coinsArray,
+			Callback callback
+	) {
+		int size = coinsArray.size();
+		String[] publicCoins = new String[size];
+		String[] tags = new String[size];
+		long[] values = new long[size];
+		String[] encryptedValues = new String[size];
+		String[] txIds = new String[size];
+		for (int i = 0; i < size; i++) {
+			ReadableArray coin = coinsArray.getArray(i);
+			publicCoins[i] = coin.getString(0);
+			tags[i] = coin.getString(1);
+			// mints have a plain amount, jmints an encrypted one
+			if (coin.getType(2) == ReadableType.Number) {
+				values[i] = (long) coin.getDouble(2);
+				encryptedValues[i] = "";
+			} else {
+				values[i] = 0;
+				encryptedValues[i] = coin.getString(2);
+			}
+			txIds[i] = coin.getString(3);
+		}
+		Lelantus.INSTANCE.updateAnonymitySet(
+				setId,
+				setHash,
+				blockHash,
+				publicCoins,
+				tags,
+				values,
+				encryptedValues,
+				txIds
+		);
+		callback.invoke();
+	}
+
+	@ReactMethod
+	public void scanMints(
+			String xprv,
+			int startIndex,
+			int gapLimit,
+			Callback callback
+	) {
+		ScannedMint[] mints = Lelantus.INSTANCE.scanMints(xprv, startIndex, gapLimit);
+		WritableArray result = Arguments.createArray();
+		for (ScannedMint mint : mints) {
+			WritableMap mintMap = Arguments.createMap();
+			mintMap.putInt("index", mint.getIndex());
+			mintMap.putDouble("value", (double) mint.getValue());
+			mintMap.putString("publicCoin", mint.getPublicCoin());
+			mintMap.putString("txId", mint.getTxId());
+			mintMap.putInt("anonymitySetId", mint.getAnonymitySetId());
+			mintMap.putBoolean("isJMint", mint.isJMint());
+			mintMap.putBoolean("isUsed", mint.isUsed());
+			result.pushMap(mintMap);
+		}
+		callback.invoke(result);
+	}
+
+	@ReactMethod
+	public void selectSpendCoins(
+			ReadableArray amountsArray,
 			ReadableArray setIdsArray,
-			ReadableArray anonymitySetsArray,
-			ReadableArray anonymitySetHashesArray,
-			ReadableArray groupBlockHashesArray,
+			ReadableArray heightsArray,
+			double spendAmount,
+			boolean subtractFeeFromAmount,
+			int strategy,
+			int outputCount,
 			Callback callback
 	) {
-		LelantusEntry[] coins = new LelantusEntry[coinsArray.size()];
-		for (int i = 0; i < coinsArray.size(); i++) {
-			ReadableMap lelantusEntryMap = coinsArray.getMap(i);
-			LelantusEntry lelantusEntry = new LelantusEntry(
-					(long) lelantusEntryMap.getDouble("amount"),
-					lelantusEntryMap.getString("privateKey"),
-					lelantusEntryMap.getInt("index"),
-					lelantusEntryMap.getBoolean("isUsed"),
-					lelantusEntryMap.getInt("height"),
-					lelantusEntryMap.getInt("anonymitySetId")
-			);
-			coins[i] = lelantusEntry;
+		int size = amountsArray.size();
+		long[] amounts = new long[size];
+		int[] setIds = new int[size];
+		int[] heights = new int[size];
+		for (int i = 0; i < size; i++) {
+			amounts[i] = (long) amountsArray.getDouble(i);
+			setIds[i] = setIdsArray.getInt(i);
+			heights[i] = heightsArray.getInt(i);
 		}
+		JoinSplitData data = Lelantus.INSTANCE.selectSpendCoins(
+				amounts,
+				setIds,
+				heights,
+				(long) spendAmount,
+				subtractFeeFromAmount,
+				strategy,
+				outputCount
+		);
+		WritableArray positions = Arguments.createArray();
+		for (int i = 0; i < data.getSpendCoinIndexes().length; i++) {
+			positions.pushInt(data.getSpendCoinIndexes()[i]);
+		}
+		callback.invoke((double) data.getFee(), (double) data.getChangeToMint(), positions);
+	}
+
+	@ReactMethod
+	public void benchmarkCoinSelection(
+			int coinCount,
+			int rounds,
+			Callback callback
+	) {
+		String report = Lelantus.INSTANCE.benchmarkCoinSelection(coinCount, rounds);
+		callback.invoke(report);
+	}
 
+	@ReactMethod
+	public void quickEstimateFee(
+			ReadableArray amountsArray,
+			ReadableArray setIdsArray,
+			double spendAmount,
+			boolean subtractFeeFromAmount,
+			Callback callback
+	) {
+		int size = amountsArray.size();
+		long[] amounts = new long[size];
+		int[] setIds = new int[size];
+		for (int i = 0; i < size; i++) {
+			amounts[i] = (long) amountsArray.getDouble(i);
+			setIds[i] = setIdsArray.getInt(i);
+		}
+		double fee = (double) Lelantus.INSTANCE.quickEstimateFee(
+				amounts,
+				setIds,
+				(long) spendAmount,
+				subtractFeeFromAmount
+		);
+		callback.invoke(fee);
+	}
+
+	@ReactMethod
+	public void getSpendProvingCost(ReadableArray setIdsArray, Callback callback) {
 		int[] setIds = new int[setIdsArray.size()];
 		for (int i = 0; i < setIdsArray.size(); i++) {
 			setIds[i] = setIdsArray.getInt(i);
 		}
+		long[] cost = Lelantus.INSTANCE.getSpendProvingCost(setIds);
+		callback.invoke((double) cost[0], (double) cost[1], (double) cost[2]);
+	}
 
-		String[][] anonymitySets = new String[anonymitySetsArray.size()][];
-		for (int i = 0; i < anonymitySetsArray.size(); i++) {
-			ReadableArray anonymitySetArray = anonymitySetsArray.getArray(i);
-			String[] anonymitySet = new String[anonymitySetArray.size()];
-			anonymitySets[i] = anonymitySet;
-			for (int j = 0; j < anonymitySetArray.size(); j++) {
-				anonymitySet[j] = anonymitySetArray.getString(j);
-			}
+	@ReactMethod
+	public void openAnonymitySetStore(String directory, int memoryBudgetMb, Callback callback) {
+		int[] setIds = Lelantus.INSTANCE.openAnonymitySetStore(directory, memoryBudgetMb);
+		WritableArray result = Arguments.createArray();
+		for (int setId : setIds) {
+			result.pushInt(setId);
 		}
+		callback.invoke(result);
+	}
 
-		String[] anonymitySetHashes = new String[anonymitySetHashesArray.size()];
-		for (int i = 0; i < anonymitySetHashesArray.size(); i++) {
-			anonymitySetHashes[i] = anonymitySetHashesArray.getString(i);
+	@ReactMethod
+	public void containsMintTags(ReadableArray tagsArray, Callback callback) {
+		String[] tags = new String[tagsArray.size()];
+		for (int i = 0; i < tagsArray.size(); i++) {
+			tags[i] = tagsArray.getString(i);
 		}
+		boolean[] contains = Lelantus.INSTANCE.containsMintTags(tags);
+		WritableArray result = Arguments.createArray();
+		for (boolean found : contains) {
+			result.pushBoolean(found);
+		}
+		callback.invoke(result);
+	}
 
-		String[] groupBlockHashes = new String[groupBlockHashesArray.size()];
-		for (int i = 0; i < groupBlockHashesArray.size(); i++) {
-			groupBlockHashes[i] = groupBlockHashesArray.getString(i);
+	@ReactMethod
+	public void cacheAnonymitySetPoints(ReadableArray setIdsArray, Callback callback) {
+		int[] setIds = new int[setIdsArray.size()];
+		for (int i = 0; i < setIdsArray.size(); i++) {
+			setIds[i] = setIdsArray.getInt(i);
 		}
+		long cached = Lelantus.INSTANCE.cacheAnonymitySetPoints(setIds);
+		callback.invoke((double) cached);
+	}
 
-		String script = Lelantus.INSTANCE.createSpendScript(
-				(long) spendAmount,
-				subtractFeeFromAmount,
-				privateKey,
-				index,
-				coins,
-				txHash,
-				setIds,
-				anonymitySets,
-				anonymitySetHashes,
-				groupBlockHashes);
-		callback.invoke(script);
+	@ReactMethod
+	public void startSpendPrewarm(ReadableArray setIdsArray, Callback callback) {
+		int[] setIds = new int[setIdsArray.size()];
+		for (int i = 0; i < setIdsArray.size(); i++) {
+			setIds[i] = setIdsArray.getInt(i);
+		}
+		Lelantus.INSTANCE.startSpendPrewarm(setIds);
+		callback.invoke();
 	}
 
 	@ReactMethod
-	public void decryptMintAmount(
-			String privateKeyAES,
-			String encryptedValue,
+	public void startSpeculativeSpend(
+			double spendAmount,
+			boolean subtractFeeFromAmount,
+			double fee,
+			String privateKey,
+			int index,
+			ReadableArray coinsArray,
+			String txHash,
+			Promise promise
+	) {
+		try {
+			Lelantus.INSTANCE.startSpeculativeSpend(
+					(long) spendAmount,
+					subtractFeeFromAmount,
+					(long) fee,
+					privateKey,
+					index,
+					toLelantusEntries(coinsArray),
+					txHash);
+			promise.resolve(null);
+		} catch (RuntimeException e) {
+			promise.reject(SPEND_ERROR, e.getMessage(), e);
+		}
+	}
+
+	@ReactMethod
+	public void discardSpeculativeSpend(Callback callback) {
+		Lelantus.INSTANCE.discardSpeculativeSpend();
+		callback.invoke();
+	}
+
+	@ReactMethod
+	public void loadWalletCoins(ReadableArray coinsArray, Callback callback) {
+		long dropped = Lelantus.INSTANCE.loadWalletCoins(toLelantusCoins(coinsArray));
+		callback.invoke((double) dropped);
+	}
+
+	@ReactMethod
+	public void putWalletCoins(ReadableArray coinsArray, Callback callback) {
+		long changed = Lelantus.INSTANCE.putWalletCoins(toLelantusCoins(coinsArray));
+		callback.invoke((double) changed);
+	}
+
+	@ReactMethod
+	public void markWalletCoinsUsed(ReadableArray indexesArray, Callback callback) {
+		int[] indexes = new int[indexesArray.size()];
+		for (int i = 0; i < indexesArray.size(); i++) {
+			indexes[i] = indexesArray.getInt(i);
+		}
+		long marked = Lelantus.INSTANCE.markWalletCoinsUsed(indexes);
+		callback.invoke((double) marked);
+	}
+
+	@ReactMethod
+	public void markSpentWalletCoins(String xprv, Callback callback) {
+		long marked = Lelantus.INSTANCE.markSpentWalletCoins(xprv);
+		callback.invoke((double) marked);
+	}
+
+	@ReactMethod
+	public void updateWalletCoinSetIds(Callback callback) {
+		String[] txIds = Lelantus.INSTANCE.updateWalletCoinSetIds();
+		WritableArray result = Arguments.createArray();
+		for (String txId : txIds) {
+			result.pushString(txId);
+		}
+		callback.invoke(result);
+	}
+
+	@ReactMethod
+	public void getWalletCoins(int filter, Callback callback) {
+		LelantusCoin[] coins = Lelantus.INSTANCE.getWalletCoins(filter);
+		WritableArray result = Arguments.createArray();
+		for (LelantusCoin coin : coins) {
+			WritableMap coinMap = Arguments.createMap();
+			coinMap.putInt("index", coin.getIndex());
+			coinMap.putDouble("value", (double) coin.getValue());
+			coinMap.putString("publicCoin", coin.getPublicCoin());
+			coinMap.putString("txId", coin.getTxId());
+			coinMap.putInt("anonymitySetId", coin.getAnonymitySetId());
+			coinMap.putBoolean("isUsed", coin.isUsed());
+			result.pushMap(coinMap);
+		}
+		callback.invoke(result);
+	}
+
+	@ReactMethod
+	public void getUnspentCoinSetIds(Callback callback) {
+		int[] setIds = Lelantus.INSTANCE.getUnspentCoinSetIds();
+		WritableArray result = Arguments.createArray();
+		for (int setId : setIds) {
+			result.pushInt(setId);
+		}
+		callback.invoke(result);
+	}
+
+	@ReactMethod
+	public void parseJoinSplits(ReadableArray rawTxsArray, Callback callback) {
+		String[] rawTxs = new String[rawTxsArray.size()];
+		for (int i = 0; i < rawTxsArray.size(); i++) {
+			rawTxs[i] = rawTxsArray.getString(i);
+		}
+		ParsedJoinSplit[] joinSplits = Lelantus.INSTANCE.parseJoinSplits(rawTxs);
+		WritableArray result = Arguments.createArray();
+		for (ParsedJoinSplit joinSplit : joinSplits) {
+			WritableMap joinSplitMap = Arguments.createMap();
+			joinSplitMap.putBoolean("valid", joinSplit.getValid());
+			joinSplitMap.putDouble("fee", (double) joinSplit.getFee());
+			WritableArray serialNumbers = Arguments.createArray();
+			for (String serialNumber : joinSplit.getSerialNumbers()) {
+				serialNumbers.pushString(serialNumber);
+			}
+			joinSplitMap.putArray("serialNumbers", serialNumbers);
+			WritableArray spentCoinIndexes = Arguments.createArray();
+			for (int index : joinSplit.getSpentCoinIndexes()) {
+				spentCoinIndexes.pushInt(index);
+			}
+			joinSplitMap.putArray("spentCoinIndexes", spentCoinIndexes);
+			WritableArray publicCoins = Arguments.createArray();
+			for (String publicCoin : joinSplit.getPublicCoins()) {
+				publicCoins.pushString(publicCoin);
+			}
+			joinSplitMap.putArray("publicCoins", publicCoins);
+			WritableArray encryptedValues = Arguments.createArray();
+			for (String encryptedValue : joinSplit.getEncryptedValues()) {
+				encryptedValues.pushString(encryptedValue);
+			}
+			joinSplitMap.putArray("encryptedValues", encryptedValues);
+			result.pushMap(joinSplitMap);
+		}
+		callback.invoke(result);
+	}
+
+	@ReactMethod
+	public void planConsolidation(
+			ReadableArray amountsArray,
+			ReadableArray setIdsArray,
+			int minCoins,
+			int maxInputs,
 			Callback callback
 	) {
-		double amount = Lelantus.INSTANCE.decryptMintAmount(privateKeyAES, encryptedValue);
-		callback.invoke(amount);
+		int size = amountsArray.size();
+		long[] amounts = new long[size];
+		int[] setIds = new int[size];
+		for (int i = 0; i < size; i++) {
+			amounts[i] = (long) amountsArray.getDouble(i);
+			setIds[i] = setIdsArray.getInt(i);
+		}
+		ConsolidationStep[] steps = Lelantus.INSTANCE.planConsolidation(
+				amounts,
+				setIds,
+				minCoins,
+				maxInputs
+		);
+		WritableArray result = Arguments.createArray();
+		for (ConsolidationStep step : steps) {
+			WritableMap stepMap = Arguments.createMap();
+			WritableArray positions = Arguments.createArray();
+			for (int position : step.getPositions()) {
+				positions.pushInt(position);
+			}
+			stepMap.putArray("positions", positions);
+			stepMap.putInt("anonymitySetId", step.getAnonymitySetId());
+			stepMap.putDouble("fee", (double) step.getFee());
+			stepMap.putDouble("mintValue", (double) step.getMintValue());
+			WritableMap provingCost = Arguments.createMap();
+			provingCost.putDouble("deserializedPoints", (double) step.getDeserializedPoints());
+			provingCost.putDouble("provedPoints", (double) step.getProvedPoints());
+			provingCost.putDouble("setBytes", (double) step.getSetBytes());
+			stepMap.putMap("provingCost", provingCost);
+			result.pushMap(stepMap);
+		}
+		callback.invoke(result);
+	}
+
+	@ReactMethod
+	public void getConsolidationScript(
+			String privateKey,
+			int index,
+			ReadableArray coinsArray,
+			String txHash,
+			Promise promise
+	) {
+		try {
+			String script = Lelantus.INSTANCE.createConsolidationScript(
+					privateKey,
+					index,
+					toLelantusEntries(coinsArray),
+					txHash);
+			promise.resolve(script);
+		} catch (RuntimeException e) {
+			promise.reject(SPEND_ERROR, e.getMessage(), e);
+		}
+	}
+
+	private static LelantusEntry[] toLelantusEntries(ReadableArray coinsArray) {
+		LelantusEntry[] coins = new LelantusEntry[coinsArray.size()];
+		for (int i = 0; i < coinsArray.size(); i++) {
+			ReadableMap lelantusEntryMap = coinsArray.getMap(i);
+			LelantusEntry lelantusEntry = new LelantusEntry(
+					(long) lelantusEntryMap.getDouble("amount"),
+					lelantusEntryMap.getString("privateKey"),
+					lelantusEntryMap.getInt("index"),
+					lelantusEntryMap.getBoolean("isUsed"),
+					lelantusEntryMap.getInt("height"),
+					lelantusEntryMap.getInt("anonymitySetId")
+			);
+			coins[i] = lelantusEntry;
+		}
+		return coins;
+	}
+
+	private static LelantusCoin[] toLelantusCoins(ReadableArray coinsArray) {
+		LelantusCoin[] coins = new LelantusCoin[coinsArray.size()];
+		for (int i = 0; i < coinsArray.size(); i++) {
+			ReadableMap coinMap = coinsArray.getMap(i);
+			coins[i] = new LelantusCoin(
+					coinMap.getInt("index"),
+					(long) coinMap.getDouble("value"),
+					coinMap.getString("publicCoin"),
+					coinMap.getString("txId"),
+					coinMap.getInt("anonymitySetId"),
+					coinMap.getBoolean("isUsed")
+			);
+		}
+		return coins;
 	}
 }
@@ -0,0 +1,9 @@
+package org.firo.lelantus
+
+class MintBundle(
+    val script: String,
+    val publicCoin: String,
+    val tag: String,
+    val serialNumber: String,
+    val keyPath: Long
+)
@@ -0,0 +1,10 @@
+package org.firo.lelantus
+
+class ParsedJoinSplit(
+    val valid: Boolean,
+    val fee: Long,
+    val serialNumbers: Array<String>,
+    val spentCoinIndexes: IntArray,
+    val publicCoins: Array<String>,
+    val encryptedValues: Array<String>
+)
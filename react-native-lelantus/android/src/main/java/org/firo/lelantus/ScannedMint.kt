@@ -0,0 +1,11 @@
+package org.firo.lelantus
+
+class ScannedMint(
+    val index: Int,
+    val value: Long,
+    val publicCoin: String,
+    val txId: String,
+    val anonymitySetId: Int,
+    val isJMint: Boolean,
+    val isUsed: Boolean
+)
@@ -0,0 +1,136 @@
+#ifndef ORG_FIRO_LELANTUS_COININDEX_H
+#define ORG_FIRO_LELANTUS_COININDEX_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+ * Open addressed (linear probing) index of a key of the anonymity set coins, the mint
+ * tag or the public coin, to the set and position of every coin having it. The key,
+ * set id and position are stored inline in the slot, a key held by several sets takes
+ * one slot per set. Set ids start at 1, 0 marks an empty slot.
+ */
+template<size_t KeySize>
+class CoinIndex {
+public:
+	typedef std::array<unsigned char, KeySize> Key;
+
+	void Insert(const Key &key, int32_t setId, uint32_t position);
+
+	// Newest set holding the key and the position of the coin there, false if none does.
+	bool FindNewest(const Key &key, int32_t &setId, uint32_t &position) const;
+
+	// Drops the entries of the set, the table is built again from the others.
+	void RemoveSet(int32_t setId);
+
+	void Clear();
+
+	size_t GetMemoryBytes() const { return slots.size() * sizeof(Slot); }
+
+private:
+	struct Slot {
+		Key key;
+		int32_t setId;
+		uint32_t position;
+	};
+
+	static size_t Hash(const Key &key);
+
+	void Grow();
+
+	void Place(const Slot &entry);
+
+	std::vector<Slot> slots;
+	size_t size = 0;
+};
+
+static const size_t COIN_INDEX_MIN_CAPACITY = 1024;
+
+template<size_t KeySize>
+size_t CoinIndex<KeySize>::Hash(const Key &key) {
+	// tags are hashes and public coins start with their x coordinate, mix only to
+	// spread the low bits
+	uint64_t h;
+	memcpy(&h, key.data(), sizeof(h));
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return (size_t) h;
+}
+
+template<size_t KeySize>
+void CoinIndex<KeySize>::Insert(const Key &key, int32_t setId, uint32_t position) {
+	// keep the load factor under 3/4
+	if ((size + 1) * 4 > slots.size() * 3) {
+		Grow();
+	}
+	Place({key, setId, position});
+	size++;
+}
+
+template<size_t KeySize>
+bool CoinIndex<KeySize>::FindNewest(const Key &key, int32_t &setId, uint32_t &position) const {
+	if (size == 0) {
+		return false;
+	}
+	// entries of a key are all in the probe run starting at its hash
+	size_t mask = slots.size() - 1;
+	bool found = false;
+	for (size_t slot = Hash(key) & mask; slots[slot].setId != 0; slot = (slot + 1) & mask) {
+		const Slot &entry = slots[slot];
+		if ((!found || entry.setId > setId) && entry.key == key) {
+			setId = entry.setId;
+			position = entry.position;
+			found = true;
+		}
+	}
+	return found;
+}
+
+template<size_t KeySize>
+void CoinIndex<KeySize>::RemoveSet(int32_t setId) {
+	std::vector<Slot> oldSlots(slots.size(), Slot{});
+	oldSlots.swap(slots);
+	size = 0;
+	for (const Slot &entry : oldSlots) {
+		if (entry.setId != 0 && entry.setId != setId) {
+			Place(entry);
+			size++;
+		}
+	}
+}
+
+template<size_t KeySize>
+void CoinIndex<KeySize>::Clear() {
+	std::vector<Slot>().swap(slots);
+	size = 0;
+}
+
+template<size_t KeySize>
+void CoinIndex<KeySize>::Grow() {
+	std::vector<Slot> oldSlots;
+	oldSlots.swap(slots);
+
+	size_t capacity = oldSlots.empty() ? COIN_INDEX_MIN_CAPACITY : oldSlots.size() * 2;
+	slots.assign(capacity, Slot{});
+	for (const Slot &entry : oldSlots) {
+		if (entry.setId != 0) {
+			Place(entry);
+		}
+	}
+}
+
+template<size_t KeySize>
+void CoinIndex<KeySize>::Place(const Slot &entry) {
+	// capacity is always a power of two
+	size_t mask = slots.size() - 1;
+	size_t slot = Hash(entry.key) & mask;
+	while (slots[slot].setId != 0) {
+		slot = (slot + 1) & mask;
+	}
+	slots[slot] = entry;
+}
+
+#endif //ORG_FIRO_LELANTUS_COININDEX_H
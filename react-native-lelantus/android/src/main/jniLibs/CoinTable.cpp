@@ -0,0 +1,217 @@
+#include "CoinTable.h"
+
+#include <algorithm>
+#include <iterator>
+
+bool CoinTable::IsUnspent(const StoredCoin &coin) {
+	return !coin.isUsed && coin.setId != COIN_SET_NONE && coin.value > 0;
+}
+
+bool CoinTable::IsUnconfirmed(const StoredCoin &coin) {
+	return !coin.isUsed && coin.setId == COIN_SET_NONE;
+}
+
+void CoinTable::AddToIndexes(const StoredCoin &coin) {
+	if (IsUnspent(coin)) {
+		unspent.insert(coin.index);
+		unspentSets[coin.setId]++;
+	} else if (IsUnconfirmed(coin)) {
+		unconfirmed.insert(coin.index);
+	}
+	if (coin.hasSerial) {
+		serialIndex[coin.serial] = coin.index;
+	}
+}
+
+void CoinTable::RemoveFromIndexes(const StoredCoin &coin) {
+	if (unspent.erase(coin.index) > 0) {
+		auto it = unspentSets.find(coin.setId);
+		if (--it->second == 0) {
+			unspentSets.erase(it);
+		}
+	}
+	unconfirmed.erase(coin.index);
+	if (coin.hasSerial) {
+		serialIndex.erase(coin.serial);
+	}
+}
+
+void CoinTable::Store(const StoredCoin &coin) {
+	auto it = coins.find(coin.index);
+	if (it == coins.end()) {
+		AddToIndexes(coins.emplace(coin.index, coin).first->second);
+		return;
+	}
+	RemoveFromIndexes(it->second);
+	bool keepSerial = !coin.hasSerial && it->second.hasSerial && it->second.value == coin.value;
+	Serial serial = it->second.serial;
+	it->second = coin;
+	if (keepSerial) {
+		it->second.hasSerial = true;
+		it->second.serial = serial;
+	}
+	AddToIndexes(it->second);
+}
+
+size_t CoinTable::Load(const std::vector<StoredCoin> &newCoins) {
+	Clear();
+	size_t dropped = 0;
+	for (const StoredCoin &coin : newCoins) {
+		auto it = coins.find(coin.index);
+		if (it != coins.end()) {
+			dropped++;
+			if (it->second.setId >= coin.setId) {
+				continue;
+			}
+		}
+		Store(coin);
+	}
+	return dropped;
+}
+
+size_t CoinTable::Put(const std::vector<StoredCoin> &newCoins) {
+	size_t changed = 0;
+	for (const StoredCoin &coin : newCoins) {
+		auto it = coins.find(coin.index);
+		if (it != coins.end()
+			&& it->second.value == coin.value
+			&& it->second.publicCoin == coin.publicCoin
+			&& it->second.txId == coin.txId
+			&& it->second.setId == coin.setId
+			&& it->second.isUsed == coin.isUsed) {
+			continue;
+		}
+		Store(coin);
+		changed++;
+	}
+	return changed;
+}
+
+size_t CoinTable::MarkUsed(const std::vector<int32_t> &indexes) {
+	size_t marked = 0;
+	for (int32_t index : indexes) {
+		auto it = coins.find(index);
+		if (it == coins.end() || it->second.isUsed) {
+			continue;
+		}
+		RemoveFromIndexes(it->second);
+		it->second.isUsed = true;
+		AddToIndexes(it->second);
+		marked++;
+	}
+	return marked;
+}
+
+std::vector<int32_t> CoinTable::FindSerials(const std::vector<Serial> &serials) const {
+	std::vector<int32_t> indexes;
+	for (const Serial &serial : serials) {
+		auto it = serialIndex.find(serial);
+		if (it != serialIndex.end()) {
+			indexes.push_back(it->second);
+		}
+	}
+	return indexes;
+}
+
+size_t CoinTable::MarkUsedSerials(const std::vector<Serial> &serials) {
+	return MarkUsed(FindSerials(serials));
+}
+
+std::vector<std::pair<int32_t, uint64_t>> CoinTable::GetUnspentWithoutSerial() const {
+	std::vector<std::pair<int32_t, uint64_t>> result;
+	for (int32_t index : unspent) {
+		const StoredCoin &coin = coins.at(index);
+		if (!coin.hasSerial) {
+			result.emplace_back(index, coin.value);
+		}
+	}
+	return result;
+}
+
+void CoinTable::SetSerial(int32_t index, uint64_t value, const Serial &serial) {
+	auto it = coins.find(index);
+	if (it == coins.end() || it->second.value != value) {
+		return;
+	}
+	if (it->second.hasSerial) {
+		serialIndex.erase(it->second.serial);
+	}
+	it->second.hasSerial = true;
+	it->second.serial = serial;
+	serialIndex[serial] = index;
+}
+
+std::vector<std::pair<int32_t, Serial>> CoinTable::GetUnspentSerials() const {
+	std::vector<std::pair<int32_t, Serial>> result;
+	for (int32_t index : unspent) {
+		const StoredCoin &coin = coins.at(index);
+		if (coin.hasSerial) {
+			result.emplace_back(index, coin.serial);
+		}
+	}
+	return result;
+}
+
+std::vector<std::string> CoinTable::UpdateSetIds(const SetStore &store) {
+	std::vector<int32_t> indexes;
+	indexes.reserve(unspent.size() + unconfirmed.size());
+	std::merge(unspent.begin(), unspent.end(), unconfirmed.begin(), unconfirmed.end(),
+			   std::back_inserter(indexes));
+
+	std::vector<PublicCoinKey> publicCoins(indexes.size());
+	for (size_t i = 0; i < indexes.size(); i++) {
+		const std::string &publicCoin = coins.at(indexes[i]).publicCoin;
+		if (!DecodeHex(publicCoin.c_str(), publicCoins[i].data(), publicCoins[i].size())) {
+			// matches no stored coin
+			publicCoins[i].fill(0);
+		}
+	}
+	std::vector<int32_t> setIds = store.FindNewestSets(publicCoins);
+
+	std::vector<std::string> movedTxIds;
+	for (size_t i = 0; i < indexes.size(); i++) {
+		StoredCoin &coin = coins.at(indexes[i]);
+		if (coin.setId >= setIds[i]) {
+			continue;
+		}
+		RemoveFromIndexes(coin);
+		coin.setId = setIds[i];
+		AddToIndexes(coin);
+		movedTxIds.push_back(coin.txId);
+	}
+	return movedTxIds;
+}
+
+std::vector<StoredCoin> CoinTable::Get(CoinFilter filter) const {
+	std::vector<StoredCoin> result;
+	if (filter == COIN_FILTER_ALL) {
+		result.reserve(coins.size());
+		for (const auto &entry : coins) {
+			result.push_back(entry.second);
+		}
+		return result;
+	}
+	const std::set<int32_t> &indexes = filter == COIN_FILTER_UNSPENT ? unspent : unconfirmed;
+	result.reserve(indexes.size());
+	for (int32_t index : indexes) {
+		result.push_back(coins.at(index));
+	}
+	return result;
+}
+
+std::vector<int32_t> CoinTable::GetUnspentSetIds() const {
+	std::vector<int32_t> setIds;
+	setIds.reserve(unspentSets.size());
+	for (const auto &entry : unspentSets) {
+		setIds.push_back(entry.first);
+	}
+	return setIds;
+}
+
+void CoinTable::Clear() {
+	coins.clear();
+	unspent.clear();
+	unconfirmed.clear();
+	unspentSets.clear();
+	serialIndex.clear();
+}
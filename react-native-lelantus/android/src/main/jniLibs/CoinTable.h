@@ -0,0 +1,109 @@
+#ifndef ORG_FIRO_LELANTUS_COINTABLE_H
+#define ORG_FIRO_LELANTUS_COINTABLE_H
+
+#include "SerialSet.h"
+#include "SetStore.h"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Set id of coins that are in no anonymity set yet.
+static const int32_t COIN_SET_NONE = 0;
+
+enum CoinFilter {
+	COIN_FILTER_ALL = 0,
+	// not used, in a set and worth something
+	COIN_FILTER_UNSPENT = 1,
+	// not used and in no set yet
+	COIN_FILTER_UNCONFIRMED = 2,
+};
+
+/*
+ * Lelantus coin of the wallet. Public coin and tx id are the hex strings the JS side
+ * keeps, the serial is derived natively when it is needed and never leaves.
+ */
+struct StoredCoin {
+	int32_t index = 0;
+	uint64_t value = 0;
+	std::string publicCoin;
+	std::string txId;
+	int32_t setId = COIN_SET_NONE;
+	bool isUsed = false;
+
+	bool hasSerial = false;
+	Serial serial{};
+};
+
+/*
+ * Coins of the wallet keyed by mint index, with indexes by state, set and serial so
+ * the updates of a sync only touch the coins they change. Rows are in mint index
+ * order, which is the order of the JS coin list.
+ */
+class CoinTable {
+public:
+	/*
+	 * Replaces the coins. Of coins with the same mint index the one in the newest set
+	 * is kept, returns the number of coins dropped.
+	 */
+	size_t Load(const std::vector<StoredCoin> &coins);
+
+	// Adds the coins, replacing those with the same mint index. Returns the number changed.
+	size_t Put(const std::vector<StoredCoin> &coins);
+
+	// Returns the number of coins that were not used yet.
+	size_t MarkUsed(const std::vector<int32_t> &indexes);
+
+	// Mint indexes of the coins with one of the serials, used or not.
+	std::vector<int32_t> FindSerials(const std::vector<Serial> &serials) const;
+
+	// Marks the coins with one of the serials as used, returns their number.
+	size_t MarkUsedSerials(const std::vector<Serial> &serials);
+
+	// Index and value of the unspent coins whose serial is not derived yet.
+	std::vector<std::pair<int32_t, uint64_t>> GetUnspentWithoutSerial() const;
+
+	// Ignored when the coin changed value since it was returned by GetUnspentWithoutSerial.
+	void SetSerial(int32_t index, uint64_t value, const Serial &serial);
+
+	// Serials of the unspent coins, by mint index.
+	std::vector<std::pair<int32_t, Serial>> GetUnspentSerials() const;
+
+	/*
+	 * Moves coins that are not used to the newest set of the store holding them.
+	 * Returns the tx ids of the moved coins.
+	 */
+	std::vector<std::string> UpdateSetIds(const SetStore &store);
+
+	std::vector<StoredCoin> Get(CoinFilter filter) const;
+
+	// Sets holding unspent coins, ascending.
+	std::vector<int32_t> GetUnspentSetIds() const;
+
+	void Clear();
+
+private:
+	static bool IsUnspent(const StoredCoin &coin);
+
+	static bool IsUnconfirmed(const StoredCoin &coin);
+
+	void AddToIndexes(const StoredCoin &coin);
+
+	void RemoveFromIndexes(const StoredCoin &coin);
+
+	// Replaces the row of the coin's index, keeping a known serial of the same value.
+	void Store(const StoredCoin &coin);
+
+	std::map<int32_t, StoredCoin> coins;
+	std::set<int32_t> unspent;
+	std::set<int32_t> unconfirmed;
+	// setId -> number of unspent coins in it
+	std::map<int32_t, size_t> unspentSets;
+	// serials are uniformly distributed like tags
+	std::unordered_map<Serial, int32_t, MintTagHash> serialIndex;
+};
+
+#endif //ORG_FIRO_LELANTUS_COINTABLE_H
@@ -0,0 +1,150 @@
+#include "JoinSplitParser.h"
+
+#include <cstring>
+
+// Bounds checked reader over the bytes of one transaction.
+class ByteReader {
+public:
+	ByteReader(const unsigned char *data, size_t size) : data(data), size(size) {}
+
+	bool AtEnd() const { return position == size; }
+
+	bool Skip(size_t count) {
+		if (size - position < count) {
+			return false;
+		}
+		position += count;
+		return true;
+	}
+
+	bool ReadUInt32(uint32_t &value) {
+		if (size - position < 4) {
+			return false;
+		}
+		value = (uint32_t) data[position]
+				| (uint32_t) data[position + 1] << 8
+				| (uint32_t) data[position + 2] << 16
+				| (uint32_t) data[position + 3] << 24;
+		position += 4;
+		return true;
+	}
+
+	bool ReadCompactSize(uint64_t &value) {
+		if (size - position < 1) {
+			return false;
+		}
+		unsigned char first = data[position++];
+		size_t width = first == 0xfd ? 2 : first == 0xfe ? 4 : first == 0xff ? 8 : 0;
+		if (width == 0) {
+			value = first;
+			return true;
+		}
+		if (size - position < width) {
+			return false;
+		}
+		value = 0;
+		for (size_t i = 0; i < width; i++) {
+			value |= (uint64_t) data[position + i] << (8 * i);
+		}
+		position += width;
+		return true;
+	}
+
+	bool ReadBytes(std::vector<unsigned char> &out) {
+		uint64_t count;
+		if (!ReadCompactSize(count) || size - position < count) {
+			return false;
+		}
+		out.assign(data + position, data + position + count);
+		position += count;
+		return true;
+	}
+
+	// Counts larger than the remaining bytes can't be real, checked before reserving.
+	bool ReadCount(uint64_t &count) {
+		return ReadCompactSize(count) && count <= size - position;
+	}
+
+private:
+	const unsigned char *data;
+	size_t size;
+	size_t position = 0;
+};
+
+bool ParseRawTransaction(const unsigned char *data, size_t size, RawTransaction &tx) {
+	ByteReader reader(data, size);
+	uint32_t version;
+	if (!reader.ReadUInt32(version)) {
+		return false;
+	}
+	tx.version = (int16_t) (version & 0xffff);
+	tx.type = (uint16_t) (version >> 16);
+
+	uint64_t inputCount;
+	if (!reader.ReadCount(inputCount)) {
+		return false;
+	}
+	tx.inputScripts.resize(inputCount);
+	for (std::vector<unsigned char> &script : tx.inputScripts) {
+		// prevout hash and index, then the script and the sequence
+		if (!reader.Skip(36) || !reader.ReadBytes(script) || !reader.Skip(4)) {
+			return false;
+		}
+	}
+
+	uint64_t outputCount;
+	if (!reader.ReadCount(outputCount)) {
+		return false;
+	}
+	tx.outputScripts.resize(outputCount);
+	for (std::vector<unsigned char> &script : tx.outputScripts) {
+		if (!reader.Skip(8) || !reader.ReadBytes(script)) {
+			return false;
+		}
+	}
+
+	// lock time
+	if (!reader.Skip(4)) {
+		return false;
+	}
+	tx.extraPayload.clear();
+	if (tx.version >= 3 && tx.type != 0 && !reader.ReadBytes(tx.extraPayload)) {
+		return false;
+	}
+	return reader.AtEnd();
+}
+
+bool GetJoinSplitData(const RawTransaction &tx, std::vector<unsigned char> &joinSplit) {
+	if (tx.inputScripts.size() != 1 || tx.inputScripts[0].empty()) {
+		return false;
+	}
+	const std::vector<unsigned char> &script = tx.inputScripts[0];
+	if (tx.version >= 3 && tx.type == TRANSACTION_LELANTUS) {
+		if (script[0] != OP_LELANTUSJOINSPLITPAYLOAD || tx.extraPayload.empty()) {
+			return false;
+		}
+		joinSplit = tx.extraPayload;
+		return true;
+	}
+	if (script[0] != OP_LELANTUSJOINSPLIT || script.size() == 1) {
+		return false;
+	}
+	joinSplit.assign(script.begin() + 1, script.end());
+	return true;
+}
+
+bool ParseJMintScript(
+		const std::vector<unsigned char> &script,
+		PublicCoinKey &publicCoin,
+		std::vector<unsigned char> &encryptedValue
+) {
+	// the encrypted value has to fit the value of a stored set coin
+	if (script.size() <= 1 + publicCoin.size()
+		|| script.size() > 1 + publicCoin.size() + sizeof(SetCoin::value)
+		|| script[0] != OP_LELANTUSJMINT) {
+		return false;
+	}
+	memcpy(publicCoin.data(), script.data() + 1, publicCoin.size());
+	encryptedValue.assign(script.begin() + 1 + publicCoin.size(), script.end());
+	return true;
+}
@@ -0,0 +1,45 @@
+#ifndef ORG_FIRO_LELANTUS_JOINSPLITPARSER_H
+#define ORG_FIRO_LELANTUS_JOINSPLITPARSER_H
+
+#include "SetStore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static const unsigned char OP_LELANTUSJMINT = 0xc7;
+static const unsigned char OP_LELANTUSJOINSPLIT = 0xc8;
+static const unsigned char OP_LELANTUSJOINSPLITPAYLOAD = 0xc9;
+
+static const uint16_t TRANSACTION_LELANTUS = 8;
+
+/*
+ * The parts of a raw firo transaction a spend is read from. Amounts, sequences and
+ * the lock time are skipped.
+ */
+struct RawTransaction {
+	int16_t version = 0;
+	uint16_t type = 0;
+	std::vector<std::vector<unsigned char>> inputScripts;
+	std::vector<std::vector<unsigned char>> outputScripts;
+	std::vector<unsigned char> extraPayload;
+};
+
+// False if the bytes are not exactly one transaction.
+bool ParseRawTransaction(const unsigned char *data, size_t size, RawTransaction &tx);
+
+/*
+ * The serialized JoinSplit of a lelantus spend, which is the extra payload of special
+ * transactions and follows the opcode of the first input script of older ones. False
+ * for other transactions.
+ */
+bool GetJoinSplitData(const RawTransaction &tx, std::vector<unsigned char> &joinSplit);
+
+// Splits a jmint output script into the public coin and the encrypted value.
+bool ParseJMintScript(
+		const std::vector<unsigned char> &script,
+		PublicCoinKey &publicCoin,
+		std::vector<unsigned char> &encryptedValue
+);
+
+#endif //ORG_FIRO_LELANTUS_JOINSPLITPARSER_H
@@ -1,5 +1,23 @@
 #include "LelantusWrapper.h"
+#include "AnonymitySetResponse.h"
 #include "Utils.h"
+#include "Bip32.h"
+#include "CoinSelection.h"
+#include "JoinSplitParser.h"
+#include "PointCache.h"
+#include "SerialSet.h"
+#include "ThreadPool.h"
+#include "openssl/crypto.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <stdexcept>
 
 const char *CreateMintScript(
 		uint64_t value,
@@ -53,6 +71,62 @@ const char *GetSerialNumber(
 	return bin2hex(buffer, 32);
 }
 
+/*
+ * Script, public coin, tag, serial and key path of a mint from one derivation of its
+ * private coin. liblelantus builds the script from the key data only, which costs
+ * one more derivation inside CreateMintScript.
+ */
+static MintBundle CreateMintBundle(
+		uint64_t value,
+		unsigned char *key,
+		int32_t index,
+		const uint160 &seedID
+) {
+	MintBundle bundle;
+	uint32_t keyPathOut;
+	lelantus::PrivateCoin privateCoin = CreateMintPrivateCoin(value, key, index, keyPathOut);
+	bundle.keyPath = keyPathOut;
+
+	std::vector<unsigned char> publicCoin = privateCoin.getPublicCoin().getValue().getvch();
+	bundle.publicCoin = EncodeHex(publicCoin.data(), publicCoin.size());
+	unsigned char serialNumber[32];
+	privateCoin.getSerialNumber().serialize(serialNumber);
+	bundle.serialNumber = EncodeHex(serialNumber, sizeof(serialNumber));
+	bundle.tag = CreateMintTag(key, index, seedID).GetHex();
+
+	std::vector<unsigned char> script;
+	CreateMintScript(value, key, index, seedID, script);
+	bundle.script = EncodeHex(script.data(), script.size());
+	return bundle;
+}
+
+static SetStore setStore;
+static std::mutex setStoreMutex;
+
+// Selection of spends, the estimates use it too so fee and change match the spend.
+static const CoinSelectionStrategy SPEND_COIN_SELECTION = COIN_SELECTION_SET_AWARE;
+
+static std::map<int32_t, size_t> GetStoredSetSizes() {
+	std::lock_guard<std::mutex> lock(setStoreMutex);
+	return setStore.GetSetSizes();
+}
+
+// Unused coins in the form the coin selection takes, with their positions in the list.
+static std::vector<SelectionCoin> ToSelectionCoins(
+		const std::list<LelantusEntry> &coins,
+		std::vector<const LelantusEntry *> &entries
+) {
+	std::vector<SelectionCoin> selectionCoins;
+	for (const LelantusEntry &entry : coins) {
+		if (entry.isUsed) {
+			continue;
+		}
+		selectionCoins.push_back({(uint64_t) entry.amount, entry.anonymitySetId, entry.height});
+		entries.push_back(&entry);
+	}
+	return selectionCoins;
+}
+
 uint64_t EstimateFee(
 		uint64_t spendAmount,
 		bool subtractFeeFromAmount,
@@ -60,56 +134,22 @@ uint64_t EstimateFee(
 		uint64_t &changeToMint,
 		std::vector<int32_t> &spendCoinIndexes
 ) {
-	std::list<lelantus::CLelantusEntry> coinsl;
-	std::list<LelantusEntry>::iterator it;
-	for (it = coins.begin(); it != coins.end(); ++it) {
-		uint32_t keyPathOut;
-		lelantus::PrivateCoin coin = CreateMintPrivateCoin(
-				it->amount,
-				hex2bin(it->keydata),
-				it->index,
-				keyPathOut
-		);
-		lelantus::CLelantusEntry lelantusEntry;
-		lelantusEntry.value = coin.getPublicCoin().getValue();
-		lelantusEntry.randomness = coin.getRandomness();
-		lelantusEntry.serialNumber = coin.getSerialNumber();
-		lelantusEntry.ecdsaSecretKey =
-				std::vector<unsigned char>(
-						coin.getEcdsaSeckey(),
-						coin.getEcdsaSeckey() + 32
-				);
-		lelantusEntry.IsUsed = it->isUsed;
-		lelantusEntry.nHeight = it->height;
-		lelantusEntry.id = it->anonymitySetId;
-		lelantusEntry.amount = it->amount;
-		coinsl.push_back(lelantusEntry);
-	}
+	// selection needs amounts only, no private coins are built for the estimate
+	std::vector<const LelantusEntry *> entries;
+	std::vector<SelectionCoin> selectionCoins = ToSelectionCoins(coins, entries);
 
-	std::vector<lelantus::CLelantusEntry> coinsToBeSpent;
-	uint64_t fee = EstimateJoinSplitFee(
-			spendAmount,
-			subtractFeeFromAmount,
-			coinsl,
-			coinsToBeSpent,
-			changeToMint);
-
-	for (const auto& entry : coinsToBeSpent) {
-		for (it = coins.begin(); it != coins.end(); ++it) {
-			uint32_t keyPathOut;
-			lelantus::PrivateCoin coin = CreateMintPrivateCoin(
-					it->amount,
-					hex2bin(it->keydata),
-					it->index,
-					keyPathOut
-			);
-			if (coin.getSerialNumber() == entry.serialNumber) {
-				spendCoinIndexes.push_back(it->index);
-			}
-		}
+	CoinSelection selection;
+	if (!SelectCoins(selectionCoins, spendAmount, subtractFeeFromAmount, SPEND_COIN_SELECTION,
+					 GetStoredSetSizes(), selection)) {
+		changeToMint = 0;
+		return 0;
 	}
 
-	return fee;
+	for (size_t position : selection.selected) {
+		spendCoinIndexes.push_back(entries[position]->index);
+	}
+	changeToMint = selection.changeToMint;
+	return selection.fee;
 }
 
 uint32_t GetMintKeyPath(
@@ -153,25 +193,273 @@ const char *CreateJMintScript(
 	return bin2hex(script, script.size());
 }
 
-const char *CreateJoinSplitScript(
+static std::vector<PublicCoinKey> GetPublicCoins(const StoredAnonymitySet &set) {
+	std::vector<PublicCoinKey> publicCoins(set.coins.size());
+	for (size_t i = 0; i < set.coins.size(); i++) {
+		memcpy(publicCoins[i].data(), set.coins[i].publicCoin, publicCoins[i].size());
+	}
+	return publicCoins;
+}
+
+// Coins checked for cancellation at once while building a set in the background.
+static const size_t PREWARM_COINS_PER_CHECK = 256;
+
+// Group element of the i-th stored coin, from the cached points when they cover it.
+static secp_primitives::GroupElement ReadSetPoint(
+		const std::vector<PublicCoinKey> &publicCoins,
+		const std::vector<AffinePoint> &points,
+		size_t i
+) {
+	if (i < points.size()) {
+		return secp_primitives::GroupElement(
+				EncodeHex(points[i].x, sizeof(points[i].x)).c_str(),
+				EncodeHex(points[i].y, sizeof(points[i].y)).c_str(),
+				16
+		);
+	}
+	unsigned char serializedCoin[sizeof(SetCoin::publicCoin)];
+	memcpy(serializedCoin, publicCoins[i].data(), sizeof(serializedCoin));
+	secp_primitives::GroupElement groupElement;
+	groupElement.deserialize(serializedCoin);
+	return groupElement;
+}
+
+/*
+ * Group elements of the coins in the order spends take them, the reverse of the store.
+ * Cached points cover the first points.size() coins, the rest is decompressed. False
+ * if cancelled is set meanwhile.
+ */
+static bool BuildSpendSet(
+		const std::vector<PublicCoinKey> &publicCoins,
+		const std::vector<AffinePoint> &points,
+		const std::atomic<bool> *cancelled,
+		std::vector<lelantus::PublicCoin> &spendCoins
+) {
+	spendCoins.clear();
+	spendCoins.reserve(publicCoins.size());
+	for (size_t i = publicCoins.size(); i-- > 0;) {
+		if (cancelled != nullptr && i % PREWARM_COINS_PER_CHECK == 0 && *cancelled) {
+			spendCoins.clear();
+			return false;
+		}
+		spendCoins.emplace_back(ReadSetPoint(publicCoins, points, i));
+	}
+	return true;
+}
+
+/*
+ * Decodes the coins of a set for a spend being proved, split across the pool. Only the
+ * points the point cache misses are decompressed here, and only for sets the pre-warm
+ * job hasn't finished, which stays on its own low priority thread. The proof itself
+ * is not parallelized.
+ */
+static void DecodeSpendSetInParallel(
+		const std::vector<PublicCoinKey> &publicCoins,
+		const std::vector<AffinePoint> &points,
+		std::vector<lelantus::PublicCoin> &spendCoins
+) {
+	size_t count = publicCoins.size();
+	spendCoins.assign(count, lelantus::PublicCoin());
+	GetThreadPool().ParallelFor(0, count, [&](size_t i) {
+		spendCoins[count - 1 - i] = lelantus::PublicCoin(ReadSetPoint(publicCoins, points, i));
+	});
+}
+
+// Reads the point cache of a set, no points when there is none or it doesn't match.
+static std::vector<AffinePoint> ReadSetPoints(
+		const std::string &path,
+		int32_t setId,
+		const std::vector<PublicCoinKey> &publicCoins
+) {
+	std::vector<AffinePoint> points;
+	if (!path.empty()) {
+		ReadPointCache(path, setId, publicCoins, points);
+	}
+	return points;
+}
+
+// Set built by the pre-warm job, valid while the stored set has the same hash and size.
+struct PrewarmedSet {
+	std::string setHash;
+	size_t count;
+	std::vector<lelantus::PublicCoin> spendCoins;
+};
+
+static std::map<int32_t, PrewarmedSet> prewarmedSets;
+static std::mutex prewarmedSetsMutex;
+
+static void PrewarmSpendSets(std::vector<int32_t> setIds, const std::atomic<bool> &cancelled) {
+	LowerThreadPriority();
+	for (int32_t setId : setIds) {
+		PrewarmedSet prewarmed;
+		std::vector<PublicCoinKey> publicCoins;
+		std::string pointCachePath;
+		{
+			std::lock_guard<std::mutex> lock(setStoreMutex);
+			const StoredAnonymitySet *set = setStore.GetSet(setId);
+			if (set == nullptr) {
+				continue;
+			}
+			prewarmed.setHash = set->setHash;
+			prewarmed.count = set->coins.size();
+			publicCoins = GetPublicCoins(*set);
+			pointCachePath = setStore.GetPointCachePath(setId);
+		}
+		{
+			std::lock_guard<std::mutex> lock(prewarmedSetsMutex);
+			auto it = prewarmedSets.find(setId);
+			if (it != prewarmedSets.end() && it->second.setHash == prewarmed.setHash
+				&& it->second.count == prewarmed.count) {
+				continue;
+			}
+		}
+
+		std::vector<AffinePoint> points = ReadSetPoints(pointCachePath, setId, publicCoins);
+		if (!BuildSpendSet(publicCoins, points, &cancelled, prewarmed.spendCoins)) {
+			return;
+		}
+		std::lock_guard<std::mutex> lock(prewarmedSetsMutex);
+		prewarmedSets[setId] = std::move(prewarmed);
+	}
+}
+
+/*
+ * Thread of the pre-warm job. Starting a job or cancelling stops the running one,
+ * the sets it finished stay.
+ */
+class PrewarmJob {
+public:
+	~PrewarmJob() { Cancel(); }
+
+	void Start(const std::vector<int32_t> &setIds) {
+		std::lock_guard<std::mutex> lock(mutex);
+		Stop();
+		cancelled = false;
+		thread = std::thread(PrewarmSpendSets, setIds, std::cref(cancelled));
+	}
+
+	void Cancel() {
+		std::lock_guard<std::mutex> lock(mutex);
+		Stop();
+	}
+
+private:
+	void Stop() {
+		if (thread.joinable()) {
+			cancelled = true;
+			thread.join();
+		}
+	}
+
+	std::thread thread;
+	std::mutex mutex;
+	std::atomic<bool> cancelled{false};
+};
+
+static PrewarmJob prewarmJob;
+
+// Moves the pre-warmed coins of the set out, false if there are none for its current state.
+static bool TakePrewarmedSet(
+		int32_t setId,
+		const StoredAnonymitySet &set,
+		std::vector<lelantus::PublicCoin> &spendCoins
+) {
+	std::lock_guard<std::mutex> lock(prewarmedSetsMutex);
+	auto it = prewarmedSets.find(setId);
+	if (it == prewarmedSets.end()) {
+		return false;
+	}
+	bool current = it->second.setHash == set.setHash && it->second.count == set.coins.size();
+	if (current) {
+		spendCoins = std::move(it->second.spendCoins);
+	}
+	prewarmedSets.erase(it);
+	return current;
+}
+
+void StartSpendPrewarm(const std::vector<int32_t> &setIds) {
+	{
+		// sets no longer asked for are dropped
+		std::lock_guard<std::mutex> lock(prewarmedSetsMutex);
+		for (auto it = prewarmedSets.begin(); it != prewarmedSets.end();) {
+			if (std::find(setIds.begin(), setIds.end(), it->first) == setIds.end()) {
+				it = prewarmedSets.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+	prewarmJob.Start(setIds);
+}
+
+/*
+ * Proves a spend of the selected coins, spendAmount going to the transparent outputs
+ * and the change of the selection to one jmint.
+ */
+static const char *ProveJoinSplit(
 		const char *txHash,
 		uint64_t spendAmount,
-		bool subtractFeeFromAmount,
+		const CoinSelection &selection,
+		const std::vector<SelectionCoin> &selectionCoins,
+		const std::vector<const LelantusEntry *> &entries,
 		const char *keydata,
-		uint32_t index,
-		std::list<LelantusEntry> coins,
-		std::vector<uint32_t> setIds,
-		std::vector<std::vector<const char *>> anonymitySets,
-		const std::vector<const char *> &anonymitySetHashes,
-		std::vector<const char *> groupBlockHashes) {
-	std::list<lelantus::CLelantusEntry> coinsl;
-	std::list<LelantusEntry>::iterator it;
-	for (it = coins.begin(); it != coins.end(); ++it) {
+		uint32_t index) {
+	// the proof needs every core
+	prewarmJob.Cancel();
+
+	// sets come from the native store, only the ones holding the selected coins are loaded
+	std::map<uint32_t, std::vector<lelantus::PublicCoin>> anonymity_sets;
+	std::vector<std::vector<unsigned char>> _anonymitySetHashes;
+	std::map<uint32_t, uint256> group_block_hashes;
+
+	{
+		std::lock_guard<std::mutex> lock(setStoreMutex);
+		// selected coins are ordered by set id, so are the set hashes
+		for (size_t position : selection.selected) {
+			int32_t setId = selectionCoins[position].anonymitySetId;
+			if (anonymity_sets.count(setId) != 0) {
+				continue;
+			}
+			const StoredAnonymitySet *set = setStore.GetSet(setId);
+			if (set == nullptr) {
+				throw std::runtime_error("Anonymity set " + std::to_string(setId) + " is not loaded");
+			}
+			// a set changed since it was fetched would only fail after the whole proof
+			if (!setStore.Verify(setId)) {
+				setStore.Remove(setId);
+				throw std::runtime_error("Anonymity set " + std::to_string(setId) + " is corrupt");
+			}
+
+			// the store keeps coins in reverse order of the set
+			std::vector<lelantus::PublicCoin> &publicCoins = anonymity_sets[setId];
+			if (!TakePrewarmedSet(setId, *set, publicCoins)) {
+				std::vector<PublicCoinKey> setPublicCoins = GetPublicCoins(*set);
+				DecodeSpendSetInParallel(
+						setPublicCoins,
+						ReadSetPoints(setStore.GetPointCachePath(setId), setId, setPublicCoins),
+						publicCoins);
+			}
+
+			unsigned char *setHash = hex2bin(set->setHash.c_str());
+			_anonymitySetHashes.emplace_back(setHash, setHash + 32);
+
+			uint256 blockHash;
+			blockHash.SetHex(set->blockHash);
+			group_block_hashes.insert({setId, blockHash});
+		}
+	}
+	uint64_t fee = selection.fee;
+	uint64_t changeToMint = selection.changeToMint;
+
+	// private coins are derived for the selected coins only
+	std::vector<lelantus::CLelantusEntry> coinsToBeSpent;
+	for (size_t position : selection.selected) {
+		const LelantusEntry *entry = entries[position];
 		uint32_t keyPathOut;
 		lelantus::PrivateCoin coin = CreateMintPrivateCoin(
-				it->amount,
-				hex2bin(it->keydata),
-				it->index,
+				entry->amount,
+				hex2bin(entry->keydata),
+				entry->index,
 				keyPathOut
 		);
 		lelantus::CLelantusEntry lelantusEntry;
@@ -183,62 +471,273 @@ const char *CreateJoinSplitScript(
 						coin.getEcdsaSeckey(),
 						coin.getEcdsaSeckey() + 32
 				);
-		lelantusEntry.IsUsed = it->isUsed;
-		lelantusEntry.nHeight = it->height;
-		lelantusEntry.id = it->anonymitySetId;
-		lelantusEntry.amount = it->amount;
-		coinsl.push_back(lelantusEntry);
+		lelantusEntry.IsUsed = entry->isUsed;
+		lelantusEntry.nHeight = entry->height;
+		lelantusEntry.id = entry->anonymitySetId;
+		lelantusEntry.amount = entry->amount;
+		coinsToBeSpent.push_back(lelantusEntry);
 	}
 
-	std::vector<lelantus::CLelantusEntry> coinsToBeSpent;
-	uint64_t changeToMint;
-	uint64_t fee = EstimateJoinSplitFee(
-			spendAmount,
-			subtractFeeFromAmount,
-			coinsl,
-			coinsToBeSpent,
-			changeToMint);
+	uint32_t keyPathOut;
+	lelantus::PrivateCoin privateCoin = CreateMintPrivateCoin(changeToMint, hex2bin(keydata), index,
+															  keyPathOut);
+
+	uint256 _txHash;
+	_txHash.SetHex(txHash);
+
+	std::vector<unsigned char> script = std::vector<unsigned char>();
+	CreateJoinSplit(_txHash, privateCoin, spendAmount, fee, coinsToBeSpent, anonymity_sets,
+					_anonymitySetHashes, group_block_hashes, script);
+	return bin2hex(script, script.size());
+}
+
+// Selects every coin, ordered by set id, and returns their sum.
+static uint64_t SelectEveryCoin(
+		const std::vector<SelectionCoin> &selectionCoins,
+		CoinSelection &selection
+) {
+	uint64_t sum = 0;
+	selection.selected.clear();
+	for (size_t i = 0; i < selectionCoins.size(); i++) {
+		selection.selected.push_back(i);
+		sum += selectionCoins[i].amount;
+	}
+	std::stable_sort(selection.selected.begin(), selection.selected.end(),
+					 [&selectionCoins](size_t a, size_t b) {
+						 return selectionCoins[a].anonymitySetId < selectionCoins[b].anonymitySetId;
+					 });
+	return sum;
+}
 
+/*
+ * Proves a spend of every coin passed, paying fee. The coins are those the fee was
+ * estimated for, selecting again here could pick others once a set has grown.
+ */
+static const char *BuildJoinSplitScript(
+		const char *txHash,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		uint64_t fee,
+		const char *keydata,
+		uint32_t index,
+		std::list<LelantusEntry> coins) {
+	std::vector<const LelantusEntry *> entries;
+	std::vector<SelectionCoin> selectionCoins = ToSelectionCoins(coins, entries);
+
+	CoinSelection selection;
+	uint64_t sum = SelectEveryCoin(selectionCoins, selection);
+	uint64_t required = subtractFeeFromAmount ? spendAmount : spendAmount + fee;
+	if (selection.selected.empty() || sum < required
+		|| (subtractFeeFromAmount && spendAmount <= fee)) {
+		throw std::runtime_error("Insufficient funds");
+	}
+	selection.fee = fee;
+	selection.changeToMint = sum - required;
 	if (subtractFeeFromAmount) {
 		spendAmount -= fee;
 	}
+	return ProveJoinSplit(txHash, spendAmount, selection, selectionCoins, entries, keydata, index);
+}
 
-	uint32_t keyPathOut;
-	lelantus::PrivateCoin privateCoin = CreateMintPrivateCoin(changeToMint, hex2bin(keydata), index,
-															  keyPathOut);
+// Spend proved while the user reviews it, see StartSpeculativeSpend.
+struct SpeculativeSpend {
+	std::array<unsigned char, SHA256_DIGEST_LENGTH> key;
+	std::mutex mutex;
+	std::condition_variable finishedCondition;
+	bool finished = false;
+	bool discarded = false;
+	std::string script;
+	std::string error;
+};
 
-	std::map<uint32_t, std::vector<lelantus::PublicCoin>> anonymity_sets;
-	std::vector<std::vector<unsigned char>> _anonymitySetHashes;
-	std::map<uint32_t, uint256> group_block_hashes;
+static std::shared_ptr<SpeculativeSpend> speculativeSpend;
+static std::mutex speculativeSpendMutex;
 
-	for (int i = 0; i < setIds.size(); i++) {
-		uint32_t setId = setIds[i];
+static void CleanseString(std::string &str) {
+	OPENSSL_cleanse(&str[0], str.size());
+	str.clear();
+}
 
-		anonymity_sets.insert({setId, std::vector<lelantus::PublicCoin>()});
-		std::vector<const char *> serializedCoins = anonymitySets[i];
-		for (auto &serializedCoin : serializedCoins) {
-			secp_primitives::GroupElement groupElement;
-			groupElement.deserialize(hex2bin(serializedCoin));
-			lelantus::PublicCoin publicCoin(groupElement);
-			anonymity_sets.at(setId).push_back(publicCoin);
+// Digest of every argument of a spend, equal keys prove the same spend.
+static std::array<unsigned char, SHA256_DIGEST_LENGTH> GetSpendKey(
+		const char *txHash,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		uint64_t fee,
+		const char *keydata,
+		uint32_t index,
+		const std::list<LelantusEntry> &coins
+) {
+	unsigned char subtract = subtractFeeFromAmount;
+	SHA256_CTX context;
+	SHA256_Init(&context);
+	SHA256_Update(&context, txHash, strlen(txHash) + 1);
+	SHA256_Update(&context, &spendAmount, sizeof(spendAmount));
+	SHA256_Update(&context, &subtract, sizeof(subtract));
+	SHA256_Update(&context, &fee, sizeof(fee));
+	SHA256_Update(&context, keydata, strlen(keydata) + 1);
+	SHA256_Update(&context, &index, sizeof(index));
+	for (const LelantusEntry &coin : coins) {
+		unsigned char isUsed = coin.isUsed;
+		SHA256_Update(&context, &isUsed, sizeof(isUsed));
+		SHA256_Update(&context, &coin.height, sizeof(coin.height));
+		SHA256_Update(&context, &coin.anonymitySetId, sizeof(coin.anonymitySetId));
+		SHA256_Update(&context, &coin.amount, sizeof(coin.amount));
+		SHA256_Update(&context, &coin.index, sizeof(coin.index));
+		SHA256_Update(&context, coin.keydata, strlen(coin.keydata) + 1);
+	}
+	std::array<unsigned char, SHA256_DIGEST_LENGTH> key;
+	SHA256_Final(key.data(), &context);
+	return key;
+}
+
+/*
+ * The proof can't be stopped, the job is only marked so that its script is wiped as
+ * soon as it is done. Caller holds speculativeSpendMutex.
+ */
+static void DiscardSpeculativeSpendLocked() {
+	if (!speculativeSpend) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(speculativeSpend->mutex);
+		speculativeSpend->discarded = true;
+		CleanseString(speculativeSpend->script);
+	}
+	speculativeSpend.reset();
+}
+
+void StartSpeculativeSpend(
+		const char *txHash,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		uint64_t fee,
+		const char *keydata,
+		uint32_t index,
+		const std::list<LelantusEntry> &coins
+) {
+	auto spend = std::make_shared<SpeculativeSpend>();
+	spend->key = GetSpendKey(txHash, spendAmount, subtractFeeFromAmount, fee, keydata, index,
+							 coins);
+	{
+		std::lock_guard<std::mutex> lock(speculativeSpendMutex);
+		DiscardSpeculativeSpendLocked();
+		speculativeSpend = spend;
+	}
+
+	// the strings of the caller don't outlive the call
+	std::string ownTxHash(txHash);
+	std::string ownKeydata(keydata);
+	std::vector<std::string> coinKeydata;
+	for (const LelantusEntry &coin : coins) {
+		coinKeydata.emplace_back(coin.keydata);
+	}
+	auto prove = [=]() mutable {
+		// nothing may escape a detached thread, every failure ends up in spend->error
+		std::string script;
+		std::string error;
+		try {
+			std::list<LelantusEntry> ownCoins = coins;
+			auto coinKeydataIt = coinKeydata.begin();
+			for (LelantusEntry &coin : ownCoins) {
+				coin.keydata = (coinKeydataIt++)->c_str();
+			}
+			const char *result = BuildJoinSplitScript(ownTxHash.c_str(), spendAmount,
+													  subtractFeeFromAmount, fee,
+													  ownKeydata.c_str(), index, ownCoins);
+			script = result;
+			delete[] result;
+		} catch (const std::exception &e) {
+			error = e.what();
+		} catch (...) {
+			error = "Unknown error while proving the spend";
+		}
+		CleanseString(ownKeydata);
+		for (std::string &coinKey : coinKeydata) {
+			CleanseString(coinKey);
 		}
 
-		unsigned char *setHash = hex2bin(anonymitySetHashes[i]);
-		vector<unsigned char> anonymitySetHash(setHash, setHash + 32);
-		_anonymitySetHashes.push_back(anonymitySetHash);
+		std::lock_guard<std::mutex> lock(spend->mutex);
+		if (spend->discarded) {
+			CleanseString(script);
+		} else {
+			spend->script = std::move(script);
+			spend->error = std::move(error);
+		}
+		spend->finished = true;
+		spend->finishedCondition.notify_all();
+	};
 
-		uint256 blockHash;
-		blockHash.SetHex(groupBlockHashes[i]);
-		group_block_hashes.insert({setId, blockHash});
+	try {
+		std::thread(std::move(prove)).detach();
+	} catch (const std::exception &e) {
+		// the spend would never finish and CreateJoinSplitScript would wait for it
+		std::lock_guard<std::mutex> lock(spend->mutex);
+		spend->error = e.what();
+		spend->finished = true;
 	}
+}
 
-	uint256 _txHash;
-	_txHash.SetHex(txHash);
+void DiscardSpeculativeSpend() {
+	std::lock_guard<std::mutex> lock(speculativeSpendMutex);
+	DiscardSpeculativeSpendLocked();
+}
 
-	std::vector<unsigned char> script = std::vector<unsigned char>();
-	CreateJoinSplit(_txHash, privateCoin, spendAmount, fee, coinsToBeSpent, anonymity_sets,
-					_anonymitySetHashes, group_block_hashes, script);
-	return bin2hex(script, script.size());
+const char *CreateJoinSplitScript(
+		const char *txHash,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		uint64_t fee,
+		const char *keydata,
+		uint32_t index,
+		std::list<LelantusEntry> coins) {
+	std::shared_ptr<SpeculativeSpend> spend;
+	{
+		std::lock_guard<std::mutex> lock(speculativeSpendMutex);
+		if (speculativeSpend && speculativeSpend->key
+								== GetSpendKey(txHash, spendAmount, subtractFeeFromAmount, fee,
+											   keydata, index, coins)) {
+			spend = std::move(speculativeSpend);
+		} else {
+			DiscardSpeculativeSpendLocked();
+		}
+	}
+	if (!spend) {
+		return BuildJoinSplitScript(txHash, spendAmount, subtractFeeFromAmount, fee, keydata,
+									index, coins);
+	}
+
+	std::unique_lock<std::mutex> lock(spend->mutex);
+	spend->finishedCondition.wait(lock, [&spend]() { return spend->finished; });
+	if (!spend->error.empty()) {
+		throw std::runtime_error(spend->error);
+	}
+	char *script = new char[spend->script.size() + 1];
+	memcpy(script, spend->script.c_str(), spend->script.size() + 1);
+	CleanseString(spend->script);
+	return script;
+}
+
+const char *CreateMultiRecipientJoinSplitScript(
+		const char *txHash,
+		const std::vector<uint64_t> &outputValues,
+		uint64_t fee,
+		const char *keydata,
+		uint32_t index,
+		std::list<LelantusEntry> coins) {
+	{
+		std::lock_guard<std::mutex> lock(speculativeSpendMutex);
+		DiscardSpeculativeSpendLocked();
+	}
+	if (outputValues.empty()) {
+		throw std::runtime_error("No outputs to pay");
+	}
+	uint64_t spendAmount = 0;
+	for (uint64_t value : outputValues) {
+		spendAmount += value;
+	}
+	// the proof only binds the transparent total, the outputs are in the tx hash
+	return BuildJoinSplitScript(txHash, spendAmount, false, fee, keydata, index, coins);
 }
 
 uint64_t DecryptMintAmount(
@@ -253,3 +752,608 @@ uint64_t DecryptMintAmount(
 	return amount;
 }
 
+static bool DeriveAccountNode(const char *xprv, uint32_t node, ExtendedPrivateKey &out) {
+	ExtendedPrivateKey account;
+	if (!DecodeExtendedPrivateKey(xprv, account)) {
+		return false;
+	}
+	bool derived = DeriveChildKey(account, node, out);
+	ClearExtendedPrivateKey(account);
+	return derived;
+}
+
+static bool DeriveMintTag(
+		const ExtendedPrivateKey &mintNode,
+		int32_t index,
+		ExtendedPrivateKey &mintKey,
+		uint256 &tag
+) {
+	unsigned char identifier[20];
+	if (!DeriveChildKey(mintNode, index, mintKey) || !GetKeyIdentifier(mintKey.key, identifier)) {
+		ClearExtendedPrivateKey(mintKey);
+		return false;
+	}
+	std::vector<unsigned char> seedVector(identifier, identifier + 20);
+	tag = CreateMintTag(mintKey.key, index, uint160(seedVector));
+	return true;
+}
+
+std::vector<std::string> CreateTagBatch(
+		const char *xprv,
+		int32_t startIndex,
+		int32_t count
+) {
+	std::vector<std::string> tags;
+	ExtendedPrivateKey mintNode;
+	if (!DeriveAccountNode(xprv, BIP44_MINT_INDEX, mintNode)) {
+		return tags;
+	}
+
+	tags.reserve(count);
+	for (int32_t index = startIndex; index < startIndex + count; index++) {
+		ExtendedPrivateKey mintKey;
+		uint256 tag;
+		if (!DeriveMintTag(mintNode, index, mintKey, tag)) {
+			// keep the result aligned with the index range, empty tag never matches
+			tags.emplace_back();
+			continue;
+		}
+		tags.push_back(tag.GetHex());
+		ClearExtendedPrivateKey(mintKey);
+	}
+	ClearExtendedPrivateKey(mintNode);
+	return tags;
+}
+
+std::vector<MintBundle> CreateMintsBatch(
+		const char *xprv,
+		const std::vector<int32_t> &indexes,
+		const std::vector<uint64_t> &values
+) {
+	std::vector<MintBundle> bundles;
+	ExtendedPrivateKey mintNode;
+	if (!DeriveAccountNode(xprv, BIP44_MINT_INDEX, mintNode)) {
+		return bundles;
+	}
+
+	// lazily created params are not safe to initialise from several threads
+	lelantus::Params::get_default();
+
+	bundles.resize(indexes.size());
+	GetThreadPool().ParallelFor(0, indexes.size(), [&](size_t i) {
+		ExtendedPrivateKey mintKey;
+		unsigned char identifier[20];
+		if (!DeriveChildKey(mintNode, indexes[i], mintKey) || !GetKeyIdentifier(mintKey.key, identifier)) {
+			ClearExtendedPrivateKey(mintKey);
+			return;
+		}
+		std::vector<unsigned char> seedVector(identifier, identifier + 20);
+		bundles[i] = CreateMintBundle(values[i], mintKey.key, indexes[i], uint160(seedVector));
+		ClearExtendedPrivateKey(mintKey);
+	});
+	ClearExtendedPrivateKey(mintNode);
+	return bundles;
+}
+
+MintBundle CreateJMintBundle(
+		uint64_t value,
+		const char *xprv,
+		int32_t index
+) {
+	MintBundle bundle;
+	ExtendedPrivateKey mintNode;
+	ExtendedPrivateKey mintKey;
+	ExtendedPrivateKey mintValueNode;
+	ExtendedPrivateKey aesKey;
+	unsigned char identifier[20];
+	bool derived = DeriveAccountNode(xprv, BIP44_MINT_INDEX, mintNode)
+				   && DeriveChildKey(mintNode, index, mintKey)
+				   && GetKeyIdentifier(mintKey.key, identifier)
+				   && DeriveAccountNode(xprv, BIP44_MINT_VALUE_INDEX, mintValueNode);
+
+	if (derived) {
+		std::vector<unsigned char> seedVector(identifier, identifier + 20);
+		uint160 seedID(seedVector);
+		uint32_t keyPathOut;
+		lelantus::PrivateCoin privateCoin = CreateMintPrivateCoin(value, mintKey.key, index, keyPathOut);
+		if (DeriveChildKey(mintValueNode, keyPathOut, aesKey)) {
+			std::vector<unsigned char> script;
+			CreateJMintScriptFromPrivateCoin(privateCoin, value, seedID, aesKey.key, script);
+			bundle.script = EncodeHex(script.data(), script.size());
+
+			std::vector<unsigned char> publicCoin = privateCoin.getPublicCoin().getValue().getvch();
+			bundle.publicCoin = EncodeHex(publicCoin.data(), publicCoin.size());
+			unsigned char serialNumber[32];
+			privateCoin.getSerialNumber().serialize(serialNumber);
+			bundle.serialNumber = EncodeHex(serialNumber, sizeof(serialNumber));
+			bundle.tag = CreateMintTag(mintKey.key, index, seedID).GetHex();
+			bundle.keyPath = keyPathOut;
+		}
+	}
+
+	ClearExtendedPrivateKey(mintNode);
+	ClearExtendedPrivateKey(mintKey);
+	ClearExtendedPrivateKey(mintValueNode);
+	ClearExtendedPrivateKey(aesKey);
+	return bundle;
+}
+
+static SerialSet usedSerialSet;
+static std::mutex usedSerialSetMutex;
+
+// locked after the set store and the used serials set
+static CoinTable coinTable;
+static std::mutex coinTableMutex;
+
+uint64_t OpenUsedSerialSet(const char *path) {
+	std::lock_guard<std::mutex> lock(usedSerialSetMutex);
+	if (usedSerialSet.GetPath() != path) {
+		usedSerialSet.Open(path);
+	}
+	return usedSerialSet.GetCount();
+}
+
+uint64_t AppendUsedSerials(const std::vector<const char *> &serialsBase64) {
+	std::vector<Serial> serials(serialsBase64.size());
+	for (size_t i = 0; i < serialsBase64.size(); i++) {
+		if (!DecodeSerialBase64(serialsBase64[i], serials[i])) {
+			// still stored, so the record count keeps matching the server offset
+			serials[i].fill(0);
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(usedSerialSetMutex);
+	usedSerialSet.Append(serials);
+	{
+		std::lock_guard<std::mutex> coinTableLock(coinTableMutex);
+		coinTable.MarkUsedSerials(serials);
+	}
+	return usedSerialSet.GetCount();
+}
+
+std::vector<int32_t> OpenAnonymitySetStore(const char *directory, uint32_t memoryBudgetMb) {
+	std::lock_guard<std::mutex> lock(setStoreMutex);
+	setStore.SetMemoryBudget((size_t) memoryBudgetMb << 20);
+	if (setStore.GetDirectory() != directory) {
+		setStore.Open(directory);
+	}
+	return setStore.GetSetIds();
+}
+
+size_t GetAnonymitySetInfo(int32_t setId, std::string &setHash, std::string &blockHash) {
+	std::lock_guard<std::mutex> lock(setStoreMutex);
+	size_t count;
+	if (!setStore.GetSetInfo(setId, setHash, blockHash, count)) {
+		setHash.clear();
+		blockHash.clear();
+		return 0;
+	}
+	return count;
+}
+
+bool MergeAnonymitySetResponse(
+		int32_t setId,
+		const char *json,
+		size_t length,
+		SetCoinRange &range
+) {
+	range = {0, 0};
+	AnonymitySetResponse response;
+	if (!ParseAnonymitySetResponse(json, length, response)) {
+		return false;
+	}
+	if (response.setHash.empty()) {
+		return true;
+	}
+	// the response has the newest coins first, the store keeps them last
+	std::reverse(response.coins.begin(), response.coins.end());
+
+	std::lock_guard<std::mutex> lock(setStoreMutex);
+	std::string storedSetHash;
+	std::string storedBlockHash;
+	// unchanged sets are not loaded
+	if (setStore.GetSetInfo(setId, storedSetHash, storedBlockHash, range.first)
+		&& storedSetHash == response.setHash) {
+		return true;
+	}
+	range = setStore.Append(setId, response.setHash, response.blockHash, response.coins);
+	return true;
+}
+
+void UpdateAnonymitySet(
+		int32_t setId,
+		const char *setHash,
+		const char *blockHash,
+		std::vector<SetCoin> &&coins
+) {
+	std::reverse(coins.begin(), coins.end());
+	StoredAnonymitySet set{setId, setHash, blockHash, std::move(coins)};
+	std::lock_guard<std::mutex> lock(setStoreMutex);
+	setStore.Update(std::move(set));
+}
+
+std::vector<bool> ContainsMintTags(const std::vector<const char *> &tagsHex) {
+	std::vector<bool> result(tagsHex.size(), false);
+
+	std::lock_guard<std::mutex> lock(setStoreMutex);
+	for (size_t i = 0; i < tagsHex.size(); i++) {
+		MintTag tag;
+		if (DecodeHex(tagsHex[i], tag.data(), tag.size())) {
+			result[i] = setStore.ContainsTag(tag);
+		}
+	}
+	return result;
+}
+
+size_t CacheAnonymitySetPoints(const std::vector<int32_t> &setIds) {
+	size_t cached = 0;
+	for (int32_t setId : setIds) {
+		std::string path;
+		std::vector<PublicCoinKey> publicCoins;
+		{
+			std::lock_guard<std::mutex> lock(setStoreMutex);
+			const StoredAnonymitySet *set = setStore.GetSet(setId);
+			path = setStore.GetPointCachePath(setId);
+			if (set == nullptr || path.empty()) {
+				continue;
+			}
+			publicCoins = GetPublicCoins(*set);
+		}
+
+		// decompressing takes a while, the store is not locked meanwhile
+		std::vector<AffinePoint> points;
+		ReadPointCache(path, setId, publicCoins, points);
+		size_t stored = points.size();
+		if (stored < publicCoins.size()
+			&& (!DecompressPublicCoins(publicCoins, stored, publicCoins.size(), points)
+				|| !WritePointCache(path, setId, points))) {
+			continue;
+		}
+		cached += points.size();
+	}
+	return cached;
+}
+
+// Minimum number of indexes derived per thread in one speculative scan block.
+static const size_t SCAN_INDEXES_PER_THREAD = 16;
+
+struct ScanResult {
+	bool found;
+	int32_t setId;
+	SetCoin coin;
+	uint64_t value;
+	bool isUsed;
+};
+
+static void ScanMintIndex(
+		const ExtendedPrivateKey &mintNode,
+		const ExtendedPrivateKey &mintValueNode,
+		int32_t index,
+		ScanResult &result
+) {
+	result.found = false;
+	ExtendedPrivateKey mintKey;
+	uint256 tag;
+	if (!DeriveMintTag(mintNode, index, mintKey, tag)) {
+		return;
+	}
+	MintTag tagKey;
+	DecodeHex(tag.GetHex().c_str(), tagKey.data(), tagKey.size());
+	if (!setStore.FindByTag(tagKey, result.setId, result.coin)) {
+		ClearExtendedPrivateKey(mintKey);
+		return;
+	}
+	result.found = true;
+
+	result.value = result.coin.GetValue();
+	if (result.coin.isJMint) {
+		ExtendedPrivateKey aesKey;
+		std::string publicCoin = EncodeHex(result.coin.publicCoin, sizeof(result.coin.publicCoin));
+		uint32_t keyPath = GenerateAESKeyPath(publicCoin.c_str());
+		if (DeriveChildKey(mintValueNode, keyPath, aesKey)) {
+			// stored encrypted values are zero padded to 48 bytes already
+			std::vector<unsigned char> encryptedValueVector(
+					result.coin.value, result.coin.value + sizeof(result.coin.value));
+			DecryptMintAmount(aesKey.key, encryptedValueVector, result.value);
+			ClearExtendedPrivateKey(aesKey);
+		}
+	}
+
+	uint32_t keyPathOut;
+	lelantus::PrivateCoin privateCoin = CreateMintPrivateCoin(
+			result.value, mintKey.key, index, keyPathOut
+	);
+	Serial serial;
+	privateCoin.getSerialNumber().serialize(serial.data());
+	result.isUsed = usedSerialSet.Contains(serial);
+	ClearExtendedPrivateKey(mintKey);
+}
+
+std::vector<ScannedMint> ScanMints(
+		const char *xprv,
+		int32_t startIndex,
+		int32_t gapLimit
+) {
+	prewarmJob.Cancel();
+
+	std::vector<ScannedMint> mints;
+	ExtendedPrivateKey mintNode;
+	ExtendedPrivateKey mintValueNode;
+	if (!DeriveAccountNode(xprv, BIP44_MINT_INDEX, mintNode)) {
+		return mints;
+	}
+	if (!DeriveAccountNode(xprv, BIP44_MINT_VALUE_INDEX, mintValueNode)) {
+		ClearExtendedPrivateKey(mintNode);
+		return mints;
+	}
+
+	// both stores are only read by the workers while the locks are held here
+	std::lock_guard<std::mutex> setStoreLock(setStoreMutex);
+	std::lock_guard<std::mutex> usedSerialSetLock(usedSerialSetMutex);
+
+	// lazily created params are not safe to initialise from several threads
+	lelantus::Params::get_default();
+
+	ThreadPool &pool = GetThreadPool();
+	size_t blockSize = std::max<size_t>(gapLimit, pool.GetThreadCount() * SCAN_INDEXES_PER_THREAD);
+	std::vector<ScanResult> results(blockSize);
+
+	// Indexes are scanned speculatively in blocks that may run past the current gap
+	// window, the gap limit rule is then applied to the block in index order, so the
+	// result is the same as the one of a sequential scan.
+	int32_t lastFoundIndex = startIndex - 1;
+	int32_t blockStart = startIndex;
+	while (blockStart < lastFoundIndex + gapLimit) {
+		pool.ParallelFor(0, blockSize, [&](size_t i) {
+			ScanMintIndex(mintNode, mintValueNode, blockStart + (int32_t) i, results[i]);
+		});
+
+		int32_t index = blockStart;
+		for (; index < blockStart + (int32_t) blockSize && index < lastFoundIndex + gapLimit; index++) {
+			const ScanResult &result = results[index - blockStart];
+			if (!result.found) {
+				continue;
+			}
+			lastFoundIndex = index;
+			mints.push_back({index, result.value,
+							 EncodeHex(result.coin.publicCoin, sizeof(result.coin.publicCoin)),
+							 EncodeHex(result.coin.txId, sizeof(result.coin.txId)),
+							 result.setId, result.coin.isJMint != 0, result.isUsed});
+		}
+		blockStart = index;
+	}
+
+	ClearExtendedPrivateKey(mintNode);
+	ClearExtendedPrivateKey(mintValueNode);
+	return mints;
+}
+
+size_t LoadWalletCoins(const std::vector<StoredCoin> &coins) {
+	std::lock_guard<std::mutex> lock(coinTableMutex);
+	return coinTable.Load(coins);
+}
+
+size_t PutWalletCoins(const std::vector<StoredCoin> &coins) {
+	std::lock_guard<std::mutex> lock(coinTableMutex);
+	return coinTable.Put(coins);
+}
+
+size_t MarkWalletCoinsUsed(const std::vector<int32_t> &indexes) {
+	std::lock_guard<std::mutex> lock(coinTableMutex);
+	return coinTable.MarkUsed(indexes);
+}
+
+size_t MarkSpentWalletCoins(const char *xprv) {
+	std::vector<std::pair<int32_t, uint64_t>> missing;
+	{
+		std::lock_guard<std::mutex> lock(coinTableMutex);
+		missing = coinTable.GetUnspentWithoutSerial();
+	}
+
+	if (!missing.empty()) {
+		ExtendedPrivateKey mintNode;
+		if (!DeriveAccountNode(xprv, BIP44_MINT_INDEX, mintNode)) {
+			return 0;
+		}
+		lelantus::Params::get_default();
+
+		// deriving is the slow part, the table is not locked meanwhile
+		std::vector<Serial> serials(missing.size());
+		std::vector<unsigned char> derived(missing.size(), 0);
+		GetThreadPool().ParallelFor(0, missing.size(), [&](size_t i) {
+			ExtendedPrivateKey mintKey;
+			if (!DeriveChildKey(mintNode, missing[i].first, mintKey)) {
+				return;
+			}
+			uint32_t keyPathOut;
+			lelantus::PrivateCoin privateCoin = CreateMintPrivateCoin(
+					missing[i].second, mintKey.key, missing[i].first, keyPathOut
+			);
+			privateCoin.getSerialNumber().serialize(serials[i].data());
+			derived[i] = 1;
+			ClearExtendedPrivateKey(mintKey);
+		});
+		ClearExtendedPrivateKey(mintNode);
+
+		std::lock_guard<std::mutex> lock(coinTableMutex);
+		for (size_t i = 0; i < missing.size(); i++) {
+			if (derived[i]) {
+				coinTable.SetSerial(missing[i].first, missing[i].second, serials[i]);
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> usedSerialSetLock(usedSerialSetMutex);
+	std::lock_guard<std::mutex> coinTableLock(coinTableMutex);
+	std::vector<int32_t> usedIndexes;
+	for (const auto &entry : coinTable.GetUnspentSerials()) {
+		if (usedSerialSet.Contains(entry.second)) {
+			usedIndexes.push_back(entry.first);
+		}
+	}
+	return coinTable.MarkUsed(usedIndexes);
+}
+
+std::vector<std::string> UpdateWalletCoinSetIds() {
+	std::lock_guard<std::mutex> setStoreLock(setStoreMutex);
+	std::lock_guard<std::mutex> coinTableLock(coinTableMutex);
+	return coinTable.UpdateSetIds(setStore);
+}
+
+std::vector<StoredCoin> GetWalletCoins(int32_t filter) {
+	std::lock_guard<std::mutex> lock(coinTableMutex);
+	return coinTable.Get((CoinFilter) filter);
+}
+
+std::vector<int32_t> GetUnspentCoinSetIds() {
+	std::lock_guard<std::mutex> lock(coinTableMutex);
+	return coinTable.GetUnspentSetIds();
+}
+
+// Serials and fee of a serialized JoinSplit, false if it doesn't deserialize.
+static bool ReadJoinSplit(const std::vector<unsigned char> &data, ParsedJoinSplit &parsed,
+						  std::vector<Serial> &serials) {
+	try {
+		CDataStream stream((const char *) data.data(), (const char *) data.data() + data.size(),
+						   SER_NETWORK, PROTOCOL_VERSION);
+		lelantus::JoinSplit joinSplit(lelantus::Params::get_default(), stream);
+		const std::vector<secp_primitives::Scalar> &serialNumbers = joinSplit.getCoinSerialNumbers();
+		serials.resize(serialNumbers.size());
+		for (size_t i = 0; i < serialNumbers.size(); i++) {
+			serialNumbers[i].serialize(serials[i].data());
+			parsed.serialNumbers.push_back(EncodeHex(serials[i].data(), serials[i].size()));
+		}
+		parsed.fee = joinSplit.getFee();
+	} catch (const std::exception &) {
+		return false;
+	}
+	return true;
+}
+
+static void ParseJoinSplit(const std::string &rawTx, ParsedJoinSplit &parsed, std::vector<Serial> &serials) {
+	std::vector<unsigned char> bytes(rawTx.size() / 2);
+	RawTransaction tx;
+	std::vector<unsigned char> joinSplit;
+	if (rawTx.size() % 2 != 0
+		|| !DecodeHex(rawTx.c_str(), bytes.data(), bytes.size())
+		|| !ParseRawTransaction(bytes.data(), bytes.size(), tx)
+		|| !GetJoinSplitData(tx, joinSplit)
+		|| !ReadJoinSplit(joinSplit, parsed, serials)) {
+		parsed = ParsedJoinSplit();
+		serials.clear();
+		return;
+	}
+	PublicCoinKey publicCoin;
+	std::vector<unsigned char> encryptedValue;
+	for (const std::vector<unsigned char> &script : tx.outputScripts) {
+		if (ParseJMintScript(script, publicCoin, encryptedValue)) {
+			parsed.publicCoins.push_back(EncodeHex(publicCoin.data(), publicCoin.size()));
+			parsed.encryptedValues.push_back(EncodeHex(encryptedValue.data(), encryptedValue.size()));
+		}
+	}
+	parsed.valid = true;
+}
+
+std::vector<ParsedJoinSplit> ParseJoinSplits(const std::vector<std::string> &rawTxs) {
+	std::vector<ParsedJoinSplit> result(rawTxs.size());
+	std::vector<std::vector<Serial>> serials(rawTxs.size());
+	lelantus::Params::get_default();
+	GetThreadPool().ParallelFor(0, rawTxs.size(), [&](size_t i) {
+		ParseJoinSplit(rawTxs[i], result[i], serials[i]);
+	});
+
+	std::lock_guard<std::mutex> lock(coinTableMutex);
+	for (size_t i = 0; i < rawTxs.size(); i++) {
+		result[i].spentCoinIndexes = coinTable.FindSerials(serials[i]);
+	}
+	return result;
+}
+
+std::vector<int32_t> SelectSpendCoins(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		int32_t strategy,
+		int32_t outputCount,
+		uint64_t &fee,
+		uint64_t &changeToMint
+) {
+	CoinSelection selection;
+	if (!SelectCoins(coins, spendAmount, subtractFeeFromAmount, (CoinSelectionStrategy) strategy,
+					 GetStoredSetSizes(), std::max<int32_t>(outputCount, 1), selection)) {
+		fee = 0;
+		changeToMint = 0;
+		return std::vector<int32_t>();
+	}
+	fee = selection.fee;
+	changeToMint = selection.changeToMint;
+	return std::vector<int32_t>(selection.selected.begin(), selection.selected.end());
+}
+
+uint64_t QuickEstimateFee(
+		const std::vector<uint64_t> &amounts,
+		const std::vector<int32_t> &setIds,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount
+) {
+	std::vector<SelectionCoin> coins;
+	coins.reserve(amounts.size());
+	for (size_t i = 0; i < amounts.size(); i++) {
+		coins.push_back({amounts[i], setIds[i], 0});
+	}
+
+	CoinSelection selection;
+	if (!SelectCoins(coins, spendAmount, subtractFeeFromAmount, SPEND_COIN_SELECTION,
+					 GetStoredSetSizes(), selection)) {
+		return 0;
+	}
+	return selection.fee;
+}
+
+ProvingCost GetSpendProvingCost(const std::vector<int32_t> &setIds) {
+	std::vector<SelectionCoin> coins;
+	std::vector<size_t> selected;
+	coins.reserve(setIds.size());
+	for (int32_t setId : setIds) {
+		selected.push_back(coins.size());
+		coins.push_back({0, setId, 0});
+	}
+	return PredictProvingCost(coins, selected, GetStoredSetSizes());
+}
+
+std::vector<ConsolidationStep> PlanWalletConsolidation(
+		const std::vector<SelectionCoin> &coins,
+		int32_t minCoins,
+		int32_t maxInputs
+) {
+	return PlanConsolidation(coins, GetStoredSetSizes(), std::max<int32_t>(minCoins, 0),
+							 std::max<int32_t>(maxInputs, 0));
+}
+
+const char *CreateConsolidationScript(
+		const char *txHash,
+		const char *keydata,
+		uint32_t index,
+		std::list<LelantusEntry> coins) {
+	{
+		std::lock_guard<std::mutex> lock(speculativeSpendMutex);
+		DiscardSpeculativeSpendLocked();
+	}
+
+	std::vector<const LelantusEntry *> entries;
+	std::vector<SelectionCoin> selectionCoins = ToSelectionCoins(coins, entries);
+
+	// every coin is spent, whatever is left after the fee is minted
+	CoinSelection selection;
+	uint64_t sum = SelectEveryCoin(selectionCoins, selection);
+	std::set<int32_t> setIds;
+	for (const SelectionCoin &coin : selectionCoins) {
+		setIds.insert(coin.anonymitySetId);
+	}
+	selection.fee = EstimateConsolidationFee(selection.selected.size(), setIds.size());
+	if (selection.selected.empty() || sum <= selection.fee) {
+		throw std::runtime_error("Insufficient funds");
+	}
+	selection.changeToMint = sum - selection.fee;
+	return ProveJoinSplit(txHash, 0, selection, selectionCoins, entries, keydata, index);
+}
@@ -2,6 +2,10 @@
 #define LELANTUSWRAPPERTEST_LELANTUSWRAPPER_H
 
 #include "liblelantus/include/lelantus.h"
+#include "CoinSelection.h"
+#include "CoinTable.h"
+#include "Consolidation.h"
+#include "SetStore.h"
 
 struct LelantusEntry {
 	bool isUsed;
@@ -12,6 +16,16 @@ struct LelantusEntry {
 	const char *keydata;
 };
 
+struct ScannedMint {
+	int32_t index;
+	uint64_t value;
+	std::string publicCoin;
+	std::string txId;
+	int32_t anonymitySetId;
+	bool isJMint;
+	bool isUsed;
+};
+
 const char *CreateMintScript(
 		uint64_t value,
 		const char *keydata,
@@ -37,6 +51,15 @@ const char *GetSerialNumber(
 		int32_t index
 );
 
+// What the wallet keeps of a new mint, hex strings but the key path.
+struct MintBundle {
+	std::string script;
+	std::string publicCoin;
+	std::string tag;
+	std::string serialNumber;
+	uint32_t keyPath = 0;
+};
+
 uint64_t EstimateFee(
 		uint64_t spendAmount,
 		bool subtractFeeFromAmount,
@@ -62,22 +85,251 @@ const char *CreateJMintScript(
 		const char *seedID,
 		const char *AESkeydata);
 
+/*
+ * Change mint of a spend from one derivation of its private coin. The mint key and
+ * the AES key of its value, at the key path of the coin, are derived from the
+ * account xprv and stay binary. The script is empty if a key can't be derived.
+ */
+MintBundle CreateJMintBundle(
+		uint64_t value,
+		const char *xprv,
+		int32_t index
+);
+
+/*
+ * Proves a spend of every coin passed over their anonymity sets, which are read from
+ * the set store. The coins and the fee are those of a SelectSpendCoins selection, the
+ * change is what is left of them. A speculative spend with the same arguments is taken
+ * over, waiting for it if it is still proving.
+ */
 const char *CreateJoinSplitScript(
 		const char *txHash,
 		uint64_t spendAmount,
 		bool subtractFeeFromAmount,
+		uint64_t fee,
 		const char *keydata,
 		uint32_t index,
-		std::list<LelantusEntry> coins,
-		std::vector<uint32_t> setIds,
-		std::vector<std::vector<const char *>> anonymitySets,
-		const std::vector<const char *> &anonymitySetHashes,
-		std::vector<const char *> groupBlockHashes
+		std::list<LelantusEntry> coins
+);
+
+/*
+ * One JoinSplit for a payout to several transparent outputs, sharing the proof and the
+ * anonymity sets. Every coin is spent for the sum of outputValues with the fee of that
+ * many outputs on top, the tx hash is that of the tx with the change jmint followed by
+ * the outputs. Drops a speculative spend.
+ */
+const char *CreateMultiRecipientJoinSplitScript(
+		const char *txHash,
+		const std::vector<uint64_t> &outputValues,
+		uint64_t fee,
+		const char *keydata,
+		uint32_t index,
+		std::list<LelantusEntry> coins
 );
 
+/*
+ * Starts proving the spend on a background thread while the user reviews it, the
+ * arguments are those of CreateJoinSplitScript and are copied. Starting another one,
+ * a spend with other arguments or DiscardSpeculativeSpend drops it, its script and
+ * key copies are wiped.
+ */
+void StartSpeculativeSpend(
+		const char *txHash,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		uint64_t fee,
+		const char *keydata,
+		uint32_t index,
+		const std::list<LelantusEntry> &coins
+);
+
+void DiscardSpeculativeSpend();
+
 uint64_t DecryptMintAmount(
 		const char *privateKeyAES,
 		const char *encryptedValue
 );
 
+/*
+ * The batch functions below take the account level xprv (m/44'/136'/0') and derive
+ * the mint (.../2/index) and mint value (.../5/keyPath) keys natively, so private
+ * keys of single coins never leave the native side.
+ */
+std::vector<std::string> CreateTagBatch(
+		const char *xprv,
+		int32_t startIndex,
+		int32_t count
+);
+
+/*
+ * Mint bundles of the (index, value) pairs, derived in parallel on the thread pool.
+ * A bundle whose key can't be derived has an empty script.
+ */
+std::vector<MintBundle> CreateMintsBatch(
+		const char *xprv,
+		const std::vector<int32_t> &indexes,
+		const std::vector<uint64_t> &values
+);
+
+/*
+ * Used serials set shared by all wallets, kept in a file at the given path.
+ * Both Open and Append return the number of appended records, which is the
+ * offset for the next lelantus.getusedcoinserials request.
+ */
+uint64_t OpenUsedSerialSet(const char *path);
+
+uint64_t AppendUsedSerials(const std::vector<const char *> &serialsBase64);
+
+/*
+ * Opens the anonymity set files of the directory and keeps the sets there from now
+ * on. The set indexes and the loaded coins take at most memoryBudgetMb, as far as
+ * the set in use allows. Returns the ids of the stored sets.
+ */
+std::vector<int32_t> OpenAnonymitySetStore(const char *directory, uint32_t memoryBudgetMb);
+
+/*
+ * Hashes and coin count of a stored set. Hashes are empty and the count 0 for sets
+ * that were not fetched yet.
+ */
+size_t GetAnonymitySetInfo(int32_t setId, std::string &setHash, std::string &blockHash);
+
+/*
+ * Decodes the JSON text of a lelantus.getanonymityset result and appends its coins to
+ * the stored set. range is set to the positions of the new coins in the store, false
+ * if the result is malformed.
+ */
+bool MergeAnonymitySetResponse(
+		int32_t setId,
+		const char *json,
+		size_t length,
+		SetCoinRange &range
+);
+
+// Coins are in the order of the JS set, used to move sets out of Realm.
+void UpdateAnonymitySet(
+		int32_t setId,
+		const char *setHash,
+		const char *blockHash,
+		std::vector<SetCoin> &&coins
+);
+
+// Whether a coin with the given tag is in any stored set.
+std::vector<bool> ContainsMintTags(const std::vector<const char *> &tagsHex);
+
+/*
+ * Keeps the affine coordinates of the coins of the given sets next to their files, so
+ * spends from them skip decompressing the set. Only coins added since the last call
+ * are decompressed. Returns the number of cached points.
+ */
+size_t CacheAnonymitySetPoints(const std::vector<int32_t> &setIds);
+
+/*
+ * Builds the group elements of the given sets on a low priority thread and returns
+ * at once, so the next spend from them doesn't wait for it. Spends and mint scans
+ * cancel the job, sets it finished are kept until they are spent from or change.
+ */
+void StartSpendPrewarm(const std::vector<int32_t> &setIds);
+
+/*
+ * Gap limit scan over the mint node of the account xprv. Tags are looked up in
+ * the anonymity set store and spent state in the used serials set.
+ */
+std::vector<ScannedMint> ScanMints(
+		const char *xprv,
+		int32_t startIndex,
+		int32_t gapLimit
+);
+
+/*
+ * Lelantus coins of the open wallet, see CoinTable. The JS coin list is loaded once
+ * and every change goes through these functions, JS reads snapshots back.
+ */
+size_t LoadWalletCoins(const std::vector<StoredCoin> &coins);
+
+size_t PutWalletCoins(const std::vector<StoredCoin> &coins);
+
+size_t MarkWalletCoinsUsed(const std::vector<int32_t> &indexes);
+
+/*
+ * Derives the serials of unspent coins that have none yet from the account xprv,
+ * then marks the coins whose serial is in the used serials set. Later appends to the
+ * set mark coins by the serial index. Returns the number of coins marked.
+ */
+size_t MarkSpentWalletCoins(const char *xprv);
+
+// Moves coins that are not used to their newest stored set, returns their tx ids.
+std::vector<std::string> UpdateWalletCoinSetIds();
+
+std::vector<StoredCoin> GetWalletCoins(int32_t filter);
+
+std::vector<int32_t> GetUnspentCoinSetIds();
+
+// What a lelantus spend reveals, hex strings like the rest of the wallet.
+struct ParsedJoinSplit {
+	// false for transactions that are not lelantus spends
+	bool valid = false;
+	uint64_t fee = 0;
+	std::vector<std::string> serialNumbers;
+	// mint indexes of the wallet coins the spend uses
+	std::vector<int32_t> spentCoinIndexes;
+	// public coins and encrypted values of the jmint outputs
+	std::vector<std::string> publicCoins;
+	std::vector<std::string> encryptedValues;
+};
+
+/*
+ * Reads the spent serials and the jmints of raw transactions in parallel. Serials and
+ * fee come from the JoinSplit, which is deserialized but not verified, the jmints from
+ * the output scripts. Spent coins are looked up in the wallet coins, not marked.
+ */
+std::vector<ParsedJoinSplit> ParseJoinSplits(const std::vector<std::string> &rawTxs);
+
+/*
+ * Coin selection over amounts and set ids only, returns positions of the selected
+ * coins in the input, empty when the coins don't cover the amount. The fee is that of
+ * a spend to outputCount transparent outputs.
+ */
+std::vector<int32_t> SelectSpendCoins(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		int32_t strategy,
+		int32_t outputCount,
+		uint64_t &fee,
+		uint64_t &changeToMint
+);
+
+/*
+ * Fee of the spend EstimateFee would build, from amounts and set ids only. Returns 0
+ * when the coins don't cover the amount.
+ */
+uint64_t QuickEstimateFee(
+		const std::vector<uint64_t> &amounts,
+		const std::vector<int32_t> &setIds,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount
+);
+
+// Predicted proving cost of a spend, setIds holds the anonymity set of every input.
+ProvingCost GetSpendProvingCost(const std::vector<int32_t> &setIds);
+
+// See PlanConsolidation, set sizes are those of the set store.
+std::vector<ConsolidationStep> PlanWalletConsolidation(
+		const std::vector<SelectionCoin> &coins,
+		int32_t minCoins,
+		int32_t maxInputs
+);
+
+/*
+ * Proves a consolidation step, a self-spend of every unused coin into the jmint at
+ * index. The fee is EstimateConsolidationFee, the tx hash is that of the tx with the
+ * jmint as its only output. Drops a speculative spend.
+ */
+const char *CreateConsolidationScript(
+		const char *txHash,
+		const char *keydata,
+		uint32_t index,
+		std::list<LelantusEntry> coins
+);
+
 #endif //LELANTUSWRAPPERTEST_LELANTUSWRAPPER_H
@@ -0,0 +1,156 @@
+#include "PointCache.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#include "liblelantus/secp256k1/include/secp256k1.h"
+
+static const char POINT_CACHE_MAGIC[4] = {'A', 'P', 'N', 'T'};
+static const uint32_t POINT_CACHE_VERSION = 1;
+
+// Points handled by one pool task.
+static const size_t POINTS_PER_TASK = 1024;
+
+// Layout of a serialized GroupElement: x(32) | y is odd(1) | is infinity(1).
+static const size_t COIN_PARITY_BYTE = 32;
+static const size_t COIN_INFINITY_BYTE = 33;
+
+static secp256k1_context *GetSecp256k1Context() {
+	static secp256k1_context *context = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+	return context;
+}
+
+static bool DecompressPublicCoin(const PublicCoinKey &publicCoin, AffinePoint &point) {
+	if (publicCoin[COIN_INFINITY_BYTE] != 0 || publicCoin[COIN_PARITY_BYTE] > 1) {
+		return false;
+	}
+	unsigned char compressed[33];
+	compressed[0] = publicCoin[COIN_PARITY_BYTE] ? 0x03 : 0x02;
+	memcpy(compressed + 1, publicCoin.data(), 32);
+	secp256k1_pubkey pubkey;
+	unsigned char uncompressed[65];
+	size_t uncompressedSize = sizeof(uncompressed);
+	if (!secp256k1_ec_pubkey_parse(GetSecp256k1Context(), &pubkey, compressed, sizeof(compressed))
+		|| !secp256k1_ec_pubkey_serialize(GetSecp256k1Context(), uncompressed, &uncompressedSize,
+										  &pubkey, SECP256K1_EC_UNCOMPRESSED)
+		|| uncompressedSize != sizeof(uncompressed)) {
+		return false;
+	}
+	memcpy(point.x, uncompressed + 1, 32);
+	memcpy(point.y, uncompressed + 33, 32);
+	return true;
+}
+
+// Parsing an uncompressed key only checks the curve equation, there is no square root.
+static bool MatchesPublicCoin(const AffinePoint &point, const PublicCoinKey &publicCoin) {
+	if (publicCoin[COIN_INFINITY_BYTE] != 0
+		|| memcmp(point.x, publicCoin.data(), 32) != 0
+		|| (point.y[31] & 1) != publicCoin[COIN_PARITY_BYTE]) {
+		return false;
+	}
+	unsigned char uncompressed[65];
+	uncompressed[0] = 0x04;
+	memcpy(uncompressed + 1, point.x, 32);
+	memcpy(uncompressed + 33, point.y, 32);
+	secp256k1_pubkey pubkey;
+	return secp256k1_ec_pubkey_parse(GetSecp256k1Context(), &pubkey, uncompressed,
+									 sizeof(uncompressed)) == 1;
+}
+
+// Calls fn(i) for every point in [from, to) on the pool, false if one of the calls failed.
+template<typename F>
+static bool ForEachPoint(size_t from, size_t to, F fn) {
+	if (from >= to) {
+		return true;
+	}
+	std::atomic<bool> valid(true);
+	size_t taskCount = (to - from + POINTS_PER_TASK - 1) / POINTS_PER_TASK;
+	GetThreadPool().ParallelFor(0, taskCount, [&](size_t task) {
+		size_t begin = from + task * POINTS_PER_TASK;
+		size_t end = std::min(begin + POINTS_PER_TASK, to);
+		for (size_t i = begin; i < end && valid; i++) {
+			if (!fn(i)) {
+				valid = false;
+			}
+		}
+	});
+	return valid;
+}
+
+bool DecompressPublicCoins(
+		const std::vector<PublicCoinKey> &publicCoins,
+		size_t from,
+		size_t to,
+		std::vector<AffinePoint> &points
+) {
+	size_t first = points.size();
+	points.resize(first + (to - from));
+	bool decompressed = ForEachPoint(from, to, [&](size_t i) {
+		return DecompressPublicCoin(publicCoins[i], points[first + i - from]);
+	});
+	if (!decompressed) {
+		points.resize(first);
+	}
+	return decompressed;
+}
+
+bool ReadPointCache(
+		const std::string &path,
+		int32_t setId,
+		const std::vector<PublicCoinKey> &publicCoins,
+		std::vector<AffinePoint> &points
+) {
+	points.clear();
+	FILE *file = fopen(path.c_str(), "rb");
+	if (file == nullptr) {
+		return false;
+	}
+	char magic[4];
+	uint32_t version;
+	int32_t fileSetId;
+	uint64_t count;
+	bool read = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+				&& memcmp(magic, POINT_CACHE_MAGIC, sizeof(magic)) == 0
+				&& fread(&version, sizeof(version), 1, file) == 1
+				&& version == POINT_CACHE_VERSION
+				&& fread(&fileSetId, sizeof(fileSetId), 1, file) == 1
+				&& fileSetId == setId
+				&& fread(&count, sizeof(count), 1, file) == 1;
+	if (read) {
+		// points past the coins belong to a set that was dropped and fetched again
+		points.resize(std::min<uint64_t>(count, publicCoins.size()));
+		read = fread(points.data(), sizeof(AffinePoint), points.size(), file) == points.size();
+	}
+	fclose(file);
+
+	if (!read || !ForEachPoint(0, points.size(), [&](size_t i) {
+		return MatchesPublicCoin(points[i], publicCoins[i]);
+	})) {
+		points.clear();
+		return false;
+	}
+	return true;
+}
+
+bool WritePointCache(const std::string &path, int32_t setId, const std::vector<AffinePoint> &points) {
+	std::string temporaryPath = path + ".tmp";
+	FILE *file = fopen(temporaryPath.c_str(), "wb");
+	if (file == nullptr) {
+		return false;
+	}
+	uint64_t count = points.size();
+	bool written = fwrite(POINT_CACHE_MAGIC, 1, sizeof(POINT_CACHE_MAGIC), file) == sizeof(POINT_CACHE_MAGIC)
+				   && fwrite(&POINT_CACHE_VERSION, sizeof(POINT_CACHE_VERSION), 1, file) == 1
+				   && fwrite(&setId, sizeof(setId), 1, file) == 1
+				   && fwrite(&count, sizeof(count), 1, file) == 1
+				   && fwrite(points.data(), sizeof(AffinePoint), points.size(), file) == points.size();
+	written = fclose(file) == 0 && written;
+	if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+		remove(temporaryPath.c_str());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,50 @@
+#ifndef ORG_FIRO_LELANTUS_POINTCACHE_H
+#define ORG_FIRO_LELANTUS_POINTCACHE_H
+
+#include "SetStore.h"
+
+#include <string>
+#include <vector>
+
+/*
+ * Affine coordinates of the public coins of a set, so a spend can build the group
+ * elements of the set without a field square root per coin. Kept next to the set
+ * file for the sets holding our coins only:
+ * magic(4) | version(4) | set id(4) | point count(8), followed by 64 byte x | y
+ * records in store order, both big endian.
+ */
+struct AffinePoint {
+	unsigned char x[32];
+	unsigned char y[32];
+};
+
+static_assert(sizeof(AffinePoint) == 64, "points are stored as packed 64 byte records");
+
+/*
+ * Decompresses publicCoins[from, to) and appends them to points, false if one of
+ * them is not a point of the curve.
+ */
+bool DecompressPublicCoins(
+		const std::vector<PublicCoinKey> &publicCoins,
+		size_t from,
+		size_t to,
+		std::vector<AffinePoint> &points
+);
+
+/*
+ * Reads the cached points of the first publicCoins.size() coins of the set, there may
+ * be fewer when the set grew since the file was written. Every point is checked
+ * against its compressed coin, same x, same y parity and on the curve, which costs
+ * far less than the square root. Returns false and no points if any of them fails.
+ */
+bool ReadPointCache(
+		const std::string &path,
+		int32_t setId,
+		const std::vector<PublicCoinKey> &publicCoins,
+		std::vector<AffinePoint> &points
+);
+
+// Replaces the file with the points.
+bool WritePointCache(const std::string &path, int32_t setId, const std::vector<AffinePoint> &points);
+
+#endif //ORG_FIRO_LELANTUS_POINTCACHE_H
@@ -0,0 +1,194 @@
+#include "SerialSet.h"
+
+#include <cstdio>
+#include <cstring>
+
+// magic(4) | version(4) | record count(8), followed by 32 byte records
+static const char SERIAL_SET_MAGIC[4] = {'S', 'S', 'E', 'T'};
+static const uint32_t SERIAL_SET_VERSION = 1;
+static const long SERIAL_SET_HEADER_SIZE = 16;
+
+static const size_t SERIAL_SET_MIN_CAPACITY = 1024;
+
+static uint64_t HashSerial(const Serial &serial) {
+	// serials are already uniformly distributed, mix only to spread the low bits
+	uint64_t h;
+	memcpy(&h, serial.data() + 8, sizeof(h));
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return h;
+}
+
+static void WriteHeader(FILE *file, uint64_t count) {
+	fseek(file, 0, SEEK_SET);
+	fwrite(SERIAL_SET_MAGIC, 1, sizeof(SERIAL_SET_MAGIC), file);
+	fwrite(&SERIAL_SET_VERSION, sizeof(SERIAL_SET_VERSION), 1, file);
+	fwrite(&count, sizeof(count), 1, file);
+}
+
+bool SerialSet::Open(const std::string &filePath) {
+	Close();
+	path = filePath;
+
+	file = fopen(path.c_str(), "r+b");
+	if (file == nullptr) {
+		file = fopen(path.c_str(), "w+b");
+		if (file == nullptr) {
+			return false;
+		}
+		WriteHeader(file, 0);
+		fflush(file);
+		return true;
+	}
+
+	char magic[4];
+	uint32_t version;
+	uint64_t storedCount;
+	if (fread(magic, 1, sizeof(magic), file) != sizeof(magic)
+		|| memcmp(magic, SERIAL_SET_MAGIC, sizeof(magic)) != 0
+		|| fread(&version, sizeof(version), 1, file) != 1
+		|| version != SERIAL_SET_VERSION
+		|| fread(&storedCount, sizeof(storedCount), 1, file) != 1) {
+		// unknown or broken file, start over, serials will be fetched again
+		fclose(file);
+		file = fopen(path.c_str(), "w+b");
+		if (file == nullptr) {
+			return false;
+		}
+		WriteHeader(file, 0);
+		fflush(file);
+		return true;
+	}
+
+	// a truncated file holds fewer records than its header claims, never allocate past its end
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	uint64_t fileCount = fileSize > SERIAL_SET_HEADER_SIZE
+						 ? (uint64_t) (fileSize - SERIAL_SET_HEADER_SIZE) / sizeof(Serial) : 0;
+	if (storedCount > fileCount) {
+		storedCount = fileCount;
+	}
+	fseek(file, SERIAL_SET_HEADER_SIZE, SEEK_SET);
+
+	std::vector<Serial> serials(storedCount);
+	// records written after the last header update are ignored and overwritten later
+	size_t read = fread(serials.data(), sizeof(Serial), serials.size(), file);
+	serials.resize(read);
+	count = read;
+	for (const Serial &serial : serials) {
+		Insert(serial);
+	}
+	return true;
+}
+
+void SerialSet::Close() {
+	if (file != nullptr) {
+		fclose(file);
+		file = nullptr;
+	}
+	slots.clear();
+	occupied.clear();
+	size = 0;
+	count = 0;
+	path.clear();
+}
+
+void SerialSet::Append(const std::vector<Serial> &serials) {
+	for (const Serial &serial : serials) {
+		Insert(serial);
+	}
+
+	if (file != nullptr) {
+		fseek(file, SERIAL_SET_HEADER_SIZE + (long) (count * sizeof(Serial)), SEEK_SET);
+		fwrite(serials.data(), sizeof(Serial), serials.size(), file);
+		fflush(file);
+		WriteHeader(file, count + serials.size());
+		fflush(file);
+	}
+	count += serials.size();
+}
+
+bool SerialSet::Contains(const Serial &serial) const {
+	if (size == 0) {
+		return false;
+	}
+	return occupied[Find(serial)] != 0;
+}
+
+void SerialSet::Insert(const Serial &serial) {
+	static const Serial empty = {};
+	if (serial == empty) {
+		// placeholder of a malformed server entry
+		return;
+	}
+	// keep the load factor under 3/4
+	if ((size + 1) * 4 > slots.size() * 3) {
+		Grow();
+	}
+	size_t slot = Find(serial);
+	if (!occupied[slot]) {
+		slots[slot] = serial;
+		occupied[slot] = 1;
+		size++;
+	}
+}
+
+void SerialSet::Grow() {
+	std::vector<Serial> oldSlots;
+	std::vector<unsigned char> oldOccupied;
+	oldSlots.swap(slots);
+	oldOccupied.swap(occupied);
+
+	size_t capacity = oldSlots.empty() ? SERIAL_SET_MIN_CAPACITY : oldSlots.size() * 2;
+	slots.resize(capacity);
+	occupied.assign(capacity, 0);
+	for (size_t i = 0; i < oldSlots.size(); i++) {
+		if (oldOccupied[i]) {
+			size_t slot = Find(oldSlots[i]);
+			slots[slot] = oldSlots[i];
+			occupied[slot] = 1;
+		}
+	}
+}
+
+size_t SerialSet::Find(const Serial &serial) const {
+	// capacity is always a power of two
+	size_t mask = slots.size() - 1;
+	size_t slot = HashSerial(serial) & mask;
+	while (occupied[slot] && slots[slot] != serial) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+static int DecodeBase64Char(char c) {
+	if (c >= 'A' && c <= 'Z') return c - 'A';
+	if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+	if (c >= '0' && c <= '9') return c - '0' + 52;
+	if (c == '+') return 62;
+	if (c == '/') return 63;
+	return -1;
+}
+
+bool DecodeSerialBase64(const char *base64, Serial &out) {
+	size_t length = 0;
+	uint32_t buffer = 0;
+	int bits = 0;
+	for (const char *c = base64; *c && *c != '='; c++) {
+		int value = DecodeBase64Char(*c);
+		if (value < 0) {
+			return false;
+		}
+		buffer = (buffer << 6) | value;
+		bits += 6;
+		if (bits >= 8) {
+			bits -= 8;
+			if (length == out.size()) {
+				return false;
+			}
+			out[length++] = (buffer >> bits) & 0xff;
+		}
+	}
+	return length == out.size();
+}
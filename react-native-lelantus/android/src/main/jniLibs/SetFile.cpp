@@ -0,0 +1,128 @@
+#include "SetFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char SET_FILE_MAGIC[4] = {'A', 'S', 'E', 'T'};
+static const uint32_t SET_FILE_VERSION = 1;
+// the coin count ends the fields before the hash state
+static const size_t SET_FILE_COUNT_END = 4 + 4 + 4 + 32 + 32 + 8;
+static const size_t SET_FILE_HEADER_SIZE = SET_FILE_COUNT_END + SetHashState::SERIALIZED_SIZE;
+
+static bool WriteHeader(FILE *file, const StoredAnonymitySet &set, uint64_t count) {
+	unsigned char setHash[32];
+	unsigned char blockHash[32];
+	if (!DecodeHex(set.setHash.c_str(), setHash, sizeof(setHash))
+		|| !DecodeHex(set.blockHash.c_str(), blockHash, sizeof(blockHash))) {
+		return false;
+	}
+	unsigned char hashState[SetHashState::SERIALIZED_SIZE];
+	set.hashState.Serialize(hashState);
+	fseek(file, 0, SEEK_SET);
+	return fwrite(SET_FILE_MAGIC, 1, sizeof(SET_FILE_MAGIC), file) == sizeof(SET_FILE_MAGIC)
+		   && fwrite(&SET_FILE_VERSION, sizeof(SET_FILE_VERSION), 1, file) == 1
+		   && fwrite(&set.setId, sizeof(set.setId), 1, file) == 1
+		   && fwrite(setHash, 1, sizeof(setHash), file) == sizeof(setHash)
+		   && fwrite(blockHash, 1, sizeof(blockHash), file) == sizeof(blockHash)
+		   && fwrite(&count, sizeof(count), 1, file) == 1
+		   && fwrite(hashState, 1, sizeof(hashState), file) == sizeof(hashState);
+}
+
+SetFileView::~SetFileView() {
+	if (mapping != nullptr) {
+		munmap(mapping, size);
+	}
+}
+
+bool SetFileView::Map(const std::string &path, StoredAnonymitySet &header) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t) info.st_size < SET_FILE_HEADER_SIZE) {
+		close(fd);
+		return false;
+	}
+	size = info.st_size;
+	mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		mapping = nullptr;
+		return false;
+	}
+
+	const unsigned char *data = static_cast<const unsigned char *>(mapping);
+	uint32_t version;
+	uint64_t storedCount;
+	memcpy(&version, data + 4, sizeof(version));
+	memcpy(&storedCount, data + SET_FILE_COUNT_END - sizeof(storedCount), sizeof(storedCount));
+	if (memcmp(data, SET_FILE_MAGIC, sizeof(SET_FILE_MAGIC)) != 0
+		|| version != SET_FILE_VERSION
+		|| storedCount > (size - SET_FILE_HEADER_SIZE) / sizeof(SetCoin)) {
+		return false;
+	}
+
+	memcpy(&header.setId, data + 8, sizeof(header.setId));
+	header.setHash = EncodeHex(data + 12, 32);
+	header.blockHash = EncodeHex(data + 44, 32);
+	header.coins.clear();
+	// records past the count are a torn append
+	coins = reinterpret_cast<const SetCoin *>(data + SET_FILE_HEADER_SIZE);
+	count = storedCount;
+	return header.hashState.Deserialize(data + SET_FILE_COUNT_END);
+}
+
+bool ReadSetFile(const std::string &path, StoredAnonymitySet &set) {
+	SetFileView view;
+	if (!view.Map(path, set)) {
+		return false;
+	}
+	set.coins.assign(view.GetCoins(), view.GetCoins() + view.GetCount());
+	return true;
+}
+
+bool ReadSetFileCoin(const std::string &path, size_t position, SetCoin &coin) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	off_t offset = (off_t) (SET_FILE_HEADER_SIZE + position * sizeof(SetCoin));
+	bool read = pread(fd, &coin, sizeof(SetCoin), offset) == (ssize_t) sizeof(SetCoin);
+	close(fd);
+	return read;
+}
+
+bool WriteSetFile(const std::string &path, const StoredAnonymitySet &set) {
+	std::string temporaryPath = path + ".tmp";
+	FILE *file = fopen(temporaryPath.c_str(), "wb");
+	if (file == nullptr) {
+		return false;
+	}
+	bool written = WriteHeader(file, set, set.coins.size())
+				   && fwrite(set.coins.data(), sizeof(SetCoin), set.coins.size(), file)
+					  == set.coins.size();
+	written = fclose(file) == 0 && written;
+	if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+		remove(temporaryPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool AppendSetFile(const std::string &path, const StoredAnonymitySet &set, size_t storedCount) {
+	FILE *file = fopen(path.c_str(), "r+b");
+	if (file == nullptr) {
+		return false;
+	}
+	size_t appended = set.coins.size() - storedCount;
+	fseek(file, (long) (SET_FILE_HEADER_SIZE + storedCount * sizeof(SetCoin)), SEEK_SET);
+	bool written = fwrite(set.coins.data() + storedCount, sizeof(SetCoin), appended, file) == appended
+				   && fflush(file) == 0
+				   && WriteHeader(file, set, set.coins.size());
+	return fclose(file) == 0 && written;
+}
@@ -1,5 +1,6 @@
 #include "Utils.h"
 #include <cstring>
+#include <exception>
 #include <sstream>
 
 jstring convertToUtf8(JNIEnv *env, const char *cStringValue) {
@@ -19,6 +20,46 @@ jstring convertToUtf8(JNIEnv *env, const char *cStringValue) {
 	return str;
 }
 
+JStringArray::JStringArray(JNIEnv *env, jobjectArray jArray) : env(env) {
+	int size = env->GetArrayLength(jArray);
+	jStrings.reserve(size);
+	chars.reserve(size);
+	for (int i = 0; i < size; i++) {
+		auto jString = (jstring) (env->GetObjectArrayElement(jArray, i));
+		jStrings.push_back(jString);
+		chars.push_back(env->GetStringUTFChars(jString, nullptr));
+	}
+}
+
+JStringArray::~JStringArray() {
+	for (size_t i = 0; i < jStrings.size(); i++) {
+		env->ReleaseStringUTFChars(jStrings[i], chars[i]);
+		env->DeleteLocalRef(jStrings[i]);
+	}
+}
+
+void throwJavaException(JNIEnv *env) {
+	jclass exceptionCls = env->FindClass("java/lang/RuntimeException");
+	try {
+		throw;
+	} catch (const std::exception &e) {
+		env->ThrowNew(exceptionCls, e.what());
+	} catch (...) {
+		env->ThrowNew(exceptionCls, "Unknown native error");
+	}
+}
+
+jobjectArray toJStringArray(JNIEnv *env, const std::vector<std::string> &strings) {
+	jclass stringCls = env->FindClass("java/lang/String");
+	jobjectArray jArray = env->NewObjectArray(strings.size(), stringCls, nullptr);
+	for (size_t i = 0; i < strings.size(); i++) {
+		jstring jString = env->NewStringUTF(strings[i].c_str());
+		env->SetObjectArrayElement(jArray, i, jString);
+		env->DeleteLocalRef(jString);
+	}
+	return jArray;
+}
+
 unsigned char *hex2bin(const char *hexstr) {
 	size_t length = strlen(hexstr) / 2;
 	auto *chrs = (unsigned char *) malloc((length + 1) * sizeof(unsigned char));
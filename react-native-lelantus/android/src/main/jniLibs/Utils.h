@@ -2,6 +2,7 @@
 #define ORG_FIRO_LELANTUS_UTILS_H
 
 #include <jni.h>
+#include <string>
 #include <vector>
 
 char const hexArray[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd',
@@ -9,6 +10,35 @@ char const hexArray[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a'
 
 jstring convertToUtf8(JNIEnv *env, const char *cStringValue);
 
+/*
+ * Throws the exception being handled as a java.lang.RuntimeException with its message.
+ * Only call it from a catch block, C++ exceptions must not unwind through the JNI frames.
+ */
+void throwJavaException(JNIEnv *env);
+
+/*
+ * UTF chars of every element of a String[], released when the object goes out of scope.
+ */
+class JStringArray {
+public:
+	JStringArray(JNIEnv *env, jobjectArray jArray);
+
+	~JStringArray();
+
+	const std::vector<const char *> &get() const { return chars; }
+
+	size_t size() const { return chars.size(); }
+
+	const char *operator[](size_t i) const { return chars[i]; }
+
+private:
+	JNIEnv *env;
+	std::vector<jstring> jStrings;
+	std::vector<const char *> chars;
+};
+
+jobjectArray toJStringArray(JNIEnv *env, const std::vector<std::string> &strings);
+
 unsigned char *hex2bin(const char *str);
 
 const char *bin2hex(const unsigned char *bytes, int size);
@@ -119,15 +119,75 @@ JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateJMintScript
 	return convertToUtf8(env, script);
 }
 
-JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateSpendScript
-		(JNIEnv *env, jobject thisClass, jlong spendAmount, jboolean subtractFeeFromAmount,
-		 jstring jPrivateKey, jint index, jobjectArray jLelantusEntryList,
-		 jstring jTxHash, jintArray jSetIds, jobjectArray jAnonymitySets,
-		 jobjectArray jAnonymitySetHashes, jobjectArray jBlockGroupHashes) {
+static jobject toJMintBundle(JNIEnv *env, jclass mbCls, const MintBundle &bundle) {
+	jmethodID mbConstructor = env->GetMethodID(
+			mbCls, "<init>",
+			"(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;J)V");
+	jstring script = env->NewStringUTF(bundle.script.c_str());
+	jstring publicCoin = env->NewStringUTF(bundle.publicCoin.c_str());
+	jstring tag = env->NewStringUTF(bundle.tag.c_str());
+	jstring serialNumber = env->NewStringUTF(bundle.serialNumber.c_str());
+	jobject jBundle = env->NewObject(mbCls, mbConstructor, script, publicCoin, tag, serialNumber,
+									 (jlong) bundle.keyPath);
+	env->DeleteLocalRef(script);
+	env->DeleteLocalRef(publicCoin);
+	env->DeleteLocalRef(tag);
+	env->DeleteLocalRef(serialNumber);
+	return jBundle;
+}
+
+JNIEXPORT jobject JNICALL Java_org_firo_lelantus_Lelantus_jCreateJMintBundle
+		(JNIEnv *env, jobject thisClass, jlong value, jstring jXprv, jint index) {
+	jclass mbCls = env->FindClass("org/firo/lelantus/MintBundle");
+
+	if (mbCls == nullptr) {
+		return nullptr;
+	}
+
+	auto *xprv = env->GetStringUTFChars(jXprv, nullptr);
+	MintBundle bundle = CreateJMintBundle(value, xprv, index);
+	env->ReleaseStringUTFChars(jXprv, xprv);
+	return toJMintBundle(env, mbCls, bundle);
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jCreateMintsBatch
+		(JNIEnv *env, jobject thisClass, jstring jXprv, jintArray jIndexes, jlongArray jValues) {
+	jclass mbCls = env->FindClass("org/firo/lelantus/MintBundle");
+
+	if (mbCls == nullptr) {
+		return nullptr;
+	}
+
+	int size = env->GetArrayLength(jIndexes);
+	std::vector<int32_t> indexes(size);
+	std::vector<jlong> jValuesVector(size);
+	env->GetIntArrayRegion(jIndexes, 0, size, indexes.data());
+	env->GetLongArrayRegion(jValues, 0, size, jValuesVector.data());
+	std::vector<uint64_t> values(jValuesVector.begin(), jValuesVector.end());
+
+	auto *xprv = env->GetStringUTFChars(jXprv, nullptr);
+	std::vector<MintBundle> bundles = CreateMintsBatch(xprv, indexes, values);
+	env->ReleaseStringUTFChars(jXprv, xprv);
+
+	jobjectArray result = env->NewObjectArray(bundles.size(), mbCls, nullptr);
+	for (size_t i = 0; i < bundles.size(); i++) {
+		jobject jBundle = toJMintBundle(env, mbCls, bundles[i]);
+		env->SetObjectArrayElement(result, i, jBundle);
+		env->DeleteLocalRef(jBundle);
+	}
+	return result;
+}
+
+// Reads the LelantusEntry objects, false if the class is missing.
+static bool ReadLelantusEntries(
+		JNIEnv *env,
+		jobjectArray jLelantusEntryList,
+		std::list<LelantusEntry> &coins
+) {
 	jclass leCls = env->FindClass("org/firo/lelantus/LelantusEntry");
 
 	if (leCls == nullptr) {
-		return nullptr;
+		return false;
 	}
 
 	jmethodID leGetAmountId = env->GetMethodID(leCls, "getAmount", "()J");
@@ -137,7 +197,6 @@ JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateSpendScript
 	jmethodID leGetHeightId = env->GetMethodID(leCls, "getHeight", "()I");
 	jmethodID leGetAnonymitySetIdId = env->GetMethodID(leCls, "getAnonymitySetId", "()I");
 
-	std::list<LelantusEntry> coins;
 	int coinIndex, height, anonymitySetId;
 	jstring keydata;
 	long amount;
@@ -157,54 +216,68 @@ JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateSpendScript
 		coins.push_back(lelantusEntry);
 		env->DeleteLocalRef(mintCoin);
 	}
+	return true;
+}
+
+JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateSpendScript
+		(JNIEnv *env, jobject thisClass, jlong spendAmount, jboolean subtractFeeFromAmount,
+		 jlong fee, jstring jPrivateKey, jint index, jobjectArray jLelantusEntryList,
+		 jstring jTxHash) {
+	std::list<LelantusEntry> coins;
+	if (!ReadLelantusEntries(env, jLelantusEntryList, coins)) {
+		return nullptr;
+	}
 
 	auto *privateKey = env->GetStringUTFChars(jPrivateKey, nullptr);
 	auto *txHash = env->GetStringUTFChars(jTxHash, nullptr);
 
-	std::vector<uint32_t> setIds;
-	std::vector<std::vector<const char *>> anonymitySets;
-	std::vector<const char *> anonymitySetHashes;
-	std::vector<const char *> groupBlockHashes;
-
-	int setIdsSize = env->GetArrayLength(jSetIds);
-	jint *idList = env->GetIntArrayElements(jSetIds, nullptr);
-	for (int i = 0; i < setIdsSize; i++) {
-		setIds.push_back(idList[i]);
-
-		anonymitySets.emplace_back(std::vector<const char *>());
-		auto jAnonymitySet = (jobjectArray) (env->GetObjectArrayElement(jAnonymitySets, i));
-		int anonymitySetSize = env->GetArrayLength(jAnonymitySet);
-		for (int j = 0; j < anonymitySetSize; j++) {
-			auto jSerializedCoin = (jstring) (env->GetObjectArrayElement(jAnonymitySet, j));
-			const char *serializedCoin = env->GetStringUTFChars(jSerializedCoin, nullptr);
-			anonymitySets[i].push_back(serializedCoin);
-			env->DeleteLocalRef(jSerializedCoin);
-		}
-
-		auto jAnonymitySetHash = (jstring) (env->GetObjectArrayElement(jAnonymitySetHashes, i));
-		const char *setHash = env->GetStringUTFChars(jAnonymitySetHash, nullptr);
-		anonymitySetHashes.push_back(setHash);
-		env->DeleteLocalRef(jAnonymitySetHash);
-
-		auto jGroupBlockHash = (jstring) (env->GetObjectArrayElement(jBlockGroupHashes, i));
-		const char *groupBlockHash = env->GetStringUTFChars(jGroupBlockHash, nullptr);
-		groupBlockHashes.push_back(groupBlockHash);
-		env->DeleteLocalRef(jGroupBlockHash);
-	}
-
-	const char *script = CreateJoinSplitScript(
-			txHash,
-			spendAmount,
-			subtractFeeFromAmount,
-			privateKey,
-			index,
-			coins,
-			setIds,
-			anonymitySets,
-			anonymitySetHashes,
-			groupBlockHashes
-	);
-	return convertToUtf8(env, script);
+	try {
+		const char *script = CreateJoinSplitScript(
+				txHash,
+				spendAmount,
+				subtractFeeFromAmount,
+				fee,
+				privateKey,
+				index,
+				coins
+		);
+		return convertToUtf8(env, script);
+	} catch (...) {
+		throwJavaException(env);
+		return nullptr;
+	}
+}
+
+JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateMultiRecipientSpendScript
+		(JNIEnv *env, jobject thisClass, jlongArray jOutputValues, jlong fee, jstring jPrivateKey,
+		 jint index, jobjectArray jLelantusEntryList, jstring jTxHash) {
+	std::list<LelantusEntry> coins;
+	if (!ReadLelantusEntries(env, jLelantusEntryList, coins)) {
+		return nullptr;
+	}
+
+	int size = env->GetArrayLength(jOutputValues);
+	std::vector<jlong> jOutputValuesVector(size);
+	env->GetLongArrayRegion(jOutputValues, 0, size, jOutputValuesVector.data());
+	std::vector<uint64_t> outputValues(jOutputValuesVector.begin(), jOutputValuesVector.end());
+
+	auto *privateKey = env->GetStringUTFChars(jPrivateKey, nullptr);
+	auto *txHash = env->GetStringUTFChars(jTxHash, nullptr);
+
+	try {
+		const char *script = CreateMultiRecipientJoinSplitScript(
+				txHash,
+				outputValues,
+				fee,
+				privateKey,
+				index,
+				coins
+		);
+		return convertToUtf8(env, script);
+	} catch (...) {
+		throwJavaException(env);
+		return nullptr;
+	}
 }
 
 JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jDecryptMintAmount
@@ -215,4 +288,487 @@ JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jDecryptMintAmount
 	return amount;
 }
 
-}
\ No newline at end of file
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jCreateTagBatch
+		(JNIEnv *env, jobject thisClass, jstring jXprv, jint startIndex, jint count) {
+	auto *xprv = env->GetStringUTFChars(jXprv, nullptr);
+	std::vector<std::string> tags = CreateTagBatch(xprv, startIndex, count);
+	env->ReleaseStringUTFChars(jXprv, xprv);
+	return toJStringArray(env, tags);
+}
+
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jOpenUsedSerialSet
+		(JNIEnv *env, jobject thisClass, jstring jPath) {
+	auto *path = env->GetStringUTFChars(jPath, nullptr);
+	uint64_t count = OpenUsedSerialSet(path);
+	env->ReleaseStringUTFChars(jPath, path);
+	return count;
+}
+
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jAppendUsedSerials
+		(JNIEnv *env, jobject thisClass, jobjectArray jSerials) {
+	JStringArray serials(env, jSerials);
+	return AppendUsedSerials(serials.get());
+}
+
+JNIEXPORT jobject JNICALL Java_org_firo_lelantus_Lelantus_jGetAnonymitySetInfo
+		(JNIEnv *env, jobject thisClass, jint setId) {
+	jclass asiCls = env->FindClass("org/firo/lelantus/AnonymitySetInfo");
+
+	if (asiCls == nullptr) {
+		return nullptr;
+	}
+
+	jmethodID asiConstructor = env->GetMethodID(
+			asiCls, "<init>", "(Ljava/lang/String;Ljava/lang/String;I)V");
+
+	std::string setHash;
+	std::string blockHash;
+	size_t size = GetAnonymitySetInfo(setId, setHash, blockHash);
+	return env->NewObject(asiCls, asiConstructor,
+						  env->NewStringUTF(setHash.c_str()),
+						  env->NewStringUTF(blockHash.c_str()),
+						  (jint) size);
+}
+
+JNIEXPORT jlongArray JNICALL Java_org_firo_lelantus_Lelantus_jMergeAnonymitySetResponse
+		(JNIEnv *env, jobject thisClass, jint setId, jstring jResponse) {
+	// the response is plain ASCII, so its modified UTF-8 form is the JSON text itself
+	auto *response = env->GetStringUTFChars(jResponse, nullptr);
+	jsize length = env->GetStringUTFLength(jResponse);
+	SetCoinRange range;
+	bool merged = MergeAnonymitySetResponse(setId, response, length, range);
+	env->ReleaseStringUTFChars(jResponse, response);
+
+	if (!merged) {
+		return nullptr;
+	}
+	jlong values[] = {(jlong) range.first, (jlong) range.count};
+	jlongArray jRange = env->NewLongArray(2);
+	env->SetLongArrayRegion(jRange, 0, 2, values);
+	return jRange;
+}
+
+JNIEXPORT void JNICALL Java_org_firo_lelantus_Lelantus_jUpdateAnonymitySet
+		(JNIEnv *env, jobject thisClass, jint setId, jstring jSetHash, jstring jBlockHash,
+		 jobjectArray jPublicCoins, jobjectArray jTags, jlongArray jValues,
+		 jobjectArray jEncryptedValues, jobjectArray jTxIds) {
+	JStringArray publicCoins(env, jPublicCoins);
+	JStringArray tags(env, jTags);
+	JStringArray encryptedValues(env, jEncryptedValues);
+	JStringArray txIds(env, jTxIds);
+	std::vector<jlong> values(publicCoins.size());
+	env->GetLongArrayRegion(jValues, 0, values.size(), values.data());
+
+	std::vector<SetCoin> coins(publicCoins.size());
+	bool valid = true;
+	for (size_t i = 0; i < publicCoins.size(); i++) {
+		bool isJMint = encryptedValues[i][0] != '\0';
+		valid = MakeSetCoin(publicCoins[i], tags[i], isJMint, (uint64_t) values[i],
+							encryptedValues[i], txIds[i], coins[i]) && valid;
+	}
+
+	auto *setHash = env->GetStringUTFChars(jSetHash, nullptr);
+	auto *blockHash = env->GetStringUTFChars(jBlockHash, nullptr);
+	// a malformed set is not stored, it is pushed again with the next sync
+	if (valid) {
+		UpdateAnonymitySet(setId, setHash, blockHash, std::move(coins));
+	}
+	env->ReleaseStringUTFChars(jSetHash, setHash);
+	env->ReleaseStringUTFChars(jBlockHash, blockHash);
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jScanMints
+		(JNIEnv *env, jobject thisClass, jstring jXprv, jint startIndex, jint gapLimit) {
+	jclass smCls = env->FindClass("org/firo/lelantus/ScannedMint");
+
+	if (smCls == nullptr) {
+		return nullptr;
+	}
+
+	jmethodID smConstructor = env->GetMethodID(
+			smCls, "<init>", "(IJLjava/lang/String;Ljava/lang/String;IZZ)V");
+
+	auto *xprv = env->GetStringUTFChars(jXprv, nullptr);
+	std::vector<ScannedMint> mints = ScanMints(xprv, startIndex, gapLimit);
+	env->ReleaseStringUTFChars(jXprv, xprv);
+
+	jobjectArray result = env->NewObjectArray(mints.size(), smCls, nullptr);
+	for (size_t i = 0; i < mints.size(); i++) {
+		const ScannedMint &mint = mints[i];
+		jstring publicCoin = env->NewStringUTF(mint.publicCoin.c_str());
+		jstring txId = env->NewStringUTF(mint.txId.c_str());
+		jobject jMint = env->NewObject(smCls, smConstructor, (jint) mint.index,
+									   (jlong) mint.value, publicCoin, txId,
+									   (jint) mint.anonymitySetId, (jboolean) mint.isJMint,
+									   (jboolean) mint.isUsed);
+		env->SetObjectArrayElement(result, i, jMint);
+		env->DeleteLocalRef(jMint);
+		env->DeleteLocalRef(publicCoin);
+		env->DeleteLocalRef(txId);
+	}
+	return result;
+}
+
+JNIEXPORT jobject JNICALL Java_org_firo_lelantus_Lelantus_jSelectSpendCoins
+		(JNIEnv *env, jobject thisClass, jlongArray jAmounts, jintArray jSetIds,
+		 jintArray jHeights, jlong spendAmount, jboolean subtractFeeFromAmount, jint strategy,
+		 jint outputCount) {
+	jclass jsdCls = env->FindClass("org/firo/lelantus/JoinSplitData");
+
+	if (jsdCls == nullptr) {
+		return nullptr;
+	}
+
+	jmethodID jsdConstructor = env->GetMethodID(jsdCls, "<init>", "(JJ[I)V");
+
+	int size = env->GetArrayLength(jAmounts);
+	std::vector<jlong> amounts(size);
+	std::vector<jint> setIds(size);
+	std::vector<jint> heights(size);
+	env->GetLongArrayRegion(jAmounts, 0, size, amounts.data());
+	env->GetIntArrayRegion(jSetIds, 0, size, setIds.data());
+	env->GetIntArrayRegion(jHeights, 0, size, heights.data());
+
+	std::vector<SelectionCoin> coins;
+	coins.reserve(size);
+	for (int i = 0; i < size; i++) {
+		coins.push_back({(uint64_t) amounts[i], setIds[i], heights[i]});
+	}
+
+	uint64_t fee, changeToMint;
+	std::vector<int32_t> positions = SelectSpendCoins(coins, spendAmount, subtractFeeFromAmount,
+													  strategy, outputCount, fee, changeToMint);
+
+	jintArray jPositions = env->NewIntArray(positions.size());
+	env->SetIntArrayRegion(jPositions, 0, positions.size(), (jint *) positions.data());
+	return env->NewObject(jsdCls, jsdConstructor, (jlong) fee, (jlong) changeToMint, jPositions);
+}
+
+JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jBenchmarkCoinSelection
+		(JNIEnv *env, jobject thisClass, jint coinCount, jint rounds) {
+	std::string report = BenchmarkCoinSelection(coinCount, rounds);
+	return env->NewStringUTF(report.c_str());
+}
+
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jQuickEstimateFee
+		(JNIEnv *env, jobject thisClass, jlongArray jAmounts, jintArray jSetIds,
+		 jlong spendAmount, jboolean subtractFeeFromAmount) {
+	int size = env->GetArrayLength(jAmounts);
+	std::vector<jlong> jAmountsVector(size);
+	std::vector<int32_t> setIds(size);
+	env->GetLongArrayRegion(jAmounts, 0, size, jAmountsVector.data());
+	env->GetIntArrayRegion(jSetIds, 0, size, setIds.data());
+	std::vector<uint64_t> amounts(jAmountsVector.begin(), jAmountsVector.end());
+
+	return QuickEstimateFee(amounts, setIds, spendAmount, subtractFeeFromAmount);
+}
+
+JNIEXPORT jlongArray JNICALL Java_org_firo_lelantus_Lelantus_jGetSpendProvingCost
+		(JNIEnv *env, jobject thisClass, jintArray jSetIds) {
+	int size = env->GetArrayLength(jSetIds);
+	std::vector<int32_t> setIds(size);
+	env->GetIntArrayRegion(jSetIds, 0, size, setIds.data());
+
+	ProvingCost cost = GetSpendProvingCost(setIds);
+	jlong values[] = {(jlong) cost.deserializedPoints, (jlong) cost.provedPoints,
+					  (jlong) cost.setBytes};
+	jlongArray jCost = env->NewLongArray(3);
+	env->SetLongArrayRegion(jCost, 0, 3, values);
+	return jCost;
+}
+
+
+JNIEXPORT jintArray JNICALL Java_org_firo_lelantus_Lelantus_jOpenAnonymitySetStore
+		(JNIEnv *env, jobject thisClass, jstring jDirectory, jint memoryBudgetMb) {
+	auto *directory = env->GetStringUTFChars(jDirectory, nullptr);
+	std::vector<int32_t> setIds = OpenAnonymitySetStore(directory, memoryBudgetMb);
+	env->ReleaseStringUTFChars(jDirectory, directory);
+
+	jintArray jSetIds = env->NewIntArray(setIds.size());
+	env->SetIntArrayRegion(jSetIds, 0, setIds.size(), (jint *) setIds.data());
+	return jSetIds;
+}
+
+JNIEXPORT jbooleanArray JNICALL Java_org_firo_lelantus_Lelantus_jContainsMintTags
+		(JNIEnv *env, jobject thisClass, jobjectArray jTags) {
+	JStringArray tags(env, jTags);
+	std::vector<bool> contains = ContainsMintTags(tags.get());
+
+	std::vector<jboolean> result(contains.begin(), contains.end());
+	jbooleanArray jContains = env->NewBooleanArray(result.size());
+	env->SetBooleanArrayRegion(jContains, 0, result.size(), result.data());
+	return jContains;
+}
+
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jCacheAnonymitySetPoints
+		(JNIEnv *env, jobject thisClass, jintArray jSetIds) {
+	int size = env->GetArrayLength(jSetIds);
+	std::vector<int32_t> setIds(size);
+	env->GetIntArrayRegion(jSetIds, 0, size, setIds.data());
+	return CacheAnonymitySetPoints(setIds);
+}
+
+JNIEXPORT void JNICALL Java_org_firo_lelantus_Lelantus_jStartSpendPrewarm
+		(JNIEnv *env, jobject thisClass, jintArray jSetIds) {
+	int size = env->GetArrayLength(jSetIds);
+	std::vector<int32_t> setIds(size);
+	env->GetIntArrayRegion(jSetIds, 0, size, setIds.data());
+	StartSpendPrewarm(setIds);
+}
+
+JNIEXPORT void JNICALL Java_org_firo_lelantus_Lelantus_jStartSpeculativeSpend
+		(JNIEnv *env, jobject thisClass, jlong spendAmount, jboolean subtractFeeFromAmount,
+		 jlong fee, jstring jPrivateKey, jint index, jobjectArray jLelantusEntryList,
+		 jstring jTxHash) {
+	std::list<LelantusEntry> coins;
+	if (!ReadLelantusEntries(env, jLelantusEntryList, coins)) {
+		return;
+	}
+
+	auto *privateKey = env->GetStringUTFChars(jPrivateKey, nullptr);
+	auto *txHash = env->GetStringUTFChars(jTxHash, nullptr);
+
+	try {
+		StartSpeculativeSpend(
+				txHash,
+				spendAmount,
+				subtractFeeFromAmount,
+				fee,
+				privateKey,
+				index,
+				coins
+		);
+	} catch (...) {
+		throwJavaException(env);
+	}
+	env->ReleaseStringUTFChars(jPrivateKey, privateKey);
+	env->ReleaseStringUTFChars(jTxHash, txHash);
+}
+
+JNIEXPORT void JNICALL Java_org_firo_lelantus_Lelantus_jDiscardSpeculativeSpend
+		(JNIEnv *env, jobject thisClass) {
+	DiscardSpeculativeSpend();
+}
+
+// Reads the LelantusCoin objects, false if the class is missing.
+static bool ReadWalletCoins(JNIEnv *env, jobjectArray jCoins, std::vector<StoredCoin> &coins) {
+	jclass lcCls = env->FindClass("org/firo/lelantus/LelantusCoin");
+
+	if (lcCls == nullptr) {
+		return false;
+	}
+
+	jmethodID lcGetIndexId = env->GetMethodID(lcCls, "getIndex", "()I");
+	jmethodID lcGetValueId = env->GetMethodID(lcCls, "getValue", "()J");
+	jmethodID lcGetPublicCoinId = env->GetMethodID(lcCls, "getPublicCoin", "()Ljava/lang/String;");
+	jmethodID lcGetTxIdId = env->GetMethodID(lcCls, "getTxId", "()Ljava/lang/String;");
+	jmethodID lcGetAnonymitySetIdId = env->GetMethodID(lcCls, "getAnonymitySetId", "()I");
+	jmethodID lcIsUsedId = env->GetMethodID(lcCls, "isUsed", "()Z");
+
+	int coinCount = env->GetArrayLength(jCoins);
+	coins.resize(coinCount);
+	for (int i = 0; i < coinCount; ++i) {
+		jobject jCoin = env->GetObjectArrayElement(jCoins, i);
+		auto jPublicCoin = (jstring) env->CallObjectMethod(jCoin, lcGetPublicCoinId);
+		auto jTxId = (jstring) env->CallObjectMethod(jCoin, lcGetTxIdId);
+		auto *publicCoin = env->GetStringUTFChars(jPublicCoin, nullptr);
+		auto *txId = env->GetStringUTFChars(jTxId, nullptr);
+
+		StoredCoin &coin = coins[i];
+		coin.index = env->CallIntMethod(jCoin, lcGetIndexId);
+		coin.value = env->CallLongMethod(jCoin, lcGetValueId);
+		coin.publicCoin = publicCoin;
+		coin.txId = txId;
+		coin.setId = env->CallIntMethod(jCoin, lcGetAnonymitySetIdId);
+		coin.isUsed = env->CallBooleanMethod(jCoin, lcIsUsedId);
+
+		env->ReleaseStringUTFChars(jPublicCoin, publicCoin);
+		env->ReleaseStringUTFChars(jTxId, txId);
+		env->DeleteLocalRef(jPublicCoin);
+		env->DeleteLocalRef(jTxId);
+		env->DeleteLocalRef(jCoin);
+	}
+	return true;
+}
+
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jLoadWalletCoins
+		(JNIEnv *env, jobject thisClass, jobjectArray jCoins) {
+	std::vector<StoredCoin> coins;
+	if (!ReadWalletCoins(env, jCoins, coins)) {
+		return 0;
+	}
+	return LoadWalletCoins(coins);
+}
+
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jPutWalletCoins
+		(JNIEnv *env, jobject thisClass, jobjectArray jCoins) {
+	std::vector<StoredCoin> coins;
+	if (!ReadWalletCoins(env, jCoins, coins)) {
+		return 0;
+	}
+	return PutWalletCoins(coins);
+}
+
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jMarkWalletCoinsUsed
+		(JNIEnv *env, jobject thisClass, jintArray jIndexes) {
+	int size = env->GetArrayLength(jIndexes);
+	std::vector<int32_t> indexes(size);
+	env->GetIntArrayRegion(jIndexes, 0, size, indexes.data());
+	return MarkWalletCoinsUsed(indexes);
+}
+
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jMarkSpentWalletCoins
+		(JNIEnv *env, jobject thisClass, jstring jXprv) {
+	auto *xprv = env->GetStringUTFChars(jXprv, nullptr);
+	size_t marked = MarkSpentWalletCoins(xprv);
+	env->ReleaseStringUTFChars(jXprv, xprv);
+	return marked;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jUpdateWalletCoinSetIds
+		(JNIEnv *env, jobject thisClass) {
+	return toJStringArray(env, UpdateWalletCoinSetIds());
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jGetWalletCoins
+		(JNIEnv *env, jobject thisClass, jint filter) {
+	jclass lcCls = env->FindClass("org/firo/lelantus/LelantusCoin");
+
+	if (lcCls == nullptr) {
+		return nullptr;
+	}
+
+	jmethodID lcConstructor = env->GetMethodID(
+			lcCls, "<init>", "(IJLjava/lang/String;Ljava/lang/String;IZ)V");
+
+	std::vector<StoredCoin> coins = GetWalletCoins(filter);
+	jobjectArray result = env->NewObjectArray(coins.size(), lcCls, nullptr);
+	for (size_t i = 0; i < coins.size(); i++) {
+		const StoredCoin &coin = coins[i];
+		jstring publicCoin = env->NewStringUTF(coin.publicCoin.c_str());
+		jstring txId = env->NewStringUTF(coin.txId.c_str());
+		jobject jCoin = env->NewObject(lcCls, lcConstructor, (jint) coin.index,
+									   (jlong) coin.value, publicCoin, txId,
+									   (jint) coin.setId, (jboolean) coin.isUsed);
+		env->SetObjectArrayElement(result, i, jCoin);
+		env->DeleteLocalRef(jCoin);
+		env->DeleteLocalRef(publicCoin);
+		env->DeleteLocalRef(txId);
+	}
+	return result;
+}
+
+JNIEXPORT jintArray JNICALL Java_org_firo_lelantus_Lelantus_jGetUnspentCoinSetIds
+		(JNIEnv *env, jobject thisClass) {
+	std::vector<int32_t> setIds = GetUnspentCoinSetIds();
+	jintArray jSetIds = env->NewIntArray(setIds.size());
+	env->SetIntArrayRegion(jSetIds, 0, setIds.size(), (jint *) setIds.data());
+	return jSetIds;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jParseJoinSplits
+		(JNIEnv *env, jobject thisClass, jobjectArray jRawTxs) {
+	jclass pjCls = env->FindClass("org/firo/lelantus/ParsedJoinSplit");
+
+	if (pjCls == nullptr) {
+		return nullptr;
+	}
+
+	jmethodID pjConstructor = env->GetMethodID(
+			pjCls, "<init>",
+			"(ZJ[Ljava/lang/String;[I[Ljava/lang/String;[Ljava/lang/String;)V");
+
+	JStringArray rawTxChars(env, jRawTxs);
+	std::vector<std::string> rawTxs(rawTxChars.get().begin(), rawTxChars.get().end());
+
+	std::vector<ParsedJoinSplit> joinSplits = ParseJoinSplits(rawTxs);
+	jobjectArray result = env->NewObjectArray(joinSplits.size(), pjCls, nullptr);
+	for (size_t i = 0; i < joinSplits.size(); i++) {
+		const ParsedJoinSplit &joinSplit = joinSplits[i];
+		jobjectArray serialNumbers = toJStringArray(env, joinSplit.serialNumbers);
+		jintArray spentCoinIndexes = env->NewIntArray(joinSplit.spentCoinIndexes.size());
+		env->SetIntArrayRegion(spentCoinIndexes, 0, joinSplit.spentCoinIndexes.size(),
+							   (jint *) joinSplit.spentCoinIndexes.data());
+		jobjectArray publicCoins = toJStringArray(env, joinSplit.publicCoins);
+		jobjectArray encryptedValues = toJStringArray(env, joinSplit.encryptedValues);
+		jobject jJoinSplit = env->NewObject(pjCls, pjConstructor, (jboolean) joinSplit.valid,
+											(jlong) joinSplit.fee, serialNumbers, spentCoinIndexes,
+											publicCoins, encryptedValues);
+		env->SetObjectArrayElement(result, i, jJoinSplit);
+		env->DeleteLocalRef(jJoinSplit);
+		env->DeleteLocalRef(serialNumbers);
+		env->DeleteLocalRef(spentCoinIndexes);
+		env->DeleteLocalRef(publicCoins);
+		env->DeleteLocalRef(encryptedValues);
+	}
+	return result;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jPlanConsolidation
+		(JNIEnv *env, jobject thisClass, jlongArray jAmounts, jintArray jSetIds, jint minCoins,
+		 jint maxInputs) {
+	jclass csCls = env->FindClass("org/firo/lelantus/ConsolidationStep");
+
+	if (csCls == nullptr) {
+		return nullptr;
+	}
+
+	jmethodID csConstructor = env->GetMethodID(csCls, "<init>", "([IIJJJJJ)V");
+
+	int size = env->GetArrayLength(jAmounts);
+	std::vector<jlong> amounts(size);
+	std::vector<jint> setIds(size);
+	env->GetLongArrayRegion(jAmounts, 0, size, amounts.data());
+	env->GetIntArrayRegion(jSetIds, 0, size, setIds.data());
+
+	std::vector<SelectionCoin> coins;
+	coins.reserve(size);
+	for (int i = 0; i < size; i++) {
+		coins.push_back({(uint64_t) amounts[i], setIds[i], 0});
+	}
+
+	std::vector<ConsolidationStep> steps = PlanWalletConsolidation(coins, minCoins, maxInputs);
+	jobjectArray result = env->NewObjectArray(steps.size(), csCls, nullptr);
+	for (size_t i = 0; i < steps.size(); i++) {
+		const ConsolidationStep &step = steps[i];
+		std::vector<jint> positions(step.selected.begin(), step.selected.end());
+		jintArray jPositions = env->NewIntArray(positions.size());
+		env->SetIntArrayRegion(jPositions, 0, positions.size(), positions.data());
+		jobject jStep = env->NewObject(csCls, csConstructor, jPositions, (jint) step.anonymitySetId,
+									   (jlong) step.fee, (jlong) step.mintValue,
+									   (jlong) step.provingCost.deserializedPoints,
+									   (jlong) step.provingCost.provedPoints,
+									   (jlong) step.provingCost.setBytes);
+		env->SetObjectArrayElement(result, i, jStep);
+		env->DeleteLocalRef(jStep);
+		env->DeleteLocalRef(jPositions);
+	}
+	return result;
+}
+
+JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateConsolidationScript
+		(JNIEnv *env, jobject thisClass, jstring jPrivateKey, jint index,
+		 jobjectArray jLelantusEntryList, jstring jTxHash) {
+	std::list<LelantusEntry> coins;
+	if (!ReadLelantusEntries(env, jLelantusEntryList, coins)) {
+		return nullptr;
+	}
+
+	auto *privateKey = env->GetStringUTFChars(jPrivateKey, nullptr);
+	auto *txHash = env->GetStringUTFChars(jTxHash, nullptr);
+
+	try {
+		const char *script = CreateConsolidationScript(
+				txHash,
+				privateKey,
+				index,
+				coins
+		);
+		return convertToUtf8(env, script);
+	} catch (...) {
+		throwJavaException(env);
+		return nullptr;
+	}
+}
+
+}
@@ -72,14 +72,29 @@ JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jGetAesKeyPath
 JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateJMintScript
 		(JNIEnv *, jobject, jlong, jstring, jint, jstring, jstring);
 
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jCreateJMintBundle
+* Signature: (JLjava/lang/String;I)Lorg/firo/lelantus/MintBundle;
+*/
+JNIEXPORT jobject JNICALL Java_org_firo_lelantus_Lelantus_jCreateJMintBundle
+		(JNIEnv *, jobject, jlong, jstring, jint);
+
 /*
 * Class:     org_firo_lelantus_Lelantus
 * Method:    jCreateSpendScript
-* Signature: (JJJJJJ[J[J[J[J)J
+* Signature: (JZJLjava/lang/String;I[Lorg/firo/lelantus/LelantusEntry;Ljava/lang/String;)Ljava/lang/String;
 */
 JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateSpendScript
-		(JNIEnv *, jobject, jlong, jboolean, jstring, jint, jobjectArray, jstring, jintArray,
-		 jobjectArray, jobjectArray, jobjectArray);
+		(JNIEnv *, jobject, jlong, jboolean, jlong, jstring, jint, jobjectArray, jstring);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jCreateMultiRecipientSpendScript
+* Signature: ([JJLjava/lang/String;I[Lorg/firo/lelantus/LelantusEntry;Ljava/lang/String;)Ljava/lang/String;
+*/
+JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateMultiRecipientSpendScript
+		(JNIEnv *, jobject, jlongArray, jlong, jstring, jint, jobjectArray, jstring);
 
 /*
 * Class:     org_firo_lelantus_Lelantus
@@ -89,6 +104,231 @@ JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateSpendScript
 JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jDecryptMintAmount
 		(JNIEnv *, jobject, jstring, jstring);
 
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jCreateTagBatch
+* Signature: (Ljava/lang/String;II)[Ljava/lang/String;
+*/
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jCreateTagBatch
+		(JNIEnv *, jobject, jstring, jint, jint);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jCreateMintsBatch
+* Signature: (Ljava/lang/String;[I[J)[Lorg/firo/lelantus/MintBundle;
+*/
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jCreateMintsBatch
+		(JNIEnv *, jobject, jstring, jintArray, jlongArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jOpenUsedSerialSet
+* Signature: (Ljava/lang/String;)J
+*/
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jOpenUsedSerialSet
+		(JNIEnv *, jobject, jstring);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jAppendUsedSerials
+* Signature: ([Ljava/lang/String;)J
+*/
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jAppendUsedSerials
+		(JNIEnv *, jobject, jobjectArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jGetAnonymitySetInfo
+* Signature: (I)Lorg/firo/lelantus/AnonymitySetInfo;
+*/
+JNIEXPORT jobject JNICALL Java_org_firo_lelantus_Lelantus_jGetAnonymitySetInfo
+		(JNIEnv *, jobject, jint);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jMergeAnonymitySetResponse
+* Signature: (ILjava/lang/String;)[J
+*/
+JNIEXPORT jlongArray JNICALL Java_org_firo_lelantus_Lelantus_jMergeAnonymitySetResponse
+		(JNIEnv *, jobject, jint, jstring);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jUpdateAnonymitySet
+* Signature: (ILjava/lang/String;Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;[J[Ljava/lang/String;[Ljava/lang/String;)V
+*/
+JNIEXPORT void JNICALL Java_org_firo_lelantus_Lelantus_jUpdateAnonymitySet
+		(JNIEnv *, jobject, jint, jstring, jstring, jobjectArray, jobjectArray, jlongArray,
+		 jobjectArray, jobjectArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jScanMints
+* Signature: (Ljava/lang/String;II)[Lorg/firo/lelantus/ScannedMint;
+*/
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jScanMints
+		(JNIEnv *, jobject, jstring, jint, jint);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jSelectSpendCoins
+* Signature: ([J[I[IJZII)Lorg/firo/lelantus/JoinSplitData;
+*/
+JNIEXPORT jobject JNICALL Java_org_firo_lelantus_Lelantus_jSelectSpendCoins
+		(JNIEnv *, jobject, jlongArray, jintArray, jintArray, jlong, jboolean, jint, jint);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jBenchmarkCoinSelection
+* Signature: (II)Ljava/lang/String;
+*/
+JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jBenchmarkCoinSelection
+		(JNIEnv *, jobject, jint, jint);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jQuickEstimateFee
+* Signature: ([J[IJZ)J
+*/
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jQuickEstimateFee
+		(JNIEnv *, jobject, jlongArray, jintArray, jlong, jboolean);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jGetSpendProvingCost
+* Signature: ([I)[J
+*/
+JNIEXPORT jlongArray JNICALL Java_org_firo_lelantus_Lelantus_jGetSpendProvingCost
+		(JNIEnv *, jobject, jintArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jOpenAnonymitySetStore
+* Signature: (Ljava/lang/String;I)[I
+*/
+JNIEXPORT jintArray JNICALL Java_org_firo_lelantus_Lelantus_jOpenAnonymitySetStore
+		(JNIEnv *, jobject, jstring, jint);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jContainsMintTags
+* Signature: ([Ljava/lang/String;)[Z
+*/
+JNIEXPORT jbooleanArray JNICALL Java_org_firo_lelantus_Lelantus_jContainsMintTags
+		(JNIEnv *, jobject, jobjectArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jCacheAnonymitySetPoints
+* Signature: ([I)J
+*/
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jCacheAnonymitySetPoints
+		(JNIEnv *, jobject, jintArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jStartSpendPrewarm
+* Signature: ([I)V
+*/
+JNIEXPORT void JNICALL Java_org_firo_lelantus_Lelantus_jStartSpendPrewarm
+		(JNIEnv *, jobject, jintArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jStartSpeculativeSpend
+* Signature: (JZJLjava/lang/String;I[Lorg/firo/lelantus/LelantusEntry;Ljava/lang/String;)V
+*/
+JNIEXPORT void JNICALL Java_org_firo_lelantus_Lelantus_jStartSpeculativeSpend
+		(JNIEnv *, jobject, jlong, jboolean, jlong, jstring, jint, jobjectArray, jstring);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jDiscardSpeculativeSpend
+* Signature: ()V
+*/
+JNIEXPORT void JNICALL Java_org_firo_lelantus_Lelantus_jDiscardSpeculativeSpend
+		(JNIEnv *, jobject);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jLoadWalletCoins
+* Signature: ([Lorg/firo/lelantus/LelantusCoin;)J
+*/
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jLoadWalletCoins
+		(JNIEnv *, jobject, jobjectArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jPutWalletCoins
+* Signature: ([Lorg/firo/lelantus/LelantusCoin;)J
+*/
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jPutWalletCoins
+		(JNIEnv *, jobject, jobjectArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jMarkWalletCoinsUsed
+* Signature: ([I)J
+*/
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jMarkWalletCoinsUsed
+		(JNIEnv *, jobject, jintArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jMarkSpentWalletCoins
+* Signature: (Ljava/lang/String;)J
+*/
+JNIEXPORT jlong JNICALL Java_org_firo_lelantus_Lelantus_jMarkSpentWalletCoins
+		(JNIEnv *, jobject, jstring);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jUpdateWalletCoinSetIds
+* Signature: ()[Ljava/lang/String;
+*/
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jUpdateWalletCoinSetIds
+		(JNIEnv *, jobject);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jGetWalletCoins
+* Signature: (I)[Lorg/firo/lelantus/LelantusCoin;
+*/
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jGetWalletCoins
+		(JNIEnv *, jobject, jint);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jGetUnspentCoinSetIds
+* Signature: ()[I
+*/
+JNIEXPORT jintArray JNICALL Java_org_firo_lelantus_Lelantus_jGetUnspentCoinSetIds
+		(JNIEnv *, jobject);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jParseJoinSplits
+* Signature: ([Ljava/lang/String;)[Lorg/firo/lelantus/ParsedJoinSplit;
+*/
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jParseJoinSplits
+		(JNIEnv *, jobject, jobjectArray);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jPlanConsolidation
+* Signature: ([J[III)[Lorg/firo/lelantus/ConsolidationStep;
+*/
+JNIEXPORT jobjectArray JNICALL Java_org_firo_lelantus_Lelantus_jPlanConsolidation
+		(JNIEnv *, jobject, jlongArray, jintArray, jint, jint);
+
+/*
+* Class:     org_firo_lelantus_Lelantus
+* Method:    jCreateConsolidationScript
+* Signature: (Ljava/lang/String;I[Lorg/firo/lelantus/LelantusEntry;Ljava/lang/String;)Ljava/lang/String;
+*/
+JNIEXPORT jstring JNICALL Java_org_firo_lelantus_Lelantus_jCreateConsolidationScript
+		(JNIEnv *, jobject, jstring, jint, jobjectArray, jstring);
+
 #ifdef __cplusplus
 }
 #endif
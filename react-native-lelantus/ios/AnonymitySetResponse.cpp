@@ -0,0 +1,302 @@
+#include "AnonymitySetResponse.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Nesting of values the decoder skips, deeper documents are rejected.
+static const int MAX_SKIP_DEPTH = 32;
+
+static int DecodeBase64Char(char c) {
+	if (c >= 'A' && c <= 'Z') return c - 'A';
+	if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+	if (c >= '0' && c <= '9') return c - '0' + 52;
+	if (c == '+') return 62;
+	if (c == '/') return 63;
+	return -1;
+}
+
+// Decodes at most capacity bytes into out, false on bad characters or overflow.
+static bool DecodeBase64(
+		const char *begin,
+		const char *end,
+		unsigned char *out,
+		size_t capacity,
+		size_t &length
+) {
+	length = 0;
+	uint32_t buffer = 0;
+	int bits = 0;
+	for (const char *c = begin; c != end && *c != '='; c++) {
+		int value = DecodeBase64Char(*c);
+		if (value < 0) {
+			return false;
+		}
+		buffer = (buffer << 6) | value;
+		bits += 6;
+		if (bits >= 8) {
+			bits -= 8;
+			if (length == capacity) {
+				return false;
+			}
+			out[length++] = (buffer >> bits) & 0xff;
+		}
+	}
+	return true;
+}
+
+class JsonCursor {
+public:
+	JsonCursor(const char *json, size_t length) : position(json), end(json + length) {}
+
+	bool AtEnd() {
+		SkipWhitespace();
+		return position == end;
+	}
+
+	bool Consume(char c) {
+		SkipWhitespace();
+		if (position == end || *position != c) {
+			return false;
+		}
+		position++;
+		return true;
+	}
+
+	bool Peek(char c) {
+		SkipWhitespace();
+		return position != end && *position == c;
+	}
+
+	// Raw contents between the quotes, escapes are left as they are.
+	bool ReadString(const char *&begin, const char *&stringEnd) {
+		if (!Consume('"')) {
+			return false;
+		}
+		begin = position;
+		while (position != end && *position != '"') {
+			if (*position == '\\' && ++position == end) {
+				return false;
+			}
+			position++;
+		}
+		if (position == end) {
+			return false;
+		}
+		stringEnd = position++;
+		return true;
+	}
+
+	bool ReadUnsigned(uint64_t &value) {
+		SkipWhitespace();
+		const char *begin = position;
+		value = 0;
+		while (position != end && *position >= '0' && *position <= '9') {
+			uint64_t digit = *position - '0';
+			if (value > (UINT64_MAX - digit) / 10) {
+				return false;
+			}
+			value = value * 10 + digit;
+			position++;
+		}
+		return position != begin;
+	}
+
+	bool SkipValue(int depth = 0) {
+		if (depth > MAX_SKIP_DEPTH) {
+			return false;
+		}
+		SkipWhitespace();
+		if (position == end) {
+			return false;
+		}
+		const char *begin;
+		const char *stringEnd;
+		switch (*position) {
+			case '"':
+				return ReadString(begin, stringEnd);
+			case '[':
+				position++;
+				if (Consume(']')) {
+					return true;
+				}
+				do {
+					if (!SkipValue(depth + 1)) {
+						return false;
+					}
+				} while (Consume(','));
+				return Consume(']');
+			case '{':
+				position++;
+				if (Consume('}')) {
+					return true;
+				}
+				do {
+					if (!ReadString(begin, stringEnd) || !Consume(':') || !SkipValue(depth + 1)) {
+						return false;
+					}
+				} while (Consume(','));
+				return Consume('}');
+			default:
+				// numbers and literals
+				begin = position;
+				while (position != end && strchr(",]} \t\r\n", *position) == nullptr) {
+					position++;
+				}
+				return position != begin;
+		}
+	}
+
+private:
+	void SkipWhitespace() {
+		while (position != end && (*position == ' ' || *position == '\t'
+									|| *position == '\r' || *position == '\n')) {
+			position++;
+		}
+	}
+
+	const char *position;
+	const char *end;
+};
+
+static bool IsKey(const char *begin, const char *end, const char *key) {
+	size_t length = strlen(key);
+	return (size_t) (end - begin) == length && memcmp(begin, key, length) == 0;
+}
+
+static bool ReadBase64Field(
+		JsonCursor &cursor,
+		unsigned char *out,
+		size_t size,
+		bool reverse
+) {
+	const char *begin;
+	const char *end;
+	size_t length;
+	if (!cursor.ReadString(begin, end) || !DecodeBase64(begin, end, out, size, length)
+		|| length != size) {
+		return false;
+	}
+	if (reverse) {
+		std::reverse(out, out + size);
+	}
+	return true;
+}
+
+// Empty strings stay empty, the server sends them when it has no set.
+static bool ReadHash(JsonCursor &cursor, bool reverse, std::string &hex) {
+	if (cursor.Peek('"')) {
+		JsonCursor empty = cursor;
+		const char *begin;
+		const char *end;
+		if (empty.ReadString(begin, end) && begin == end) {
+			cursor = empty;
+			hex.clear();
+			return true;
+		}
+	}
+	unsigned char hash[32];
+	if (!ReadBase64Field(cursor, hash, sizeof(hash), reverse)) {
+		return false;
+	}
+	hex = EncodeHex(hash, sizeof(hash));
+	return true;
+}
+
+// [publicCoin, tag, amount or encrypted value, txId]
+static bool ReadCoin(JsonCursor &cursor, SetCoin &coin) {
+	memset(&coin, 0, sizeof(coin));
+	if (!cursor.Consume('[')
+		|| !ReadBase64Field(cursor, coin.publicCoin, sizeof(coin.publicCoin), false)
+		|| !cursor.Consume(',')
+		|| !ReadBase64Field(cursor, coin.tag, sizeof(coin.tag), true)
+		|| !cursor.Consume(',')) {
+		return false;
+	}
+
+	if (cursor.Peek('"')) {
+		const char *begin;
+		const char *end;
+		size_t length;
+		if (!cursor.ReadString(begin, end)
+			|| !DecodeBase64(begin, end, coin.value, sizeof(coin.value), length)) {
+			return false;
+		}
+		coin.isJMint = 1;
+		coin.encryptedValueSize = (unsigned char) length;
+	} else {
+		uint64_t amount;
+		if (!cursor.ReadUnsigned(amount)) {
+			return false;
+		}
+		for (size_t i = 0; i < 8; i++) {
+			coin.value[i] = (unsigned char) (amount >> (8 * i));
+		}
+	}
+
+	if (!cursor.Consume(',') || !ReadBase64Field(cursor, coin.txId, sizeof(coin.txId), true)) {
+		return false;
+	}
+	// fields a newer server may add
+	while (cursor.Consume(',')) {
+		if (!cursor.SkipValue()) {
+			return false;
+		}
+	}
+	return cursor.Consume(']');
+}
+
+static bool ReadCoins(JsonCursor &cursor, std::vector<SetCoin> &coins) {
+	if (!cursor.Consume('[')) {
+		return false;
+	}
+	if (cursor.Consume(']')) {
+		return true;
+	}
+	do {
+		coins.emplace_back();
+		if (!ReadCoin(cursor, coins.back())) {
+			return false;
+		}
+	} while (cursor.Consume(','));
+	return cursor.Consume(']');
+}
+
+bool ParseAnonymitySetResponse(const char *json, size_t length, AnonymitySetResponse &response) {
+	response.setHash.clear();
+	response.blockHash.clear();
+	response.coins.clear();
+
+	JsonCursor cursor(json, length);
+	if (!cursor.Consume('{')) {
+		return false;
+	}
+	bool hasSetHash = false;
+	bool hasBlockHash = false;
+	bool hasCoins = false;
+	if (!cursor.Consume('}')) {
+		do {
+			const char *key;
+			const char *keyEnd;
+			if (!cursor.ReadString(key, keyEnd) || !cursor.Consume(':')) {
+				return false;
+			}
+			bool read;
+			if (IsKey(key, keyEnd, "setHash")) {
+				read = hasSetHash = ReadHash(cursor, false, response.setHash);
+			} else if (IsKey(key, keyEnd, "blockHash")) {
+				read = hasBlockHash = ReadHash(cursor, true, response.blockHash);
+			} else if (IsKey(key, keyEnd, "coins")) {
+				read = hasCoins = ReadCoins(cursor, response.coins);
+			} else {
+				read = cursor.SkipValue();
+			}
+			if (!read) {
+				return false;
+			}
+		} while (cursor.Consume(','));
+		if (!cursor.Consume('}')) {
+			return false;
+		}
+	}
+	return hasSetHash && hasBlockHash && hasCoins && cursor.AtEnd();
+}
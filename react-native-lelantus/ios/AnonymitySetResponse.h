@@ -0,0 +1,28 @@
+#ifndef ORG_FIRO_LELANTUS_ANONYMITYSETRESPONSE_H
+#define ORG_FIRO_LELANTUS_ANONYMITYSETRESPONSE_H
+
+#include "SetStore.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+ * Result of lelantus.getanonymityset, hashes in the hex form the set store keeps
+ * (block hash byte reversed, set hash as sent).
+ */
+struct AnonymitySetResponse {
+	std::string setHash;
+	std::string blockHash;
+	// in the order of the response, newest coins first
+	std::vector<SetCoin> coins;
+};
+
+/*
+ * Scans the JSON text of the result once, base64 fields are decoded straight into
+ * SetCoin records, with tags and tx ids byte reversed. No document or per field
+ * strings are built. Returns false if the text is not a well formed result.
+ */
+bool ParseAnonymitySetResponse(const char *json, size_t length, AnonymitySetResponse &response);
+
+#endif //ORG_FIRO_LELANTUS_ANONYMITYSETRESPONSE_H
@@ -0,0 +1,125 @@
+#include "Bip32.h"
+
+#include <cstring>
+#include <vector>
+
+#include "liblelantus/secp256k1/include/secp256k1.h"
+#include "openssl/crypto.h"
+#include "openssl/evp.h"
+#include "openssl/hmac.h"
+#include "openssl/ripemd.h"
+#include "openssl/sha.h"
+
+static const char *base58Alphabet = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+// version(4) | depth(1) | parent fingerprint(4) | child number(4) | chain code(32) | 0x00 | key(32)
+static const size_t EXTENDED_KEY_SIZE = 78;
+
+static secp256k1_context *GetSecp256k1Context() {
+	static secp256k1_context *context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+	return context;
+}
+
+static bool DecodeBase58(const char *str, std::vector<unsigned char> &out) {
+	size_t zeroes = 0;
+	while (*str == '1') {
+		zeroes++;
+		str++;
+	}
+
+	// log(58) / log(256), rounded up
+	std::vector<unsigned char> b256(strlen(str) * 733 / 1000 + 1);
+	size_t length = 0;
+	for (; *str; str++) {
+		const char *ch = strchr(base58Alphabet, *str);
+		if (ch == nullptr) {
+			return false;
+		}
+		int carry = (int) (ch - base58Alphabet);
+		size_t i = 0;
+		for (auto it = b256.rbegin(); (carry != 0 || i < length) && it != b256.rend(); ++it, ++i) {
+			carry += 58 * (*it);
+			*it = carry % 256;
+			carry /= 256;
+		}
+		if (carry != 0) {
+			return false;
+		}
+		length = i;
+	}
+
+	out.assign(zeroes, 0x00);
+	out.insert(out.end(), b256.end() - length, b256.end());
+	return true;
+}
+
+static bool GetCompressedPublicKey(const unsigned char *privateKey, unsigned char *publicKey) {
+	secp256k1_pubkey pubkey;
+	if (!secp256k1_ec_pubkey_create(GetSecp256k1Context(), &pubkey, privateKey)) {
+		return false;
+	}
+	size_t publicKeySize = 33;
+	return secp256k1_ec_pubkey_serialize(GetSecp256k1Context(), publicKey, &publicKeySize,
+										 &pubkey, SECP256K1_EC_COMPRESSED) && publicKeySize == 33;
+}
+
+bool DecodeExtendedPrivateKey(const char *base58, ExtendedPrivateKey &out) {
+	std::vector<unsigned char> data;
+	if (!DecodeBase58(base58, data) || data.size() != EXTENDED_KEY_SIZE + 4) {
+		return false;
+	}
+
+	unsigned char hash[SHA256_DIGEST_LENGTH];
+	SHA256(data.data(), EXTENDED_KEY_SIZE, hash);
+	SHA256(hash, SHA256_DIGEST_LENGTH, hash);
+	bool valid = memcmp(hash, data.data() + EXTENDED_KEY_SIZE, 4) == 0 && data[45] == 0x00;
+	if (valid) {
+		memcpy(out.chainCode, data.data() + 13, 32);
+		memcpy(out.key, data.data() + 46, 32);
+		valid = secp256k1_ec_seckey_verify(GetSecp256k1Context(), out.key) == 1;
+	}
+
+	OPENSSL_cleanse(data.data(), data.size());
+	return valid;
+}
+
+bool DeriveChildKey(const ExtendedPrivateKey &parent, uint32_t index, ExtendedPrivateKey &child) {
+	unsigned char data[37];
+	if (index >= BIP32_HARDENED_INDEX) {
+		data[0] = 0x00;
+		memcpy(data + 1, parent.key, 32);
+	} else if (!GetCompressedPublicKey(parent.key, data)) {
+		return false;
+	}
+	data[33] = (index >> 24) & 0xff;
+	data[34] = (index >> 16) & 0xff;
+	data[35] = (index >> 8) & 0xff;
+	data[36] = index & 0xff;
+
+	unsigned char digest[64];
+	unsigned int digestSize = sizeof(digest);
+	HMAC(EVP_sha512(), parent.chainCode, 32, data, sizeof(data), digest, &digestSize);
+
+	memcpy(child.key, parent.key, 32);
+	bool valid = secp256k1_ec_privkey_tweak_add(GetSecp256k1Context(), child.key, digest) == 1;
+	memcpy(child.chainCode, digest + 32, 32);
+
+	OPENSSL_cleanse(data, sizeof(data));
+	OPENSSL_cleanse(digest, sizeof(digest));
+	return valid;
+}
+
+bool GetKeyIdentifier(const unsigned char *privateKey, unsigned char *identifier) {
+	unsigned char publicKey[33];
+	if (!GetCompressedPublicKey(privateKey, publicKey)) {
+		return false;
+	}
+	unsigned char hash[SHA256_DIGEST_LENGTH];
+	SHA256(publicKey, sizeof(publicKey), hash);
+	RIPEMD160(hash, sizeof(hash), identifier);
+	return true;
+}
+
+void ClearExtendedPrivateKey(ExtendedPrivateKey &key) {
+	OPENSSL_cleanse(&key, sizeof(key));
+}
@@ -0,0 +1,36 @@
+#ifndef ORG_FIRO_LELANTUS_BIP32_H
+#define ORG_FIRO_LELANTUS_BIP32_H
+
+#include <cstdint>
+
+// Indexes of the account level nodes under m/44'/136'/0' that hold lelantus keys.
+const uint32_t BIP44_MINT_INDEX = 2;
+const uint32_t BIP44_MINT_VALUE_INDEX = 5;
+
+const uint32_t BIP32_HARDENED_INDEX = 0x80000000;
+
+struct ExtendedPrivateKey {
+	unsigned char key[32];
+	unsigned char chainCode[32];
+};
+
+/*
+ * Decodes a base58check serialized extended private key (xprv). The version bytes
+ * are not checked so that both main and test net keys are accepted.
+ */
+bool DecodeExtendedPrivateKey(const char *base58, ExtendedPrivateKey &out);
+
+/*
+ * CKDpriv from BIP32. Indexes starting from BIP32_HARDENED_INDEX are derived
+ * as hardened children, same as bip32.derive() on the JS side.
+ */
+bool DeriveChildKey(const ExtendedPrivateKey &parent, uint32_t index, ExtendedPrivateKey &child);
+
+/*
+ * hash160 of the compressed public key, the `identifier` of a bip32 node.
+ */
+bool GetKeyIdentifier(const unsigned char *privateKey, unsigned char *identifier);
+
+void ClearExtendedPrivateKey(ExtendedPrivateKey &key);
+
+#endif //ORG_FIRO_LELANTUS_BIP32_H
@@ -0,0 +1,497 @@
+#include "CoinSelection.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+
+// Upper bound of visited nodes in the exact match search.
+static const size_t EXACT_MATCH_MAX_TRIES = 100000;
+
+// Schnorr proof, range proof and the fixed fields of the JoinSplit payload.
+static const uint64_t JOINSPLIT_PROOFS_SIZE = 1054;
+// Sigma proof, serial number and aux data of every input.
+static const uint64_t JOINSPLIT_INPUT_SIZE = 2560;
+// Group id, block hash and anonymity set hash of every set after the first one.
+static const uint64_t JOINSPLIT_EXTRA_SET_SIZE = 4 + 32 + 32;
+// Version, lock time, the dummy input and the counts of the transaction.
+static const uint64_t TRANSACTION_BASE_SIZE = 85;
+// Value, script length and a p2pkh script.
+static const uint64_t TRANSPARENT_OUTPUT_SIZE = 8 + 1 + 25;
+// Value, script length, opcode, public coin and the encrypted value.
+static const uint64_t JMINT_OUTPUT_SIZE = 8 + 1 + 1 + 34 + 16;
+
+// Largest anonymity set, assumed for sets of unknown size.
+static const size_t MAX_ANONYMITY_SET_SIZE = 65000;
+// Serialized public coin.
+static const uint64_t PUBLIC_COIN_SIZE = 34;
+
+uint64_t EstimateJoinSplitSize(const JoinSplitShape &shape) {
+	uint64_t extraSets = shape.setCount > 1 ? shape.setCount - 1 : 0;
+	return JOINSPLIT_PROOFS_SIZE
+		   + JOINSPLIT_INPUT_SIZE * shape.inputCount
+		   + JOINSPLIT_EXTRA_SET_SIZE * extraSets
+		   + TRANSACTION_BASE_SIZE
+		   + TRANSPARENT_OUTPUT_SIZE * shape.transparentOutputCount
+		   + JMINT_OUTPUT_SIZE * shape.jmintOutputCount;
+}
+
+uint64_t EstimateJoinSplitSize(size_t inputCount, size_t setCount) {
+	return EstimateJoinSplitSize(inputCount, setCount, 1);
+}
+
+uint64_t EstimateJoinSplitSize(size_t inputCount, size_t setCount, size_t transparentOutputCount) {
+	return EstimateJoinSplitSize({inputCount, setCount, transparentOutputCount, 1});
+}
+
+static size_t CountSets(const std::vector<SelectionCoin> &coins, const std::vector<size_t> &positions) {
+	std::set<int32_t> setIds;
+	for (size_t position : positions) {
+		setIds.insert(coins[position].anonymitySetId);
+	}
+	return setIds.size();
+}
+
+static uint64_t SumAmounts(const std::vector<SelectionCoin> &coins, const std::vector<size_t> &positions) {
+	uint64_t sum = 0;
+	for (size_t position : positions) {
+		sum += coins[position].amount;
+	}
+	return sum;
+}
+
+ProvingCost PredictProvingCost(
+		const std::vector<SelectionCoin> &coins,
+		const std::vector<size_t> &selected,
+		const std::map<int32_t, size_t> &setSizes
+) {
+	std::map<int32_t, size_t> inputsPerSet;
+	for (size_t position : selected) {
+		inputsPerSet[coins[position].anonymitySetId]++;
+	}
+
+	ProvingCost cost{0, 0, 0};
+	for (const auto &set : inputsPerSet) {
+		auto size = setSizes.find(set.first);
+		uint64_t points = size != setSizes.end() ? size->second : MAX_ANONYMITY_SET_SIZE;
+		cost.deserializedPoints += points;
+		cost.provedPoints += points * set.second;
+		cost.setBytes += points * PUBLIC_COIN_SIZE;
+	}
+	return cost;
+}
+
+static uint64_t ProvingWork(const ProvingCost &cost) {
+	return cost.deserializedPoints + cost.provedPoints;
+}
+
+// Positions of the coins ordered by amount, largest first, older coins first on ties.
+static std::vector<size_t> SortByAmount(
+		const std::vector<SelectionCoin> &coins,
+		const std::vector<size_t> &positions
+) {
+	std::vector<size_t> sorted(positions);
+	std::stable_sort(sorted.begin(), sorted.end(), [&coins](size_t a, size_t b) {
+		return coins[a].amount > coins[b].amount;
+	});
+	return sorted;
+}
+
+static std::vector<size_t> AllPositions(const std::vector<SelectionCoin> &coins) {
+	std::vector<size_t> positions(coins.size());
+	for (size_t i = 0; i < coins.size(); i++) {
+		positions[i] = i;
+	}
+	return positions;
+}
+
+/*
+ * GetCoinsToJoinSplit from liblelantus: takes the largest coin while the missing
+ * amount is at least as big, otherwise the smallest coin that covers the rest.
+ */
+static bool SelectDefault(
+		const std::vector<SelectionCoin> &coins,
+		const std::vector<size_t> &positions,
+		uint64_t required,
+		std::vector<size_t> &selected
+) {
+	std::vector<size_t> available = SortByAmount(coins, positions);
+	uint64_t spent = 0;
+	selected.clear();
+	while (spent < required) {
+		if (available.empty()) {
+			return false;
+		}
+		uint64_t need = required - spent;
+		size_t chosen = 0;
+		if (need < coins[available[0]].amount) {
+			// the first of the smallest coins covering the rest, ties keep list order
+			for (size_t i = available.size(); i-- > 0;) {
+				if (coins[available[i]].amount >= need
+					&& (i == 0 || coins[available[i - 1]].amount != coins[available[i]].amount)) {
+					chosen = i;
+					break;
+				}
+			}
+		}
+		spent += coins[available[chosen]].amount;
+		selected.push_back(available[chosen]);
+		available.erase(available.begin() + chosen);
+	}
+	return true;
+}
+
+static bool SelectMinInputs(
+		const std::vector<SelectionCoin> &coins,
+		const std::vector<size_t> &positions,
+		uint64_t required,
+		std::vector<size_t> &selected
+) {
+	std::vector<size_t> sorted = SortByAmount(coins, positions);
+	uint64_t spent = 0;
+	size_t count = 0;
+	while (spent < required && count < sorted.size()) {
+		spent += coins[sorted[count++]].amount;
+	}
+	if (spent < required) {
+		return false;
+	}
+	selected.assign(sorted.begin(), sorted.begin() + count);
+	if (count == 0) {
+		return true;
+	}
+
+	// same number of inputs, but the last one swapped for the smallest coin that still covers
+	uint64_t withoutLast = spent - coins[selected.back()].amount;
+	for (size_t i = sorted.size(); i-- > count;) {
+		if (withoutLast + coins[sorted[i]].amount >= required) {
+			selected.back() = sorted[i];
+			break;
+		}
+	}
+	return true;
+}
+
+static bool SelectMinSets(
+		const std::vector<SelectionCoin> &coins,
+		const std::vector<size_t> &positions,
+		uint64_t required,
+		std::vector<size_t> &selected
+) {
+	std::map<int32_t, std::vector<size_t>> bySet;
+	std::map<int32_t, uint64_t> setTotals;
+	for (size_t position : positions) {
+		bySet[coins[position].anonymitySetId].push_back(position);
+		setTotals[coins[position].anonymitySetId] += coins[position].amount;
+	}
+
+	// a single set is enough, take the one that needs the fewest inputs
+	bool found = false;
+	for (const auto &set : bySet) {
+		std::vector<size_t> candidate;
+		if (setTotals[set.first] >= required && SelectDefault(coins, set.second, required, candidate)
+			&& (!found || candidate.size() < selected.size())) {
+			selected = candidate;
+			found = true;
+		}
+	}
+	if (found) {
+		return true;
+	}
+
+	// otherwise add whole sets, richest first, until they cover the amount
+	std::vector<int32_t> setIds;
+	for (const auto &set : bySet) {
+		setIds.push_back(set.first);
+	}
+	std::stable_sort(setIds.begin(), setIds.end(), [&setTotals](int32_t a, int32_t b) {
+		return setTotals[a] > setTotals[b];
+	});
+	std::vector<size_t> pool;
+	uint64_t total = 0;
+	for (int32_t setId : setIds) {
+		pool.insert(pool.end(), bySet[setId].begin(), bySet[setId].end());
+		total += setTotals[setId];
+		if (total >= required) {
+			return SelectDefault(coins, pool, required, selected);
+		}
+	}
+	return false;
+}
+
+/*
+ * Depth first search over coins sorted by amount for a subset whose sum is exactly
+ * the target of its input and set count, so no change has to be minted.
+ */
+static bool SearchExactMatch(
+		const std::vector<SelectionCoin> &coins,
+		const std::vector<size_t> &sorted,
+		const std::vector<uint64_t> &suffixSums,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		size_t outputCount,
+		uint64_t maxTarget,
+		size_t position,
+		uint64_t sum,
+		std::vector<size_t> &current,
+		std::map<int32_t, size_t> &currentSets,
+		size_t &tries,
+		std::vector<size_t> &selected
+) {
+	if (!current.empty()) {
+		uint64_t target = spendAmount;
+		if (!subtractFeeFromAmount) {
+			target += EstimateJoinSplitSize(current.size(), currentSets.size(), outputCount);
+		}
+		if (sum == target) {
+			selected = current;
+			return true;
+		}
+	}
+	// another input raises the target at least by its own size
+	uint64_t nextTarget = spendAmount;
+	if (!subtractFeeFromAmount) {
+		nextTarget += EstimateJoinSplitSize(current.size() + 1, std::max<size_t>(currentSets.size(), 1),
+											outputCount);
+	}
+
+	size_t next = position;
+	while (next < sorted.size()) {
+		if (sum + suffixSums[next] < nextTarget || ++tries > EXACT_MATCH_MAX_TRIES) {
+			return false;
+		}
+		const SelectionCoin &coin = coins[sorted[next]];
+		if (sum + coin.amount <= maxTarget) {
+			current.push_back(sorted[next]);
+			currentSets[coin.anonymitySetId]++;
+			if (SearchExactMatch(coins, sorted, suffixSums, spendAmount, subtractFeeFromAmount,
+								 outputCount, maxTarget, next + 1, sum + coin.amount, current,
+								 currentSets, tries, selected)) {
+				return true;
+			}
+			if (--currentSets[coin.anonymitySetId] == 0) {
+				currentSets.erase(coin.anonymitySetId);
+			}
+			current.pop_back();
+		}
+		// coins of the same amount lead to the same sums
+		uint64_t amount = coin.amount;
+		while (next < sorted.size() && coins[sorted[next]].amount == amount) {
+			next++;
+		}
+	}
+	return false;
+}
+
+static bool SelectExactMatch(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		size_t outputCount,
+		CoinSelection &result
+) {
+	std::vector<size_t> all = AllPositions(coins);
+	std::vector<size_t> sorted = SortByAmount(coins, all);
+	std::vector<uint64_t> suffixSums(sorted.size() + 1, 0);
+	for (size_t i = sorted.size(); i-- > 0;) {
+		suffixSums[i] = suffixSums[i + 1] + coins[sorted[i]].amount;
+	}
+	uint64_t maxTarget = spendAmount;
+	if (!subtractFeeFromAmount) {
+		maxTarget += EstimateJoinSplitSize(sorted.size(), CountSets(coins, all), outputCount);
+	}
+
+	std::vector<size_t> current;
+	std::map<int32_t, size_t> currentSets;
+	size_t tries = 0;
+	if (!SearchExactMatch(coins, sorted, suffixSums, spendAmount, subtractFeeFromAmount, outputCount,
+						  maxTarget, 0, 0, current, currentSets, tries, result.selected)) {
+		return false;
+	}
+	result.fee = EstimateJoinSplitSize(result.selected.size(), CountSets(coins, result.selected),
+									   outputCount);
+	result.changeToMint = 0;
+	return true;
+}
+
+static bool SelectForRequired(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t required,
+		CoinSelectionStrategy strategy,
+		std::vector<size_t> &selected
+) {
+	switch (strategy) {
+		case COIN_SELECTION_MIN_INPUTS:
+			return SelectMinInputs(coins, AllPositions(coins), required, selected);
+		case COIN_SELECTION_MIN_SETS:
+			return SelectMinSets(coins, AllPositions(coins), required, selected);
+		default:
+			return SelectDefault(coins, AllPositions(coins), required, selected);
+	}
+}
+
+/*
+ * Runs the default and the fewest sets selection and keeps the one with less predicted
+ * proving work, the default one on ties. Pulling inputs from fewer sets pays off when
+ * the saved set costs more than the extra inputs.
+ */
+static bool SelectSetAware(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		const std::map<int32_t, size_t> &setSizes,
+		size_t outputCount,
+		CoinSelection &result
+) {
+	if (!SelectCoins(coins, spendAmount, subtractFeeFromAmount, COIN_SELECTION_DEFAULT, setSizes,
+					 outputCount, result)) {
+		return false;
+	}
+	CoinSelection grouped;
+	if (SelectCoins(coins, spendAmount, subtractFeeFromAmount, COIN_SELECTION_MIN_SETS, setSizes,
+					outputCount, grouped)
+		&& ProvingWork(PredictProvingCost(coins, grouped.selected, setSizes))
+		   < ProvingWork(PredictProvingCost(coins, result.selected, setSizes))) {
+		result = grouped;
+	}
+	return true;
+}
+
+bool SelectCoins(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		CoinSelectionStrategy strategy,
+		CoinSelection &result
+) {
+	return SelectCoins(coins, spendAmount, subtractFeeFromAmount, strategy,
+					   std::map<int32_t, size_t>(), result);
+}
+
+bool SelectCoins(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		CoinSelectionStrategy strategy,
+		const std::map<int32_t, size_t> &setSizes,
+		CoinSelection &result
+) {
+	return SelectCoins(coins, spendAmount, subtractFeeFromAmount, strategy, setSizes, 1, result);
+}
+
+bool SelectCoins(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		CoinSelectionStrategy strategy,
+		const std::map<int32_t, size_t> &setSizes,
+		size_t transparentOutputCount,
+		CoinSelection &result
+) {
+	if (strategy == COIN_SELECTION_SET_AWARE) {
+		return SelectSetAware(coins, spendAmount, subtractFeeFromAmount, setSizes,
+							  transparentOutputCount, result);
+	}
+
+	result.selected.clear();
+	result.fee = 0;
+	result.changeToMint = 0;
+
+	bool selected = false;
+	if (strategy == COIN_SELECTION_EXACT_MATCH) {
+		selected = SelectExactMatch(coins, spendAmount, subtractFeeFromAmount, transparentOutputCount,
+									result);
+	}
+
+	// fee loop of EstimateJoinSplitFee, starting from a zero fee, with the size model above
+	uint64_t fee = 0;
+	while (!selected) {
+		uint64_t required = spendAmount;
+		if (!subtractFeeFromAmount) {
+			required += fee;
+		}
+		if (!SelectForRequired(coins, required, strategy, result.selected)) {
+			result.selected.clear();
+			return false;
+		}
+		uint64_t feeNeeded = EstimateJoinSplitSize(result.selected.size(),
+												   CountSets(coins, result.selected),
+												   transparentOutputCount);
+		result.changeToMint = SumAmounts(coins, result.selected) - required;
+		if (fee >= feeNeeded) {
+			break;
+		}
+		fee = feeNeeded;
+		if (subtractFeeFromAmount) {
+			break;
+		}
+	}
+	if (!selected) {
+		result.fee = fee;
+	}
+
+	std::stable_sort(result.selected.begin(), result.selected.end(), [&coins](size_t a, size_t b) {
+		return coins[a].anonymitySetId < coins[b].anonymitySetId;
+	});
+	return true;
+}
+
+std::string BenchmarkCoinSelection(size_t coinCount, size_t rounds) {
+	static const char *names[] = {"default", "min inputs", "min sets", "exact match", "set aware"};
+	static const int32_t setCount = 20;
+	std::uniform_int_distribution<uint64_t> amounts(100000, 1000000000);
+	std::uniform_int_distribution<int32_t> setIds(1, setCount);
+
+	std::ostringstream report;
+	report << "coin selection, " << coinCount << " coins, " << rounds << " rounds\n";
+	for (int strategy = COIN_SELECTION_DEFAULT; strategy <= COIN_SELECTION_SET_AWARE; strategy++) {
+		std::mt19937_64 wallets(rounds);
+		std::chrono::nanoseconds elapsed(0);
+		size_t inputs = 0;
+		size_t sets = 0;
+		uint64_t work = 0;
+		uint64_t setBytes = 0;
+		size_t failed = 0;
+		for (size_t round = 0; round < rounds; round++) {
+			std::vector<SelectionCoin> coins(coinCount);
+			uint64_t total = 0;
+			for (SelectionCoin &coin : coins) {
+				coin = {amounts(wallets), setIds(wallets), 0};
+				total += coin.amount;
+			}
+			uint64_t spendAmount = std::uniform_int_distribution<uint64_t>(1, total / 20)(wallets);
+			// every set is full but the newest one
+			std::map<int32_t, size_t> setSizes;
+			for (int32_t setId = 1; setId < setCount; setId++) {
+				setSizes[setId] = MAX_ANONYMITY_SET_SIZE;
+			}
+			setSizes[setCount] = std::uniform_int_distribution<size_t>(1, MAX_ANONYMITY_SET_SIZE)(wallets);
+
+			CoinSelection selection;
+			auto start = std::chrono::steady_clock::now();
+			bool success = SelectCoins(coins, spendAmount, false, (CoinSelectionStrategy) strategy,
+									   setSizes, selection);
+			elapsed += std::chrono::steady_clock::now() - start;
+			if (!success) {
+				failed++;
+				continue;
+			}
+			inputs += selection.selected.size();
+			sets += CountSets(coins, selection.selected);
+			ProvingCost cost = PredictProvingCost(coins, selection.selected, setSizes);
+			work += ProvingWork(cost);
+			setBytes += cost.setBytes;
+		}
+		size_t succeeded = std::max<size_t>(rounds - failed, 1);
+		report << names[strategy]
+			   << ": " << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / std::max<size_t>(rounds, 1)
+			   << " us, inputs " << (double) inputs / succeeded
+			   << ", sets " << (double) sets / succeeded
+			   << ", proving points " << work / succeeded
+			   << ", set bytes " << setBytes / succeeded
+			   << ", failed " << failed << "\n";
+	}
+	return report.str();
+}
@@ -0,0 +1,119 @@
+#ifndef ORG_FIRO_LELANTUS_COINSELECTION_H
+#define ORG_FIRO_LELANTUS_COINSELECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+enum CoinSelectionStrategy {
+	// same selection as EstimateJoinSplitFee from liblelantus
+	COIN_SELECTION_DEFAULT = 0,
+	// fewest inputs, largest coins first
+	COIN_SELECTION_MIN_INPUTS = 1,
+	// fewest distinct anonymity sets, every set adds a full set to the proof
+	COIN_SELECTION_MIN_SETS = 2,
+	// a subset that needs no change, falls back to the default selection
+	COIN_SELECTION_EXACT_MATCH = 3,
+	// default or fewest sets, whichever has the lower predicted proving cost
+	COIN_SELECTION_SET_AWARE = 4,
+};
+
+struct SelectionCoin {
+	uint64_t amount;
+	int32_t anonymitySetId;
+	int32_t height;
+};
+
+struct CoinSelection {
+	// positions in the input vector, ordered by anonymity set id as JoinSplit requires
+	std::vector<size_t> selected;
+	uint64_t fee;
+	uint64_t changeToMint;
+};
+
+/*
+ * Serialized size of a JoinSplit transaction, derived from its shape only. For one
+ * anonymity set, one transparent output and one jmint it equals the estimate of
+ * liblelantus: 1054 bytes of Schnorr and range proofs, 2560 per input for the sigma
+ * proof and aux data and 179 for the rest of the transaction.
+ */
+struct JoinSplitShape {
+	size_t inputCount;
+	size_t setCount;
+	size_t transparentOutputCount;
+	size_t jmintOutputCount;
+};
+
+uint64_t EstimateJoinSplitSize(const JoinSplitShape &shape);
+
+// Size of a spend to one transparent output with change minted to one jmint.
+uint64_t EstimateJoinSplitSize(size_t inputCount, size_t setCount);
+
+// Same, paying transparentOutputCount outputs from the one proof.
+uint64_t EstimateJoinSplitSize(size_t inputCount, size_t setCount, size_t transparentOutputCount);
+
+/*
+ * Predicted work of the JoinSplit prover: every anonymity set of the inputs is
+ * deserialized once, a square root per point, and every input runs a one-out-of-many
+ * proof over all points of its set.
+ */
+struct ProvingCost {
+	uint64_t deserializedPoints;
+	uint64_t provedPoints;
+	// serialized public coins of the sets handed to the prover
+	uint64_t setBytes;
+};
+
+// Sets missing from setSizes are counted as full sets.
+ProvingCost PredictProvingCost(
+		const std::vector<SelectionCoin> &coins,
+		const std::vector<size_t> &selected,
+		const std::map<int32_t, size_t> &setSizes
+);
+
+/*
+ * Picks coins for a spend and iterates the fee the same way EstimateJoinSplitFee
+ * does (1 sat per byte). Needs only amounts, set ids and heights, no key material.
+ * Returns false when the coins don't cover the amount.
+ */
+bool SelectCoins(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		CoinSelectionStrategy strategy,
+		CoinSelection &result
+);
+
+// Same, with the sizes of the anonymity sets for the set aware strategy.
+bool SelectCoins(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		CoinSelectionStrategy strategy,
+		const std::map<int32_t, size_t> &setSizes,
+		CoinSelection &result
+);
+
+/*
+ * Same, for a spend of spendAmount split over transparentOutputCount outputs. Every
+ * output adds to the fee, the proof is paid once.
+ */
+bool SelectCoins(
+		const std::vector<SelectionCoin> &coins,
+		uint64_t spendAmount,
+		bool subtractFeeFromAmount,
+		CoinSelectionStrategy strategy,
+		const std::map<int32_t, size_t> &setSizes,
+		size_t transparentOutputCount,
+		CoinSelection &result
+);
+
+/*
+ * Runs every strategy over random wallets of coinCount coins and reports the average
+ * time, inputs, anonymity sets and predicted proving cost per strategy.
+ */
+std::string BenchmarkCoinSelection(size_t coinCount, size_t rounds);
+
+#endif //ORG_FIRO_LELANTUS_COINSELECTION_H
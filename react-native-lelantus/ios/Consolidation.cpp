@@ -0,0 +1,56 @@
+#include "Consolidation.h"
+
+#include <algorithm>
+
+uint64_t EstimateConsolidationFee(size_t inputCount, size_t setCount) {
+	return EstimateJoinSplitSize({inputCount, setCount, 0, 1});
+}
+
+std::vector<ConsolidationStep> PlanConsolidation(
+		const std::vector<SelectionCoin> &coins,
+		const std::map<int32_t, size_t> &setSizes,
+		size_t minCoins,
+		size_t maxInputs
+) {
+	// what one more input adds to the fee of any spend
+	uint64_t inputFee = EstimateConsolidationFee(2, 1) - EstimateConsolidationFee(1, 1);
+
+	std::map<int32_t, std::vector<size_t>> bySet;
+	for (size_t i = 0; i < coins.size(); i++) {
+		if (coins[i].amount > inputFee) {
+			bySet[coins[i].anonymitySetId].push_back(i);
+		}
+	}
+
+	std::vector<ConsolidationStep> steps;
+	minCoins = std::max<size_t>(minCoins, 2);
+	maxInputs = std::max<size_t>(maxInputs, 2);
+	for (auto &set : bySet) {
+		std::vector<size_t> &positions = set.second;
+		if (positions.size() < minCoins) {
+			continue;
+		}
+		std::stable_sort(positions.begin(), positions.end(), [&coins](size_t a, size_t b) {
+			return coins[a].amount < coins[b].amount;
+		});
+
+		for (size_t begin = 0; begin + 2 <= positions.size(); begin += maxInputs) {
+			size_t end = std::min(begin + maxInputs, positions.size());
+			ConsolidationStep step;
+			step.selected.assign(positions.begin() + begin, positions.begin() + end);
+			step.anonymitySetId = set.first;
+			step.fee = EstimateConsolidationFee(step.selected.size(), 1);
+			uint64_t sum = 0;
+			for (size_t position : step.selected) {
+				sum += coins[position].amount;
+			}
+			if (sum <= step.fee) {
+				continue;
+			}
+			step.mintValue = sum - step.fee;
+			step.provingCost = PredictProvingCost(coins, step.selected, setSizes);
+			steps.push_back(step);
+		}
+	}
+	return steps;
+}
@@ -0,0 +1,42 @@
+#ifndef ORG_FIRO_LELANTUS_CONSOLIDATION_H
+#define ORG_FIRO_LELANTUS_CONSOLIDATION_H
+
+#include "CoinSelection.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/*
+ * Self-spend of coins of one anonymity set into a single jmint, with no transparent
+ * output.
+ */
+struct ConsolidationStep {
+	// positions of the merged coins in the input
+	std::vector<size_t> selected;
+	int32_t anonymitySetId;
+	uint64_t fee;
+	// value of the jmint the coins are merged into
+	uint64_t mintValue;
+	// work of proving the step itself
+	ProvingCost provingCost;
+};
+
+// Fee of a self-spend of inputCount coins from setCount sets into one jmint.
+uint64_t EstimateConsolidationFee(size_t inputCount, size_t setCount);
+
+/*
+ * Merges the coins of every anonymity set holding at least minCoins of them, smallest
+ * coins first and at most maxInputs per step, so every proof covers a single set.
+ * Coins worth less than the fee they add to a spend are left alone. Sets missing from
+ * setSizes are counted as full sets.
+ */
+std::vector<ConsolidationStep> PlanConsolidation(
+		const std::vector<SelectionCoin> &coins,
+		const std::map<int32_t, size_t> &setSizes,
+		size_t minCoins,
+		size_t maxInputs
+);
+
+#endif //ORG_FIRO_LELANTUS_CONSOLIDATION_H
@@ -148,21 +148,22 @@ RCT_EXPORT_METHOD(
 }
 
 RCT_EXPORT_METHOD(
-                  getSpendScript:(double) spendAmount
-                  subtractFeeFromAmount:(BOOL) subtractFeeFromAmount
-                  privateKey:(nonnull NSString*) privateKey
+                  getJMintBundle:(double) value
+                  xprv:(nonnull NSString*) xprv
                   index:(double) index
-                  coins:(nonnull NSArray*) coinsArray
-                  txHash:(nonnull NSString*) txHash
-                  setIds:(nonnull NSArray*) setIdsArray
-                  anonymitySets:(nonnull NSArray*) anonymitySetsArray
-                  anonymitySetHashes:(nonnull NSArray*) anonymitySetHashesArray
-                  groupBlockHashes:(nonnull NSArray*) groupBlockHashesArray
                   c:(RCTResponseSenderBlock) callback
                   ) {
-    const char *cPrivateKey = [privateKey cStringUsingEncoding:NSUTF8StringEncoding];
-    const char *cTxHash = [txHash cStringUsingEncoding:NSUTF8StringEncoding];
-    
+    MintBundle bundle = CreateJMintBundle(value,
+                                          [xprv cStringUsingEncoding:NSUTF8StringEncoding],
+                                          index);
+    callback(@[[NSString stringWithUTF8String:bundle.script.c_str()],
+               [NSString stringWithUTF8String:bundle.publicCoin.c_str()],
+               [NSString stringWithUTF8String:bundle.tag.c_str()],
+               [NSString stringWithUTF8String:bundle.serialNumber.c_str()],
+               [NSNumber numberWithUnsignedInt:bundle.keyPath]]);
+}
+
+static std::list<LelantusEntry> ToLelantusEntries(NSArray *coinsArray) {
     std::list<LelantusEntry> coins;
     
     for (NSDictionary *coin in coinsArray) {
@@ -176,48 +177,88 @@ RCT_EXPORT_METHOD(
         LelantusEntry lelantusEntry{isUsed, height, anonymitySetId, amount, index, privateKey};
         coins.push_back(lelantusEntry);
     }
+    return coins;
+}
+
+// Rejects with the exception being handled, C++ exceptions must not unwind into the bridge.
+static void RejectSpend(RCTPromiseRejectBlock reject) {
+    try {
+        throw;
+    } catch (const std::exception &e) {
+        reject(@"E_SPEND", [NSString stringWithUTF8String:e.what()], nil);
+    } catch (...) {
+        reject(@"E_SPEND", @"Unknown native error", nil);
+    }
+}
+
+RCT_EXPORT_METHOD(
+                  getSpendScript:(double) spendAmount
+                  subtractFeeFromAmount:(BOOL) subtractFeeFromAmount
+                  fee:(double) fee
+                  privateKey:(nonnull NSString*) privateKey
+                  index:(double) index
+                  coins:(nonnull NSArray*) coinsArray
+                  txHash:(nonnull NSString*) txHash
+                  resolver:(RCTPromiseResolveBlock) resolve
+                  rejecter:(RCTPromiseRejectBlock) reject
+                  ) {
+    const char *cPrivateKey = [privateKey cStringUsingEncoding:NSUTF8StringEncoding];
+    const char *cTxHash = [txHash cStringUsingEncoding:NSUTF8StringEncoding];
     
-    std::vector<uint32_t> setIds;
-    std::vector<std::vector<const char *>> anonymitySets;
-    std::vector<const char *> anonymitySetHashes;
-    std::vector<const char *> groupBlockHashes;
+    std::list<LelantusEntry> coins = ToLelantusEntries(coinsArray);
     
-    for (int i = 0; i < setIdsArray.count; i++) {
-        uint32_t id = [[setIdsArray objectAtIndex:i] unsignedIntValue];
-        setIds.push_back(id);
-        
-        NSArray *anonymitySetArray = [anonymitySetsArray objectAtIndex:i];
-        anonymitySets.emplace_back(std::vector<const char *>());
-        for (int j = 0; j < anonymitySetArray.count; j++) {
-            NSString *serializedCoin = [anonymitySetArray objectAtIndex:j];
-            const char *cSerializedCoin = [serializedCoin cStringUsingEncoding:NSUTF8StringEncoding];
-            anonymitySets[i].push_back(cSerializedCoin);
-        }
+    try {
+        const char *script = CreateJoinSplitScript(
+                    cTxHash,
+                    spendAmount,
+                    subtractFeeFromAmount,
+                    fee,
+                    cPrivateKey,
+                    index,
+                    coins
+            );
         
-        NSString *setHash = [anonymitySetHashesArray objectAtIndex:i];
-        const char *cSetHash= [setHash cStringUsingEncoding:NSUTF8StringEncoding];
-        anonymitySetHashes.push_back(cSetHash);
-        
-        NSString *groupBlockHash = [groupBlockHashesArray objectAtIndex:i];
-        const char *cGroupBlockHash = [groupBlockHash cStringUsingEncoding:NSUTF8StringEncoding];
-        groupBlockHashes.push_back(cGroupBlockHash);
-    }
-    
-    const char *script = CreateJoinSplitScript(
-                cTxHash,
-                spendAmount,
-                subtractFeeFromAmount,
-                cPrivateKey,
-                index,
-                coins,
-                setIds,
-                anonymitySets,
-                anonymitySetHashes,
-                groupBlockHashes
-        );
+        NSString* cScript = [NSString stringWithUTF8String:script];
+        resolve(cScript);
+    } catch (...) {
+        RejectSpend(reject);
+    }
+}
+
+RCT_EXPORT_METHOD(
+                  getMultiRecipientSpendScript:(nonnull NSArray*) outputValuesArray
+                  fee:(double) fee
+                  privateKey:(nonnull NSString*) privateKey
+                  index:(double) index
+                  coins:(nonnull NSArray*) coinsArray
+                  txHash:(nonnull NSString*) txHash
+                  resolver:(RCTPromiseResolveBlock) resolve
+                  rejecter:(RCTPromiseRejectBlock) reject
+                  ) {
+    const char *cPrivateKey = [privateKey cStringUsingEncoding:NSUTF8StringEncoding];
+    const char *cTxHash = [txHash cStringUsingEncoding:NSUTF8StringEncoding];
     
-    NSString* cScript = [NSString stringWithUTF8String:script];
-    callback(@[cScript]);
+    std::vector<uint64_t> outputValues;
+    for (NSNumber *outputValue in outputValuesArray) {
+        outputValues.push_back([outputValue unsignedLongLongValue]);
+    }
+    std::list<LelantusEntry> coins = ToLelantusEntries(coinsArray);
+    
+    try {
+        const char *script = CreateMultiRecipientJoinSplitScript(
+                    cTxHash,
+                    outputValues,
+                    fee,
+                    cPrivateKey,
+                    index,
+                    coins
+            );
+        
+        NSString* cScript = [NSString stringWithUTF8String:script];
+        resolve(cScript);
+    } catch (...) {
+        RejectSpend(reject);
+    }
 }
 
 RCT_EXPORT_METHOD(
@@ -234,4 +275,525 @@ RCT_EXPORT_METHOD(
     callback(@[cAmount]);
 }
 
+RCT_EXPORT_METHOD(
+                  getMintTagBatch:(nonnull NSString*) xprv
+                  startIndex:(int) startIndex
+                  count:(int) count
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    const char* cXprv = [xprv cStringUsingEncoding:NSUTF8StringEncoding];
+    std::vector<std::string> tags = CreateTagBatch(cXprv, startIndex, count);
+    
+    NSMutableArray *cTags = [NSMutableArray arrayWithCapacity:tags.size()];
+    for (const std::string &tag : tags) {
+        [cTags addObject:[NSString stringWithUTF8String:tag.c_str()]];
+    }
+    callback(@[cTags]);
+}
+
+RCT_EXPORT_METHOD(
+                  createMintsBatch:(nonnull NSString*) xprv
+                  indexes:(nonnull NSArray*) indexesArray
+                  values:(nonnull NSArray*) valuesArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    const char* cXprv = [xprv cStringUsingEncoding:NSUTF8StringEncoding];
+    std::vector<int32_t> indexes;
+    std::vector<uint64_t> values;
+    for (int i = 0; i < indexesArray.count; i++) {
+        indexes.push_back([[indexesArray objectAtIndex:i] intValue]);
+        values.push_back([[valuesArray objectAtIndex:i] unsignedLongLongValue]);
+    }
+    
+    std::vector<MintBundle> bundles = CreateMintsBatch(cXprv, indexes, values);
+    
+    NSMutableArray *cBundles = [NSMutableArray arrayWithCapacity:bundles.size()];
+    for (const MintBundle &bundle : bundles) {
+        [cBundles addObject:@{
+            @"script": [NSString stringWithUTF8String:bundle.script.c_str()],
+            @"publicCoin": [NSString stringWithUTF8String:bundle.publicCoin.c_str()],
+            @"tag": [NSString stringWithUTF8String:bundle.tag.c_str()],
+            @"serialNumber": [NSString stringWithUTF8String:bundle.serialNumber.c_str()],
+            @"keyPath": [NSNumber numberWithUnsignedInt:bundle.keyPath],
+        }];
+    }
+    callback(@[cBundles]);
+}
+
+RCT_EXPORT_METHOD(
+                  openUsedSerialSet:(nonnull NSString*) path
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    const char* cPath = [path cStringUsingEncoding:NSUTF8StringEncoding];
+    uint64_t count = OpenUsedSerialSet(cPath);
+    callback(@[[NSNumber numberWithUnsignedLongLong:count]]);
+}
+
+RCT_EXPORT_METHOD(
+                  appendUsedSerials:(nonnull NSArray*) serialsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<const char *> serials;
+    for (NSString *serial in serialsArray) {
+        serials.push_back([serial cStringUsingEncoding:NSUTF8StringEncoding]);
+    }
+    
+    uint64_t count = AppendUsedSerials(serials);
+    callback(@[[NSNumber numberWithUnsignedLongLong:count]]);
+}
+
+RCT_EXPORT_METHOD(
+                  getAnonymitySetInfo:(int) setId
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::string setHash;
+    std::string blockHash;
+    size_t size = GetAnonymitySetInfo(setId, setHash, blockHash);
+    callback(@[[NSString stringWithUTF8String:setHash.c_str()],
+               [NSString stringWithUTF8String:blockHash.c_str()],
+               [NSNumber numberWithUnsignedLongLong:size]]);
+}
+
+RCT_EXPORT_METHOD(
+                  mergeAnonymitySetResponse:(int) setId
+                  response:(nonnull NSString*) response
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    const char* cResponse = [response UTF8String];
+    SetCoinRange range;
+    if (!MergeAnonymitySetResponse(setId, cResponse, strlen(cResponse), range)) {
+        callback(@[]);
+        return;
+    }
+    callback(@[[NSNumber numberWithUnsignedLongLong:range.first],
+               [NSNumber numberWithUnsignedLongLong:range.count]]);
+}
+
+RCT_EXPORT_METHOD(
+                  openAnonymitySetStore:(nonnull NSString*) directory
+                  memoryBudgetMb:(int) memoryBudgetMb
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<int32_t> setIds = OpenAnonymitySetStore([directory cStringUsingEncoding:NSUTF8StringEncoding],
+                                                        memoryBudgetMb);
+    
+    NSMutableArray *cSetIds = [NSMutableArray arrayWithCapacity:setIds.size()];
+    for (int32_t setId : setIds) {
+        [cSetIds addObject:[NSNumber numberWithInt:setId]];
+    }
+    callback(@[cSetIds]);
+}
+
+RCT_EXPORT_METHOD(
+                  updateAnonymitySet:(int) setId
+                  setHash:(nonnull NSString*) setHash
+                  blockHash:(nonnull NSString*) blockHash
+                  coins:(nonnull NSArray*) coinsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<SetCoin> coins(coinsArray.count);
+    bool valid = true;
+    for (int i = 0; i < coinsArray.count; i++) {
+        NSArray *coin = [coinsArray objectAtIndex:i];
+        id amount = [coin objectAtIndex:2];
+        // mints have a plain amount, jmints an encrypted one
+        BOOL isJMint = ![amount isKindOfClass:[NSNumber class]];
+        valid = MakeSetCoin([[coin objectAtIndex:0] UTF8String],
+                            [[coin objectAtIndex:1] UTF8String],
+                            isJMint,
+                            isJMint ? 0 : [amount unsignedLongLongValue],
+                            isJMint ? [amount UTF8String] : "",
+                            [[coin objectAtIndex:3] UTF8String],
+                            coins[i]) && valid;
+    }
+    
+    // a malformed set is not stored, it is pushed again with the next sync
+    if (valid) {
+        UpdateAnonymitySet(setId,
+                           [setHash cStringUsingEncoding:NSUTF8StringEncoding],
+                           [blockHash cStringUsingEncoding:NSUTF8StringEncoding],
+                           std::move(coins));
+    }
+    callback(@[]);
+}
+
+RCT_EXPORT_METHOD(
+                  scanMints:(nonnull NSString*) xprv
+                  startIndex:(int) startIndex
+                  gapLimit:(int) gapLimit
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    const char* cXprv = [xprv cStringUsingEncoding:NSUTF8StringEncoding];
+    std::vector<ScannedMint> mints = ScanMints(cXprv, startIndex, gapLimit);
+    
+    NSMutableArray *cMints = [NSMutableArray arrayWithCapacity:mints.size()];
+    for (const ScannedMint &mint : mints) {
+        [cMints addObject:@{
+            @"index": [NSNumber numberWithInt:mint.index],
+            @"value": [NSNumber numberWithUnsignedLongLong:mint.value],
+            @"publicCoin": [NSString stringWithUTF8String:mint.publicCoin.c_str()],
+            @"txId": [NSString stringWithUTF8String:mint.txId.c_str()],
+            @"anonymitySetId": [NSNumber numberWithInt:mint.anonymitySetId],
+            @"isJMint": [NSNumber numberWithBool:mint.isJMint],
+            @"isUsed": [NSNumber numberWithBool:mint.isUsed],
+        }];
+    }
+    callback(@[cMints]);
+}
+
+RCT_EXPORT_METHOD(
+                  selectSpendCoins:(nonnull NSArray*) amountsArray
+                  setIds:(nonnull NSArray*) setIdsArray
+                  heights:(nonnull NSArray*) heightsArray
+                  spendAmount:(double) spendAmount
+                  subtractFeeFromAmount:(BOOL) subtractFeeFromAmount
+                  strategy:(int) strategy
+                  outputCount:(int) outputCount
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<SelectionCoin> coins;
+    coins.reserve(amountsArray.count);
+    for (int i = 0; i < amountsArray.count; i++) {
+        coins.push_back({
+            [[amountsArray objectAtIndex:i] unsignedLongLongValue],
+            [[setIdsArray objectAtIndex:i] intValue],
+            [[heightsArray objectAtIndex:i] intValue]
+        });
+    }
+    
+    uint64_t fee, changeToMint;
+    std::vector<int32_t> positions = SelectSpendCoins(coins, spendAmount, subtractFeeFromAmount,
+                                                      strategy, outputCount, fee, changeToMint);
+    
+    NSMutableArray *cPositions = [NSMutableArray arrayWithCapacity:positions.size()];
+    for (int32_t position : positions) {
+        [cPositions addObject:[NSNumber numberWithInt:position]];
+    }
+    callback(@[[NSNumber numberWithUnsignedLongLong:fee],
+               [NSNumber numberWithUnsignedLongLong:changeToMint],
+               cPositions]);
+}
+
+RCT_EXPORT_METHOD(
+                  benchmarkCoinSelection:(int) coinCount
+                  rounds:(int) rounds
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::string report = BenchmarkCoinSelection(coinCount, rounds);
+    callback(@[[NSString stringWithUTF8String:report.c_str()]]);
+}
+
+RCT_EXPORT_METHOD(
+                  quickEstimateFee:(nonnull NSArray*) amountsArray
+                  setIds:(nonnull NSArray*) setIdsArray
+                  spendAmount:(double) spendAmount
+                  subtractFeeFromAmount:(BOOL) subtractFeeFromAmount
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<uint64_t> amounts;
+    std::vector<int32_t> setIds;
+    for (int i = 0; i < amountsArray.count; i++) {
+        amounts.push_back([[amountsArray objectAtIndex:i] unsignedLongLongValue]);
+        setIds.push_back([[setIdsArray objectAtIndex:i] intValue]);
+    }
+    
+    uint64_t fee = QuickEstimateFee(amounts, setIds, spendAmount, subtractFeeFromAmount);
+    callback(@[[NSNumber numberWithUnsignedLongLong:fee]]);
+}
+
+RCT_EXPORT_METHOD(
+                  getSpendProvingCost:(nonnull NSArray*) setIdsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<int32_t> setIds;
+    for (int i = 0; i < setIdsArray.count; i++) {
+        setIds.push_back([[setIdsArray objectAtIndex:i] intValue]);
+    }
+    
+    ProvingCost cost = GetSpendProvingCost(setIds);
+    callback(@[[NSNumber numberWithUnsignedLongLong:cost.deserializedPoints],
+               [NSNumber numberWithUnsignedLongLong:cost.provedPoints],
+               [NSNumber numberWithUnsignedLongLong:cost.setBytes]]);
+}
+
+RCT_EXPORT_METHOD(
+                  containsMintTags:(nonnull NSArray*) tagsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<const char *> tags;
+    for (NSString *tag in tagsArray) {
+        tags.push_back([tag cStringUsingEncoding:NSUTF8StringEncoding]);
+    }
+    
+    std::vector<bool> contains = ContainsMintTags(tags);
+    
+    NSMutableArray *cContains = [NSMutableArray arrayWithCapacity:contains.size()];
+    for (bool found : contains) {
+        [cContains addObject:[NSNumber numberWithBool:found]];
+    }
+    callback(@[cContains]);
+}
+
+RCT_EXPORT_METHOD(
+                  cacheAnonymitySetPoints:(nonnull NSArray*) setIdsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<int32_t> setIds;
+    for (int i = 0; i < setIdsArray.count; i++) {
+        setIds.push_back([[setIdsArray objectAtIndex:i] intValue]);
+    }
+    
+    size_t cached = CacheAnonymitySetPoints(setIds);
+    callback(@[[NSNumber numberWithUnsignedLongLong:cached]]);
+}
+
+RCT_EXPORT_METHOD(
+                  startSpendPrewarm:(nonnull NSArray*) setIdsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<int32_t> setIds;
+    for (int i = 0; i < setIdsArray.count; i++) {
+        setIds.push_back([[setIdsArray objectAtIndex:i] intValue]);
+    }
+    
+    StartSpendPrewarm(setIds);
+    callback(@[]);
+}
+
+RCT_EXPORT_METHOD(
+                  startSpeculativeSpend:(double) spendAmount
+                  subtractFeeFromAmount:(BOOL) subtractFeeFromAmount
+                  fee:(double) fee
+                  privateKey:(nonnull NSString*) privateKey
+                  index:(double) index
+                  coins:(nonnull NSArray*) coinsArray
+                  txHash:(nonnull NSString*) txHash
+                  resolver:(RCTPromiseResolveBlock) resolve
+                  rejecter:(RCTPromiseRejectBlock) reject
+                  ) {
+    try {
+        StartSpeculativeSpend(
+                    [txHash cStringUsingEncoding:NSUTF8StringEncoding],
+                    spendAmount,
+                    subtractFeeFromAmount,
+                    fee,
+                    [privateKey cStringUsingEncoding:NSUTF8StringEncoding],
+                    index,
+                    ToLelantusEntries(coinsArray)
+            );
+        resolve(nil);
+    } catch (...) {
+        RejectSpend(reject);
+    }
+}
+
+RCT_EXPORT_METHOD(
+                  discardSpeculativeSpend:(RCTResponseSenderBlock) callback
+                  ) {
+    DiscardSpeculativeSpend();
+    callback(@[]);
+}
+
+static std::vector<StoredCoin> ToStoredCoins(NSArray *coinsArray) {
+    std::vector<StoredCoin> coins;
+    coins.reserve(coinsArray.count);
+    
+    for (NSDictionary *coinDictionary in coinsArray) {
+        StoredCoin coin;
+        coin.index = [[coinDictionary objectForKey:@"index"] intValue];
+        coin.value = [[coinDictionary objectForKey:@"value"] unsignedLongLongValue];
+        coin.publicCoin = [[coinDictionary objectForKey:@"publicCoin"] UTF8String];
+        coin.txId = [[coinDictionary objectForKey:@"txId"] UTF8String];
+        coin.setId = [[coinDictionary objectForKey:@"anonymitySetId"] intValue];
+        coin.isUsed = [[coinDictionary objectForKey:@"isUsed"] boolValue];
+        coins.push_back(coin);
+    }
+    return coins;
+}
+
+RCT_EXPORT_METHOD(
+                  loadWalletCoins:(nonnull NSArray*) coinsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    size_t dropped = LoadWalletCoins(ToStoredCoins(coinsArray));
+    callback(@[[NSNumber numberWithUnsignedLong:dropped]]);
+}
+
+RCT_EXPORT_METHOD(
+                  putWalletCoins:(nonnull NSArray*) coinsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    size_t changed = PutWalletCoins(ToStoredCoins(coinsArray));
+    callback(@[[NSNumber numberWithUnsignedLong:changed]]);
+}
+
+RCT_EXPORT_METHOD(
+                  markWalletCoinsUsed:(nonnull NSArray*) indexesArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<int32_t> indexes;
+    for (int i = 0; i < indexesArray.count; i++) {
+        indexes.push_back([[indexesArray objectAtIndex:i] intValue]);
+    }
+    size_t marked = MarkWalletCoinsUsed(indexes);
+    callback(@[[NSNumber numberWithUnsignedLong:marked]]);
+}
+
+RCT_EXPORT_METHOD(
+                  markSpentWalletCoins:(nonnull NSString*) xprv
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    size_t marked = MarkSpentWalletCoins([xprv cStringUsingEncoding:NSUTF8StringEncoding]);
+    callback(@[[NSNumber numberWithUnsignedLong:marked]]);
+}
+
+RCT_EXPORT_METHOD(
+                  updateWalletCoinSetIds:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<std::string> txIds = UpdateWalletCoinSetIds();
+    
+    NSMutableArray *cTxIds = [NSMutableArray arrayWithCapacity:txIds.size()];
+    for (const std::string &txId : txIds) {
+        [cTxIds addObject:[NSString stringWithUTF8String:txId.c_str()]];
+    }
+    callback(@[cTxIds]);
+}
+
+RCT_EXPORT_METHOD(
+                  getWalletCoins:(int) filter
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<StoredCoin> coins = GetWalletCoins(filter);
+    
+    NSMutableArray *cCoins = [NSMutableArray arrayWithCapacity:coins.size()];
+    for (const StoredCoin &coin : coins) {
+        [cCoins addObject:@{
+            @"index": [NSNumber numberWithInt:coin.index],
+            @"value": [NSNumber numberWithUnsignedLongLong:coin.value],
+            @"publicCoin": [NSString stringWithUTF8String:coin.publicCoin.c_str()],
+            @"txId": [NSString stringWithUTF8String:coin.txId.c_str()],
+            @"anonymitySetId": [NSNumber numberWithInt:coin.setId],
+            @"isUsed": [NSNumber numberWithBool:coin.isUsed],
+        }];
+    }
+    callback(@[cCoins]);
+}
+
+RCT_EXPORT_METHOD(
+                  getUnspentCoinSetIds:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<int32_t> setIds = GetUnspentCoinSetIds();
+    
+    NSMutableArray *cSetIds = [NSMutableArray arrayWithCapacity:setIds.size()];
+    for (int32_t setId : setIds) {
+        [cSetIds addObject:[NSNumber numberWithInt:setId]];
+    }
+    callback(@[cSetIds]);
+}
+
+RCT_EXPORT_METHOD(
+                  planConsolidation:(nonnull NSArray*) amountsArray
+                  setIds:(nonnull NSArray*) setIdsArray
+                  minCoins:(int) minCoins
+                  maxInputs:(int) maxInputs
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<SelectionCoin> coins;
+    coins.reserve(amountsArray.count);
+    for (int i = 0; i < amountsArray.count; i++) {
+        coins.push_back({
+            [[amountsArray objectAtIndex:i] unsignedLongLongValue],
+            [[setIdsArray objectAtIndex:i] intValue],
+            0
+        });
+    }
+    
+    std::vector<ConsolidationStep> steps = PlanWalletConsolidation(coins, minCoins, maxInputs);
+    
+    NSMutableArray *cSteps = [NSMutableArray arrayWithCapacity:steps.size()];
+    for (const ConsolidationStep &step : steps) {
+        NSMutableArray *cPositions = [NSMutableArray arrayWithCapacity:step.selected.size()];
+        for (size_t position : step.selected) {
+            [cPositions addObject:[NSNumber numberWithUnsignedLong:position]];
+        }
+        [cSteps addObject:@{
+            @"positions": cPositions,
+            @"anonymitySetId": [NSNumber numberWithInt:step.anonymitySetId],
+            @"fee": [NSNumber numberWithUnsignedLongLong:step.fee],
+            @"mintValue": [NSNumber numberWithUnsignedLongLong:step.mintValue],
+            @"provingCost": @{
+                @"deserializedPoints": [NSNumber numberWithUnsignedLongLong:step.provingCost.deserializedPoints],
+                @"provedPoints": [NSNumber numberWithUnsignedLongLong:step.provingCost.provedPoints],
+                @"setBytes": [NSNumber numberWithUnsignedLongLong:step.provingCost.setBytes],
+            },
+        }];
+    }
+    callback(@[cSteps]);
+}
+
+RCT_EXPORT_METHOD(
+                  getConsolidationScript:(nonnull NSString*) privateKey
+                  index:(double) index
+                  coins:(nonnull NSArray*) coinsArray
+                  txHash:(nonnull NSString*) txHash
+                  resolver:(RCTPromiseResolveBlock) resolve
+                  rejecter:(RCTPromiseRejectBlock) reject
+                  ) {
+    const char *cPrivateKey = [privateKey cStringUsingEncoding:NSUTF8StringEncoding];
+    const char *cTxHash = [txHash cStringUsingEncoding:NSUTF8StringEncoding];
+    
+    std::list<LelantusEntry> coins = ToLelantusEntries(coinsArray);
+    
+    try {
+        const char *script = CreateConsolidationScript(
+                    cTxHash,
+                    cPrivateKey,
+                    index,
+                    coins
+            );
+        
+        NSString* cScript = [NSString stringWithUTF8String:script];
+        resolve(cScript);
+    } catch (...) {
+        RejectSpend(reject);
+    }
+}
+
+static NSArray *ToStringArray(const std::vector<std::string> &strings) {
+    NSMutableArray *cStrings = [NSMutableArray arrayWithCapacity:strings.size()];
+    for (const std::string &str : strings) {
+        [cStrings addObject:[NSString stringWithUTF8String:str.c_str()]];
+    }
+    return cStrings;
+}
+
+RCT_EXPORT_METHOD(
+                  parseJoinSplits:(nonnull NSArray*) rawTxsArray
+                  c:(RCTResponseSenderBlock) callback
+                  ) {
+    std::vector<std::string> rawTxs;
+    for (NSString *rawTx in rawTxsArray) {
+        rawTxs.push_back([rawTx cStringUsingEncoding:NSUTF8StringEncoding]);
+    }
+    
+    std::vector<ParsedJoinSplit> joinSplits = ParseJoinSplits(rawTxs);
+    
+    NSMutableArray *cJoinSplits = [NSMutableArray arrayWithCapacity:joinSplits.size()];
+    for (const ParsedJoinSplit &joinSplit : joinSplits) {
+        NSMutableArray *cSpentCoinIndexes = [NSMutableArray arrayWithCapacity:joinSplit.spentCoinIndexes.size()];
+        for (int32_t index : joinSplit.spentCoinIndexes) {
+            [cSpentCoinIndexes addObject:[NSNumber numberWithInt:index]];
+        }
+        [cJoinSplits addObject:@{
+            @"valid": [NSNumber numberWithBool:joinSplit.valid],
+            @"fee": [NSNumber numberWithUnsignedLongLong:joinSplit.fee],
+            @"serialNumbers": ToStringArray(joinSplit.serialNumbers),
+            @"spentCoinIndexes": cSpentCoinIndexes,
+            @"publicCoins": ToStringArray(joinSplit.publicCoins),
+            @"encryptedValues": ToStringArray(joinSplit.encryptedValues),
+        }];
+    }
+    callback(@[cJoinSplits]);
+}
+
 @end
@@ -0,0 +1,53 @@
+#ifndef ORG_FIRO_LELANTUS_SERIALSET_H
+#define ORG_FIRO_LELANTUS_SERIALSET_H
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+typedef std::array<unsigned char, 32> Serial;
+
+/*
+ * Open addressed (linear probing) hash set of 32 byte lelantus serials.
+ *
+ * Every appended serial is also written to a flat file, so the set can be rebuilt
+ * on the next start and the number of appended records can be used as the offset
+ * for lelantus.getusedcoinserials.
+ */
+class SerialSet {
+public:
+	// Loads the serials stored in the file and keeps it open for appends.
+	bool Open(const std::string &path);
+
+	void Close();
+
+	const std::string &GetPath() const { return path; }
+
+	// Number of appended records, duplicates and malformed entries included.
+	uint64_t GetCount() const { return count; }
+
+	void Append(const std::vector<Serial> &serials);
+
+	bool Contains(const Serial &serial) const;
+
+private:
+	void Insert(const Serial &serial);
+
+	void Grow();
+
+	size_t Find(const Serial &serial) const;
+
+	std::vector<Serial> slots;
+	std::vector<unsigned char> occupied;
+	size_t size = 0;
+
+	std::string path;
+	FILE *file = nullptr;
+	uint64_t count = 0;
+};
+
+bool DecodeSerialBase64(const char *base64, Serial &out);
+
+#endif //ORG_FIRO_LELANTUS_SERIALSET_H
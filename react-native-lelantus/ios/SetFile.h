@@ -0,0 +1,55 @@
+#ifndef ORG_FIRO_LELANTUS_SETFILE_H
+#define ORG_FIRO_LELANTUS_SETFILE_H
+
+#include "SetStore.h"
+
+#include <string>
+
+/*
+ * Binary file of one anonymity set:
+ * magic(4) | version(4) | set id(4) | set hash(32) | block hash(32) | coin count(8) |
+ * hash state(SetHashState::SERIALIZED_SIZE), followed by the packed SetCoin records.
+ * Coins are only ever appended and the header is rewritten after them, so a torn
+ * append loses the new coins only.
+ */
+
+/*
+ * Read-only mapping of a set file, pages are read by the OS on first access only.
+ */
+class SetFileView {
+public:
+	SetFileView() = default;
+
+	~SetFileView();
+
+	SetFileView(const SetFileView &) = delete;
+
+	SetFileView &operator=(const SetFileView &) = delete;
+
+	// Maps the file and fills header with everything but the coins, false if it is missing or broken.
+	bool Map(const std::string &path, StoredAnonymitySet &header);
+
+	const SetCoin *GetCoins() const { return coins; }
+
+	size_t GetCount() const { return count; }
+
+private:
+	void *mapping = nullptr;
+	size_t size = 0;
+	const SetCoin *coins = nullptr;
+	size_t count = 0;
+};
+
+// Copies the whole file, false if it is missing or broken.
+bool ReadSetFile(const std::string &path, StoredAnonymitySet &set);
+
+// Reads the coin at the given position without mapping the file.
+bool ReadSetFileCoin(const std::string &path, size_t position, SetCoin &coin);
+
+// Replaces the file with the whole set.
+bool WriteSetFile(const std::string &path, const StoredAnonymitySet &set);
+
+// Appends the coins after the first storedCount ones and updates the header.
+bool AppendSetFile(const std::string &path, const StoredAnonymitySet &set, size_t storedCount);
+
+#endif //ORG_FIRO_LELANTUS_SETFILE_H
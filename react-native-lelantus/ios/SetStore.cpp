@@ -0,0 +1,422 @@
+#include "SetStore.h"
+#include "SetFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+static int DecodeHexChar(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+std::string EncodeHex(const unsigned char *data, size_t size) {
+	std::string hex(size * 2, '0');
+	for (size_t i = 0; i < size; i++) {
+		hex[2 * i] = HEX_DIGITS[data[i] >> 4];
+		hex[2 * i + 1] = HEX_DIGITS[data[i] & 0x0f];
+	}
+	return hex;
+}
+
+bool DecodeHex(const char *hex, unsigned char *out, size_t size) {
+	if (strlen(hex) != size * 2) {
+		return false;
+	}
+	for (size_t i = 0; i < size; i++) {
+		int high = DecodeHexChar(hex[2 * i]);
+		int low = DecodeHexChar(hex[2 * i + 1]);
+		if (high < 0 || low < 0) {
+			return false;
+		}
+		out[i] = (unsigned char) ((high << 4) | low);
+	}
+	return true;
+}
+
+uint64_t SetCoin::GetValue() const {
+	if (isJMint) {
+		return 0;
+	}
+	uint64_t amount = 0;
+	for (size_t i = 8; i-- > 0;) {
+		amount = (amount << 8) | value[i];
+	}
+	return amount;
+}
+
+bool MakeSetCoin(
+		const char *publicCoin,
+		const char *tag,
+		bool isJMint,
+		uint64_t value,
+		const char *encryptedValue,
+		const char *txId,
+		SetCoin &coin
+) {
+	memset(&coin, 0, sizeof(coin));
+	coin.isJMint = isJMint ? 1 : 0;
+	if (isJMint) {
+		size_t size = strlen(encryptedValue) / 2;
+		if (size > sizeof(coin.value) || !DecodeHex(encryptedValue, coin.value, size)) {
+			return false;
+		}
+		coin.encryptedValueSize = (unsigned char) size;
+	} else {
+		for (size_t i = 0; i < 8; i++) {
+			coin.value[i] = (unsigned char) (value >> (8 * i));
+		}
+	}
+	return DecodeHex(publicCoin, coin.publicCoin, sizeof(coin.publicCoin))
+		   && DecodeHex(tag, coin.tag, sizeof(coin.tag))
+		   && DecodeHex(txId, coin.txId, sizeof(coin.txId));
+}
+
+void SetHashState::Reset() {
+	SHA256_Init(&context);
+}
+
+void SetHashState::Append(const SetCoin *coins, size_t count) {
+	SHA256_Update(&context, coins, count * sizeof(SetCoin));
+}
+
+std::array<unsigned char, SHA256_DIGEST_LENGTH> SetHashState::GetDigest() const {
+	// finalizing a copy keeps the state resumable
+	SHA256_CTX final = context;
+	std::array<unsigned char, SHA256_DIGEST_LENGTH> digest;
+	SHA256_Final(digest.data(), &final);
+	return digest;
+}
+
+static void WriteLittleEndian(unsigned char *out, uint64_t value, size_t size) {
+	for (size_t i = 0; i < size; i++) {
+		out[i] = (value >> (8 * i)) & 0xff;
+	}
+}
+
+static uint64_t ReadLittleEndian(const unsigned char *in, size_t size) {
+	uint64_t value = 0;
+	for (size_t i = 0; i < size; i++) {
+		value |= (uint64_t) in[i] << (8 * i);
+	}
+	return value;
+}
+
+void SetHashState::Serialize(unsigned char *out) const {
+	for (size_t i = 0; i < 8; i++) {
+		WriteLittleEndian(out + 4 * i, context.h[i], 4);
+	}
+	WriteLittleEndian(out + 32, ((uint64_t) context.Nh << 32) | context.Nl, 8);
+	WriteLittleEndian(out + 40, context.num, 4);
+	memcpy(out + 44, context.data, SHA256_CBLOCK);
+}
+
+bool SetHashState::Deserialize(const unsigned char *in) {
+	uint64_t bits = ReadLittleEndian(in + 32, 8);
+	uint64_t buffered = ReadLittleEndian(in + 40, 4);
+	// the buffer holds the tail of the message that doesn't fill a block
+	if (buffered >= SHA256_CBLOCK || buffered != (bits / 8) % SHA256_CBLOCK) {
+		return false;
+	}
+	SHA256_Init(&context);
+	for (size_t i = 0; i < 8; i++) {
+		context.h[i] = (uint32_t) ReadLittleEndian(in + 4 * i, 4);
+	}
+	context.Nl = (uint32_t) bits;
+	context.Nh = (uint32_t) (bits >> 32);
+	context.num = (unsigned int) buffered;
+	memcpy(context.data, in + 44, SHA256_CBLOCK);
+	return true;
+}
+
+size_t MintTagHash::operator()(const MintTag &tag) const {
+	// tags are hashes already
+	size_t h;
+	memcpy(&h, tag.data(), sizeof(h));
+	return h;
+}
+
+bool SetStore::Open(const std::string &path) {
+	Clear();
+	directory = path;
+
+	mkdir(directory.c_str(), 0700);
+	DIR *dir = opendir(directory.c_str());
+	if (dir == nullptr) {
+		return false;
+	}
+	while (dirent *file = readdir(dir)) {
+		int32_t setId;
+		int length = 0;
+		if (sscanf(file->d_name, "set_%d.bin%n", &setId, &length) != 1
+			|| (size_t) length != strlen(file->d_name)) {
+			continue;
+		}
+		Entry entry;
+		SetFileView view;
+		if (!view.Map(GetSetPath(setId), entry.set) || entry.set.setId != setId) {
+			continue;
+		}
+		// only the tags and public coins are read, the coins stay on disk
+		entry.count = view.GetCount();
+		AddToIndex(setId, view.GetCoins(), 0, entry.count);
+		sets.emplace(setId, std::move(entry));
+	}
+	closedir(dir);
+	return true;
+}
+
+void SetStore::SetMemoryBudget(size_t bytes) {
+	memoryBudget = bytes;
+	Evict(0);
+}
+
+void SetStore::Update(StoredAnonymitySet &&set) {
+	size_t storedCount = 0;
+	if (Entry *entry = Load(set.setId)) {
+		const std::vector<SetCoin> &stored = entry->set.coins;
+		// sets only grow, the stored coins stay in front
+		if (stored.size() <= set.coins.size()
+			&& memcmp(stored.data(), set.coins.data(), stored.size() * sizeof(SetCoin)) == 0) {
+			storedCount = stored.size();
+			set.hashState = entry->set.hashState;
+		} else {
+			RemoveFromIndex(set.setId);
+		}
+		loadedBytes -= stored.size() * sizeof(SetCoin);
+		sets.erase(set.setId);
+	}
+	if (storedCount == 0) {
+		set.hashState.Reset();
+	}
+	set.hashState.Append(set.coins.data() + storedCount, set.coins.size() - storedCount);
+
+	if (!directory.empty()) {
+		std::string path = GetSetPath(set.setId);
+		if (storedCount == 0 || !AppendSetFile(path, set, storedCount)) {
+			WriteSetFile(path, set);
+		}
+	}
+
+	int32_t setId = set.setId;
+	Entry &entry = sets[setId];
+	entry.count = set.coins.size();
+	entry.loaded = true;
+	entry.lastUse = ++useCounter;
+	entry.set = std::move(set);
+	loadedBytes += entry.count * sizeof(SetCoin);
+	AddToIndex(setId, entry.set.coins.data(), storedCount, entry.count);
+	Evict(setId);
+}
+
+SetCoinRange SetStore::Append(
+		int32_t setId,
+		const std::string &setHash,
+		const std::string &blockHash,
+		const std::vector<SetCoin> &coins
+) {
+	Entry *entry = Load(setId);
+	if (entry == nullptr) {
+		entry = &sets[setId];
+		entry->set.setId = setId;
+		entry->set.hashState.Reset();
+		entry->loaded = true;
+		entry->lastUse = ++useCounter;
+	}
+	StoredAnonymitySet &set = entry->set;
+	SetCoinRange range{entry->count, coins.size()};
+	set.setHash = setHash;
+	set.blockHash = blockHash;
+	set.coins.insert(set.coins.end(), coins.begin(), coins.end());
+	set.hashState.Append(coins.data(), coins.size());
+	entry->count = set.coins.size();
+	loadedBytes += coins.size() * sizeof(SetCoin);
+
+	if (!directory.empty()) {
+		std::string path = GetSetPath(setId);
+		if (range.first == 0 || !AppendSetFile(path, set, range.first)) {
+			WriteSetFile(path, set);
+		}
+	}
+
+	AddToIndex(setId, set.coins.data(), range.first, entry->count);
+	Evict(setId);
+	return range;
+}
+
+const StoredAnonymitySet *SetStore::GetSet(int32_t setId) {
+	Entry *entry = Load(setId);
+	return entry != nullptr ? &entry->set : nullptr;
+}
+
+bool SetStore::GetSetInfo(
+		int32_t setId,
+		std::string &setHash,
+		std::string &blockHash,
+		size_t &count
+) const {
+	auto it = sets.find(setId);
+	if (it == sets.end()) {
+		return false;
+	}
+	setHash = it->second.set.setHash;
+	blockHash = it->second.set.blockHash;
+	count = it->second.count;
+	return true;
+}
+
+bool SetStore::Verify(int32_t setId) {
+	const StoredAnonymitySet *set = GetSet(setId);
+	if (set == nullptr) {
+		return false;
+	}
+	SetHashState recomputed;
+	recomputed.Reset();
+	recomputed.Append(set->coins.data(), set->coins.size());
+	return recomputed.GetDigest() == set->hashState.GetDigest();
+}
+
+void SetStore::Remove(int32_t setId) {
+	auto it = sets.find(setId);
+	if (it == sets.end()) {
+		return;
+	}
+	loadedBytes -= it->second.set.coins.size() * sizeof(SetCoin);
+	sets.erase(it);
+	RemoveFromIndex(setId);
+	if (!directory.empty()) {
+		remove(GetSetPath(setId).c_str());
+		remove(GetPointCachePath(setId).c_str());
+	}
+}
+
+std::string SetStore::GetPointCachePath(int32_t setId) const {
+	if (directory.empty()) {
+		return std::string();
+	}
+	return directory + "/set_" + std::to_string(setId) + ".points";
+}
+
+std::vector<int32_t> SetStore::GetSetIds() const {
+	std::vector<int32_t> setIds;
+	for (const auto &set : sets) {
+		setIds.push_back(set.first);
+	}
+	return setIds;
+}
+
+std::map<int32_t, size_t> SetStore::GetSetSizes() const {
+	std::map<int32_t, size_t> sizes;
+	for (const auto &set : sets) {
+		sizes.emplace(set.first, set.second.count);
+	}
+	return sizes;
+}
+
+bool SetStore::ContainsTag(const MintTag &tag) const {
+	int32_t setId;
+	uint32_t position;
+	return tagIndex.FindNewest(tag, setId, position);
+}
+
+bool SetStore::FindByTag(const MintTag &tag, int32_t &setId, SetCoin &coin) const {
+	uint32_t position;
+	if (!tagIndex.FindNewest(tag, setId, position)) {
+		return false;
+	}
+	const Entry &entry = sets.at(setId);
+	if (entry.loaded) {
+		coin = entry.set.coins[position];
+		return true;
+	}
+	return ReadSetFileCoin(GetSetPath(setId), position, coin);
+}
+
+std::vector<int32_t> SetStore::FindNewestSets(const std::vector<PublicCoinKey> &publicCoins) const {
+	std::vector<int32_t> setIds(publicCoins.size(), 0);
+	for (size_t i = 0; i < publicCoins.size(); i++) {
+		uint32_t position;
+		if (!publicCoinIndex.FindNewest(publicCoins[i], setIds[i], position)) {
+			setIds[i] = 0;
+		}
+	}
+	return setIds;
+}
+
+void SetStore::Clear() {
+	sets.clear();
+	tagIndex.Clear();
+	publicCoinIndex.Clear();
+	directory.clear();
+	loadedBytes = 0;
+}
+
+SetStore::Entry *SetStore::Load(int32_t setId) {
+	auto it = sets.find(setId);
+	if (it == sets.end()) {
+		return nullptr;
+	}
+	Entry &entry = it->second;
+	entry.lastUse = ++useCounter;
+	if (!entry.loaded) {
+		StoredAnonymitySet set;
+		if (!ReadSetFile(GetSetPath(setId), set) || set.coins.size() != entry.count) {
+			// the file went away or changed under us, the set is fetched again
+			sets.erase(it);
+			RemoveFromIndex(setId);
+			return nullptr;
+		}
+		entry.set.coins = std::move(set.coins);
+		entry.loaded = true;
+		loadedBytes += entry.count * sizeof(SetCoin);
+	}
+	Evict(setId);
+	return &entry;
+}
+
+void SetStore::Evict(int32_t keepSetId) {
+	// without a directory the coins are only kept here
+	if (directory.empty()) {
+		return;
+	}
+	while (loadedBytes + GetIndexBytes() > memoryBudget) {
+		Entry *oldest = nullptr;
+		for (auto &set : sets) {
+			if (set.second.loaded && set.first != keepSetId
+				&& (oldest == nullptr || set.second.lastUse < oldest->lastUse)) {
+				oldest = &set.second;
+			}
+		}
+		if (oldest == nullptr) {
+			break;
+		}
+		loadedBytes -= oldest->set.coins.size() * sizeof(SetCoin);
+		std::vector<SetCoin>().swap(oldest->set.coins);
+		oldest->loaded = false;
+	}
+}
+
+void SetStore::AddToIndex(int32_t setId, const SetCoin *coins, size_t from, size_t to) {
+	for (size_t i = from; i < to; i++) {
+		MintTag tag;
+		memcpy(tag.data(), coins[i].tag, tag.size());
+		tagIndex.Insert(tag, setId, (uint32_t) i);
+		PublicCoinKey publicCoin;
+		memcpy(publicCoin.data(), coins[i].publicCoin, publicCoin.size());
+		publicCoinIndex.Insert(publicCoin, setId, (uint32_t) i);
+	}
+}
+
+void SetStore::RemoveFromIndex(int32_t setId) {
+	tagIndex.RemoveSet(setId);
+	publicCoinIndex.RemoveSet(setId);
+}
+
+std::string SetStore::GetSetPath(int32_t setId) const {
+	return directory + "/set_" + std::to_string(setId) + ".bin";
+}
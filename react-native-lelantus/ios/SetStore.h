@@ -0,0 +1,215 @@
+#ifndef ORG_FIRO_LELANTUS_SETSTORE_H
+#define ORG_FIRO_LELANTUS_SETSTORE_H
+
+#include "CoinIndex.h"
+#include "openssl/sha.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef std::array<unsigned char, 32> MintTag;
+typedef std::array<unsigned char, 34> PublicCoinKey;
+
+/*
+ * Coin of an anonymity set in the packed layout of the set files. Tags and tx ids
+ * are in the byte order of the hex strings the JS side uses.
+ */
+struct SetCoin {
+	unsigned char publicCoin[34];
+	unsigned char tag[32];
+	unsigned char isJMint;
+	unsigned char encryptedValueSize;
+	// little endian amount of mints, encrypted value of jmints
+	unsigned char value[48];
+	unsigned char txId[32];
+
+	// Amount of a mint, 0 for jmints.
+	uint64_t GetValue() const;
+};
+
+static_assert(sizeof(SetCoin) == 148, "set coins are stored as packed 148 byte records");
+
+// Fills coin from the hex strings the JS side uses, false if one of them is malformed.
+bool MakeSetCoin(
+		const char *publicCoin,
+		const char *tag,
+		bool isJMint,
+		uint64_t value,
+		const char *encryptedValue,
+		const char *txId,
+		SetCoin &coin
+);
+
+std::string EncodeHex(const unsigned char *data, size_t size);
+
+// Decodes exactly size bytes.
+bool DecodeHex(const char *hex, unsigned char *out, size_t size);
+
+/*
+ * Resumable SHA-256 over the coin records of a set in store order. It is extended
+ * with every append, so it holds the digest of the coins as they were accepted and
+ * SetStore::Verify can tell a set whose file changed since. It is kept in the set
+ * file because hashing the coins again on open would accept whatever is on disk.
+ */
+struct SetHashState {
+	// little endian chaining words(32) | message bits(8) | buffered bytes(4) | buffer(64)
+	static const size_t SERIALIZED_SIZE = 108;
+
+	SHA256_CTX context;
+
+	void Reset();
+
+	void Append(const SetCoin *coins, size_t count);
+
+	std::array<unsigned char, SHA256_DIGEST_LENGTH> GetDigest() const;
+
+	// Writes SERIALIZED_SIZE bytes, independent of the layout of SHA256_CTX.
+	void Serialize(unsigned char *out) const;
+
+	// Reads what Serialize wrote, false if the buffered byte count is out of range.
+	bool Deserialize(const unsigned char *in);
+};
+
+/*
+ * Coins are kept in the reverse order of the JS set. Fetched coins are put in front
+ * of the JS set, so here they are appended. A coin keeps its position for good, which
+ * is also its record number in the set file.
+ */
+struct StoredAnonymitySet {
+	int32_t setId;
+	std::string setHash;
+	std::string blockHash;
+	std::vector<SetCoin> coins;
+	SetHashState hashState;
+};
+
+// Coins [first, first + count) of a set.
+struct SetCoinRange {
+	size_t first;
+	size_t count;
+};
+
+struct MintTagHash {
+	size_t operator()(const MintTag &tag) const;
+};
+
+// Default bytes of loaded coins and indexes, about three full sets with their index entries.
+static const size_t DEFAULT_SET_MEMORY_BUDGET = 64 << 20;
+
+/*
+ * Anonymity sets kept on the native side. They are indexed by mint tag, so restore
+ * scans don't search every set for every derived tag, and by public coin, so pending
+ * mints find their set without a search either. Once opened on a directory every set
+ * is kept there in a binary file and only the set headers and the indexes stay in
+ * memory. Coins of a set are read when the set is asked for, and the least recently
+ * used sets are dropped again once the loaded coins and the indexes exceed the memory
+ * budget. The indexes are never dropped.
+ */
+class SetStore {
+public:
+	/*
+	 * Reads the headers and tags of the set files of the directory, updates are written
+	 * there from now on.
+	 */
+	bool Open(const std::string &directory);
+
+	const std::string &GetDirectory() const { return directory; }
+
+	// The set asked for last stays loaded even if it is larger than the budget.
+	void SetMemoryBudget(size_t bytes);
+
+	size_t GetLoadedBytes() const { return loadedBytes; }
+
+	size_t GetIndexBytes() const { return tagIndex.GetMemoryBytes() + publicCoinIndex.GetMemoryBytes(); }
+
+	void Update(StoredAnonymitySet &&set);
+
+	/*
+	 * Appends coins to the set, creating it if needed, in amortized O(1) per coin.
+	 * Only the new coins are written to the set file and indexed. Returns their range.
+	 */
+	SetCoinRange Append(
+			int32_t setId,
+			const std::string &setHash,
+			const std::string &blockHash,
+			const std::vector<SetCoin> &coins
+	);
+
+	/*
+	 * Loads the set if needed, nullptr when it is not in the store. The set stays valid
+	 * until another one is loaded.
+	 */
+	const StoredAnonymitySet *GetSet(int32_t setId);
+
+	// Hashes and coin count without loading the set, false when it is not in the store.
+	bool GetSetInfo(
+			int32_t setId,
+			std::string &setHash,
+			std::string &blockHash,
+			size_t &count
+	) const;
+
+	std::vector<int32_t> GetSetIds() const;
+
+	// Number of coins of every stored set.
+	std::map<int32_t, size_t> GetSetSizes() const;
+
+	/*
+	 * Hashes the coins of the set again and compares them with its hash state, false
+	 * if the set is missing or its coins changed since they were accepted.
+	 */
+	bool Verify(int32_t setId);
+
+	// Drops the set and its files, the next sync fetches it again.
+	void Remove(int32_t setId);
+
+	// Path of the point cache of the set, empty when the store has no directory.
+	std::string GetPointCachePath(int32_t setId) const;
+
+	bool ContainsTag(const MintTag &tag) const;
+
+	/*
+	 * Coin with the given tag from the newest set that contains it. The coin is read
+	 * from the set file when the set is not loaded, sets are never loaded here.
+	 */
+	bool FindByTag(const MintTag &tag, int32_t &setId, SetCoin &coin) const;
+
+	// Id of the newest set holding each public coin, 0 for coins in no set. O(1) per coin.
+	std::vector<int32_t> FindNewestSets(const std::vector<PublicCoinKey> &publicCoins) const;
+
+	void Clear();
+
+private:
+	struct Entry {
+		// coins are empty while the set is not loaded
+		StoredAnonymitySet set;
+		size_t count = 0;
+		bool loaded = false;
+		uint64_t lastUse = 0;
+	};
+
+	// nullptr when the set is not in the store or its file can't be read.
+	Entry *Load(int32_t setId);
+
+	// Drops least recently used sets other than keepSetId until the budget is met.
+	void Evict(int32_t keepSetId);
+
+	void AddToIndex(int32_t setId, const SetCoin *coins, size_t from, size_t to);
+
+	void RemoveFromIndex(int32_t setId);
+
+	std::string GetSetPath(int32_t setId) const;
+
+	std::map<int32_t, Entry> sets;
+	CoinIndex<sizeof(SetCoin::tag)> tagIndex;
+	CoinIndex<sizeof(SetCoin::publicCoin)> publicCoinIndex;
+	std::string directory;
+	size_t memoryBudget = DEFAULT_SET_MEMORY_BUDGET;
+	size_t loadedBytes = 0;
+	uint64_t useCounter = 0;
+};
+
+#endif //ORG_FIRO_LELANTUS_SETSTORE_H
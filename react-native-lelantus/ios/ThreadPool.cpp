@@ -0,0 +1,68 @@
+#include "ThreadPool.h"
+
+#include <sys/resource.h>
+#ifdef __APPLE__
+#include <pthread.h>
+#else
+#include <unistd.h>
+#endif
+
+ThreadPool::ThreadPool(size_t threadCount) {
+	threadCount = std::max<size_t>(threadCount, 1);
+	workers.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++) {
+		workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+		stopping = true;
+	}
+	tasksCondition.notify_all();
+	for (auto &worker : workers) {
+		worker.join();
+	}
+}
+
+std::future<void> ThreadPool::Submit(std::function<void()> task) {
+	std::packaged_task<void()> packagedTask(std::move(task));
+	std::future<void> future = packagedTask.get_future();
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+		tasks.push(std::move(packagedTask));
+	}
+	tasksCondition.notify_one();
+	return future;
+}
+
+void ThreadPool::WorkerLoop() {
+	while (true) {
+		std::packaged_task<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(tasksMutex);
+			tasksCondition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+			if (stopping && tasks.empty()) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
+
+ThreadPool &GetThreadPool() {
+	static ThreadPool pool(std::thread::hardware_concurrency());
+	return pool;
+}
+
+void LowerThreadPriority() {
+#ifdef __APPLE__
+	pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#else
+	// on Linux the nice value of a thread id applies to that thread only
+	setpriority(PRIO_PROCESS, gettid(), 10);
+#endif
+}
@@ -0,0 +1,86 @@
+#ifndef ORG_FIRO_LELANTUS_THREADPOOL_H
+#define ORG_FIRO_LELANTUS_THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed size pool of worker threads shared by the native batch functions.
+ */
+class ThreadPool {
+public:
+	explicit ThreadPool(size_t threadCount);
+
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	size_t GetThreadCount() const { return workers.size(); }
+
+	std::future<void> Submit(std::function<void()> task);
+
+	/*
+	 * Calls fn(i) for every i in [begin, end), split into one contiguous chunk per
+	 * worker, and returns when all of them are done. If fn throws, the first
+	 * exception is rethrown once every chunk has finished, the chunks reference fn
+	 * until then. Must not be called from a task running on this pool.
+	 */
+	template<typename F>
+	void ParallelFor(size_t begin, size_t end, F fn) {
+		if (begin >= end) {
+			return;
+		}
+		size_t chunks = std::min(GetThreadCount(), end - begin);
+		size_t chunkSize = (end - begin + chunks - 1) / chunks;
+		std::vector<std::future<void>> futures;
+		futures.reserve(chunks);
+		for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += chunkSize) {
+			size_t chunkEnd = std::min(chunkBegin + chunkSize, end);
+			futures.push_back(Submit([chunkBegin, chunkEnd, &fn]() {
+				for (size_t i = chunkBegin; i < chunkEnd; i++) {
+					fn(i);
+				}
+			}));
+		}
+		std::exception_ptr error;
+		for (auto &future : futures) {
+			try {
+				future.get();
+			} catch (...) {
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+private:
+	void WorkerLoop();
+
+	std::vector<std::thread> workers;
+	std::queue<std::packaged_task<void()>> tasks;
+	std::mutex tasksMutex;
+	std::condition_variable tasksCondition;
+	bool stopping = false;
+};
+
+// Pool with one thread per core, created on first use.
+ThreadPool &GetThreadPool();
+
+// Lowers the priority of the calling thread, for background jobs the user doesn't wait for.
+void LowerThreadPriority();
+
+#endif //ORG_FIRO_LELANTUS_THREADPOOL_H
@@ -0,0 +1,82 @@
+#include "CoinIndex.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+typedef CoinIndex<32> TagIndex;
+
+static TagIndex::Key MakeKey(unsigned int seed) {
+	TagIndex::Key key{};
+	// the hash reads bytes 0 to 8, vary the others too
+	for (size_t i = 0; i < 4; i++) {
+		key[i] = key[20 + i] = (unsigned char) (seed >> (8 * i));
+	}
+	key[31] = 1;
+	return key;
+}
+
+TEST(CoinIndexTest, EmptyIndexFindsNothing) {
+	TagIndex index;
+	int32_t setId;
+	uint32_t position;
+	EXPECT_FALSE(index.FindNewest(MakeKey(1), setId, position));
+	EXPECT_EQ(0u, index.GetMemoryBytes());
+}
+
+TEST(CoinIndexTest, InsertedKeysAreFound) {
+	TagIndex index;
+	for (unsigned int i = 0; i < 5000; i++) {
+		index.Insert(MakeKey(i), 1 + (int32_t) (i % 3), i);
+	}
+
+	for (unsigned int i = 0; i < 5000; i++) {
+		int32_t setId = 0;
+		uint32_t position = 0;
+		ASSERT_TRUE(index.FindNewest(MakeKey(i), setId, position)) << i;
+		EXPECT_EQ(1 + (int32_t) (i % 3), setId);
+		EXPECT_EQ(i, position);
+	}
+	int32_t setId;
+	uint32_t position;
+	EXPECT_FALSE(index.FindNewest(MakeKey(5000), setId, position));
+	// grown to keep the load factor under 3/4
+	EXPECT_GE(index.GetMemoryBytes(), 5000 * 4 / 3 * (sizeof(TagIndex::Key) + 8));
+}
+
+TEST(CoinIndexTest, KeyInSeveralSetsFindsNewest) {
+	TagIndex index;
+	index.Insert(MakeKey(1), 2, 10);
+	index.Insert(MakeKey(1), 5, 20);
+	index.Insert(MakeKey(1), 3, 30);
+
+	int32_t setId;
+	uint32_t position;
+	ASSERT_TRUE(index.FindNewest(MakeKey(1), setId, position));
+	EXPECT_EQ(5, setId);
+	EXPECT_EQ(20u, position);
+}
+
+TEST(CoinIndexTest, RemovedSetIsNotFound) {
+	TagIndex index;
+	for (unsigned int i = 0; i < 2000; i++) {
+		index.Insert(MakeKey(i), 1, i);
+	}
+	index.Insert(MakeKey(7), 4, 70);
+	index.Insert(MakeKey(5000), 4, 0);
+
+	index.RemoveSet(4);
+	int32_t setId;
+	uint32_t position;
+	ASSERT_TRUE(index.FindNewest(MakeKey(7), setId, position));
+	EXPECT_EQ(1, setId);
+	EXPECT_EQ(7u, position);
+	EXPECT_FALSE(index.FindNewest(MakeKey(5000), setId, position));
+	for (unsigned int i = 0; i < 2000; i++) {
+		EXPECT_TRUE(index.FindNewest(MakeKey(i), setId, position)) << i;
+	}
+
+	index.Clear();
+	EXPECT_FALSE(index.FindNewest(MakeKey(7), setId, position));
+	EXPECT_EQ(0u, index.GetMemoryBytes());
+}
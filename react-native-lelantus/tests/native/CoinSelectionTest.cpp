@@ -0,0 +1,187 @@
+#include "CoinSelection.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <vector>
+
+static const uint64_t COIN = 100000000;
+
+TEST(CoinSelectionTest, FailsWhenCoinsDontCover) {
+	std::vector<SelectionCoin> coins = {{COIN, 1, 10}, {COIN, 1, 11}};
+	for (int strategy = COIN_SELECTION_DEFAULT; strategy <= COIN_SELECTION_SET_AWARE; strategy++) {
+		CoinSelection selection;
+		EXPECT_FALSE(SelectCoins(coins, 3 * COIN, true, (CoinSelectionStrategy) strategy, selection));
+		EXPECT_TRUE(selection.selected.empty());
+	}
+}
+
+TEST(CoinSelectionTest, DefaultTakesSmallestCoinCoveringTheRest) {
+	std::vector<SelectionCoin> coins = {{COIN, 1, 10}, {COIN / 2, 1, 11}, {COIN / 10, 1, 12}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, COIN / 5, true, COIN_SELECTION_DEFAULT, selection));
+	EXPECT_EQ(std::vector<size_t>({1}), selection.selected);
+	EXPECT_EQ(EstimateJoinSplitSize(1, 1), selection.fee);
+	EXPECT_EQ(COIN / 2 - COIN / 5, selection.changeToMint);
+}
+
+TEST(CoinSelectionTest, DefaultAddsFeeToAmount) {
+	std::vector<SelectionCoin> coins = {{COIN, 1, 10}, {COIN / 2, 1, 11}, {COIN / 10, 1, 12}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, COIN / 5, false, COIN_SELECTION_DEFAULT, selection));
+	EXPECT_EQ(std::vector<size_t>({1}), selection.selected);
+	EXPECT_EQ(EstimateJoinSplitSize(1, 1), selection.fee);
+	EXPECT_EQ(COIN / 2 - COIN / 5 - selection.fee, selection.changeToMint);
+}
+
+TEST(CoinSelectionTest, DefaultTakesLargestCoinsWhileShort) {
+	std::vector<SelectionCoin> coins = {{COIN / 10, 1, 10}, {COIN / 2, 1, 11}, {COIN, 1, 12}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, COIN + COIN / 20, true, COIN_SELECTION_DEFAULT, selection));
+	EXPECT_EQ(std::vector<size_t>({2, 0}), selection.selected);
+	EXPECT_EQ(COIN / 20, selection.changeToMint);
+}
+
+TEST(CoinSelectionTest, MinInputsSwapsLastCoinForSmallestThatCovers) {
+	std::vector<SelectionCoin> coins = {{COIN, 1, 10}, {8 * COIN, 1, 11}, {3 * COIN, 1, 12}, {5 * COIN, 1, 13}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, 9 * COIN, true, COIN_SELECTION_MIN_INPUTS, selection));
+	EXPECT_EQ(std::vector<size_t>({1, 0}), selection.selected);
+	EXPECT_EQ(0u, selection.changeToMint);
+}
+
+TEST(CoinSelectionTest, ExactMatchNeedsNoChange) {
+	std::vector<SelectionCoin> coins = {
+			{7 * COIN, 1, 10}, {5 * COIN, 1, 11}, {4 * COIN, 1, 12}, {COIN, 1, 13}
+	};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, 9 * COIN, true, COIN_SELECTION_EXACT_MATCH, selection));
+	EXPECT_EQ(std::vector<size_t>({1, 2}), selection.selected);
+	EXPECT_EQ(0u, selection.changeToMint);
+	EXPECT_EQ(EstimateJoinSplitSize(2, 1), selection.fee);
+}
+
+TEST(CoinSelectionTest, ExactMatchCoversTheFee) {
+	std::vector<SelectionCoin> coins = {
+			{7 * COIN, 1, 10}, {5 * COIN, 1, 11}, {4 * COIN, 1, 12}, {COIN, 1, 13}
+	};
+	uint64_t spendAmount = 9 * COIN - EstimateJoinSplitSize(2, 1);
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, spendAmount, false, COIN_SELECTION_EXACT_MATCH, selection));
+	EXPECT_EQ(std::vector<size_t>({1, 2}), selection.selected);
+	EXPECT_EQ(0u, selection.changeToMint);
+	EXPECT_EQ(EstimateJoinSplitSize(2, 1), selection.fee);
+}
+
+TEST(CoinSelectionTest, ExactMatchFallsBackToDefault) {
+	std::vector<SelectionCoin> coins = {{COIN, 1, 10}};
+	CoinSelection exact;
+	CoinSelection fallback;
+	ASSERT_TRUE(SelectCoins(coins, COIN / 5, true, COIN_SELECTION_EXACT_MATCH, exact));
+	ASSERT_TRUE(SelectCoins(coins, COIN / 5, true, COIN_SELECTION_DEFAULT, fallback));
+	EXPECT_EQ(fallback.selected, exact.selected);
+	EXPECT_EQ(fallback.fee, exact.fee);
+	EXPECT_EQ(fallback.changeToMint, exact.changeToMint);
+}
+
+TEST(CoinSelectionTest, SizeModelMatchesLiblelantusEstimate) {
+	// 1054 bytes of proofs, 2560 per input and 179 for the rest of the transaction
+	for (size_t inputs = 1; inputs <= 10; inputs++) {
+		EXPECT_EQ(1054 + 2560 * inputs + 179, EstimateJoinSplitSize(inputs, 1));
+	}
+}
+
+TEST(CoinSelectionTest, SizeModelCountsSetsAndOutputs) {
+	uint64_t base = EstimateJoinSplitSize(2, 1);
+	EXPECT_EQ(base + 68, EstimateJoinSplitSize(2, 2));
+	EXPECT_EQ(base + 2 * 68, EstimateJoinSplitSize(2, 3));
+	EXPECT_EQ(base + 2 * 34, EstimateJoinSplitSize(2, 1, 3));
+	EXPECT_EQ(base - 34, EstimateJoinSplitSize({2, 1, 0, 1}));
+	EXPECT_EQ(base - 60, EstimateJoinSplitSize({2, 1, 1, 0}));
+	// no sets counts as one
+	EXPECT_EQ(base, EstimateJoinSplitSize(2, 0));
+}
+
+TEST(CoinSelectionTest, FeeFollowsSizeModel) {
+	std::vector<SelectionCoin> coins = {{COIN, 1, 10}, {COIN, 2, 11}, {COIN, 3, 12}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, 2 * COIN + COIN / 2, false, COIN_SELECTION_DEFAULT, selection));
+	EXPECT_EQ(3u, selection.selected.size());
+	EXPECT_EQ(EstimateJoinSplitSize(3, 3), selection.fee);
+	EXPECT_EQ(3 * COIN - 2 * COIN - COIN / 2 - selection.fee, selection.changeToMint);
+
+	// every extra output adds to the fee, the proof is paid once
+	std::map<int32_t, size_t> setSizes;
+	ASSERT_TRUE(SelectCoins(coins, 2 * COIN + COIN / 2, false, COIN_SELECTION_DEFAULT, setSizes, 4,
+							selection));
+	EXPECT_EQ(EstimateJoinSplitSize(3, 3, 4), selection.fee);
+}
+
+TEST(CoinSelectionTest, FeeCanPullInAnotherCoin) {
+	// the coin alone covers the amount but not the fee
+	std::vector<SelectionCoin> coins = {{COIN, 1, 10}, {COIN / 10, 1, 11}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, COIN - 1000, false, COIN_SELECTION_DEFAULT, selection));
+	EXPECT_EQ(std::vector<size_t>({0, 1}), selection.selected);
+	EXPECT_EQ(EstimateJoinSplitSize(2, 1), selection.fee);
+}
+
+// The default selection spans two sets here, all of set 2 covers the amount alone.
+static std::vector<SelectionCoin> SplitSetCoins() {
+	return {{4 * COIN, 2, 10}, {2 * COIN, 2, 11}, {5 * COIN, 1, 12}};
+}
+
+TEST(CoinSelectionTest, SelectionIsOrderedBySet) {
+	std::vector<SelectionCoin> coins = SplitSetCoins();
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, 6 * COIN, true, COIN_SELECTION_DEFAULT, selection));
+	EXPECT_EQ(std::vector<size_t>({2, 1}), selection.selected);
+	EXPECT_EQ(EstimateJoinSplitSize(2, 2), selection.fee);
+}
+
+TEST(CoinSelectionTest, MinSetsKeepsInputsInOneSet) {
+	std::vector<SelectionCoin> coins = SplitSetCoins();
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, 6 * COIN, true, COIN_SELECTION_MIN_SETS, selection));
+	EXPECT_EQ(std::vector<size_t>({0, 1}), selection.selected);
+	EXPECT_EQ(EstimateJoinSplitSize(2, 1), selection.fee);
+}
+
+TEST(CoinSelectionTest, MinSetsAddsRichestSetsWhenOneIsShort) {
+	std::vector<SelectionCoin> coins = {{COIN, 1, 10}, {3 * COIN, 2, 11}, {2 * COIN, 3, 12}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, 4 * COIN, true, COIN_SELECTION_MIN_SETS, selection));
+	// sets 2 and 3 hold more than set 1
+	EXPECT_EQ(std::vector<size_t>({1, 2}), selection.selected);
+}
+
+TEST(CoinSelectionTest, PredictsProvingCostPerSet) {
+	std::vector<SelectionCoin> coins = SplitSetCoins();
+	std::map<int32_t, size_t> setSizes = {{2, 1000}};
+
+	ProvingCost cost = PredictProvingCost(coins, {0, 1}, setSizes);
+	EXPECT_EQ(1000u, cost.deserializedPoints);
+	EXPECT_EQ(2000u, cost.provedPoints);
+	EXPECT_EQ(1000u * 34, cost.setBytes);
+
+	// set 1 is not in the sizes and counts as full
+	cost = PredictProvingCost(coins, {2, 1}, setSizes);
+	EXPECT_EQ(1000u + 65000, cost.deserializedPoints);
+	EXPECT_EQ(1000u + 65000, cost.provedPoints);
+}
+
+TEST(CoinSelectionTest, SetAwarePrefersFewerFullSets) {
+	std::vector<SelectionCoin> coins = SplitSetCoins();
+	std::map<int32_t, size_t> setSizes = {{1, 65000}, {2, 65000}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, 6 * COIN, true, COIN_SELECTION_SET_AWARE, setSizes, selection));
+	EXPECT_EQ(std::vector<size_t>({0, 1}), selection.selected);
+}
+
+TEST(CoinSelectionTest, SetAwareKeepsDefaultWhenSmallSetIsCheaper) {
+	std::vector<SelectionCoin> coins = SplitSetCoins();
+	std::map<int32_t, size_t> setSizes = {{1, 100}, {2, 65000}};
+	CoinSelection selection;
+	ASSERT_TRUE(SelectCoins(coins, 6 * COIN, true, COIN_SELECTION_SET_AWARE, setSizes, selection));
+	EXPECT_EQ(std::vector<size_t>({2, 1}), selection.selected);
+}
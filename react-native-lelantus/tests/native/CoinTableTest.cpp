@@ -0,0 +1,156 @@
+#include "CoinTable.h"
+#include "SetStore.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const std::string SET_HASH(64, 'a');
+static const std::string BLOCK_HASH(64, 'b');
+
+static std::string PublicCoinHex(unsigned char seed) {
+	return EncodeHex(PublicCoinKey{seed, 1}.data(), sizeof(PublicCoinKey));
+}
+
+static StoredCoin MakeCoin(int32_t index, uint64_t value, int32_t setId) {
+	StoredCoin coin;
+	coin.index = index;
+	coin.value = value;
+	coin.publicCoin = PublicCoinHex((unsigned char) index);
+	coin.txId = std::string(63, '0') + std::to_string(index % 10);
+	coin.setId = setId;
+	return coin;
+}
+
+static Serial MakeSerial(unsigned char seed) {
+	Serial serial{};
+	// the hash reads bytes 8 to 16
+	serial[0] = serial[8] = seed;
+	return serial;
+}
+
+static SetCoin MakeSetCoin(unsigned char seed) {
+	SetCoin coin;
+	memset(&coin, 0, sizeof(coin));
+	coin.publicCoin[0] = seed;
+	coin.publicCoin[1] = 1;
+	coin.tag[0] = coin.txId[0] = seed;
+	return coin;
+}
+
+static std::vector<int32_t> Indexes(const std::vector<StoredCoin> &coins) {
+	std::vector<int32_t> indexes;
+	for (const StoredCoin &coin : coins) {
+		indexes.push_back(coin.index);
+	}
+	return indexes;
+}
+
+TEST(CoinTableTest, LoadKeepsCoinOfNewestSet) {
+	CoinTable table;
+	EXPECT_EQ(2u, table.Load({
+			MakeCoin(1, 100, 2),
+			MakeCoin(1, 100, 3),
+			MakeCoin(2, 200, 3),
+			MakeCoin(2, 200, 1),
+	}));
+
+	std::vector<StoredCoin> coins = table.Get(COIN_FILTER_ALL);
+	ASSERT_EQ(2u, coins.size());
+	EXPECT_EQ(3, coins[0].setId);
+	EXPECT_EQ(3, coins[1].setId);
+	EXPECT_EQ(std::vector<int32_t>({3}), table.GetUnspentSetIds());
+}
+
+TEST(CoinTableTest, FiltersCoinsByState) {
+	CoinTable table;
+	StoredCoin used = MakeCoin(3, 300, 1);
+	used.isUsed = true;
+	table.Load({MakeCoin(1, 100, 1), MakeCoin(2, 200, COIN_SET_NONE), used, MakeCoin(4, 0, 1)});
+
+	EXPECT_EQ(std::vector<int32_t>({1, 2, 3, 4}), Indexes(table.Get(COIN_FILTER_ALL)));
+	EXPECT_EQ(std::vector<int32_t>({1}), Indexes(table.Get(COIN_FILTER_UNSPENT)));
+	EXPECT_EQ(std::vector<int32_t>({2}), Indexes(table.Get(COIN_FILTER_UNCONFIRMED)));
+}
+
+TEST(CoinTableTest, PutKeepsSerialWhileValueIsUnchanged) {
+	CoinTable table;
+	table.Load({MakeCoin(1, 100, 1), MakeCoin(2, 200, 1)});
+	table.SetSerial(1, 100, MakeSerial(1));
+	table.SetSerial(2, 200, MakeSerial(2));
+
+	// a new set id keeps the serial, a new value drops it
+	EXPECT_EQ(2u, table.Put({MakeCoin(1, 100, 2), MakeCoin(2, 250, 1)}));
+	EXPECT_EQ(std::vector<int32_t>({1}), table.FindSerials({MakeSerial(1), MakeSerial(2)}));
+	std::vector<std::pair<int32_t, uint64_t>> withoutSerial = table.GetUnspentWithoutSerial();
+	ASSERT_EQ(1u, withoutSerial.size());
+	EXPECT_EQ(2, withoutSerial[0].first);
+	EXPECT_EQ(250u, withoutSerial[0].second);
+
+	// unchanged coins are not stored again
+	EXPECT_EQ(0u, table.Put({MakeCoin(1, 100, 2)}));
+}
+
+TEST(CoinTableTest, SetSerialIgnoresChangedValue) {
+	CoinTable table;
+	table.Load({MakeCoin(1, 100, 1)});
+	table.SetSerial(1, 90, MakeSerial(1));
+	table.SetSerial(7, 100, MakeSerial(7));
+
+	EXPECT_TRUE(table.FindSerials({MakeSerial(1), MakeSerial(7)}).empty());
+	EXPECT_EQ(1u, table.GetUnspentWithoutSerial().size());
+}
+
+TEST(CoinTableTest, UpdateSetIdsMovesCoinsToNewerSetsOnly) {
+	SetStore store;
+	store.Append(1, SET_HASH, BLOCK_HASH, {MakeSetCoin(1), MakeSetCoin(2), MakeSetCoin(3)});
+	store.Append(2, SET_HASH, BLOCK_HASH, {MakeSetCoin(2)});
+
+	CoinTable table;
+	StoredCoin used = MakeCoin(4, 400, COIN_SET_NONE);
+	used.publicCoin = PublicCoinHex(3);
+	used.isUsed = true;
+	table.Load({MakeCoin(1, 100, COIN_SET_NONE), MakeCoin(2, 200, 1), MakeCoin(3, 300, 5), used,
+				MakeCoin(9, 900, COIN_SET_NONE)});
+
+	std::vector<std::string> moved = table.UpdateSetIds(store);
+	EXPECT_EQ(std::vector<std::string>({MakeCoin(1, 0, 0).txId, MakeCoin(2, 0, 0).txId}), moved);
+
+	std::vector<StoredCoin> coins = table.Get(COIN_FILTER_ALL);
+	// coin 3 is in set 1 of the store but already in a newer one, used coins stay
+	EXPECT_EQ(1, coins[0].setId);
+	EXPECT_EQ(2, coins[1].setId);
+	EXPECT_EQ(5, coins[2].setId);
+	EXPECT_EQ(COIN_SET_NONE, coins[3].setId);
+	EXPECT_EQ(COIN_SET_NONE, coins[4].setId);
+	EXPECT_EQ(std::vector<int32_t>({1, 2, 5}), table.GetUnspentSetIds());
+	EXPECT_EQ(std::vector<int32_t>({9}), Indexes(table.Get(COIN_FILTER_UNCONFIRMED)));
+
+	EXPECT_TRUE(table.UpdateSetIds(store).empty());
+}
+
+TEST(CoinTableTest, UnspentSetsFollowMarkUsed) {
+	CoinTable table;
+	table.Load({MakeCoin(1, 100, 1), MakeCoin(2, 200, 1), MakeCoin(3, 300, 2)});
+	table.SetSerial(2, 200, MakeSerial(2));
+	table.SetSerial(3, 300, MakeSerial(3));
+	EXPECT_EQ(std::vector<int32_t>({1, 2}), table.GetUnspentSetIds());
+
+	EXPECT_EQ(1u, table.MarkUsed({1, 1, 8}));
+	EXPECT_EQ(std::vector<int32_t>({1, 2}), table.GetUnspentSetIds());
+
+	// a serial set again still counts the coin once
+	table.SetSerial(2, 200, MakeSerial(4));
+	EXPECT_EQ(1u, table.MarkUsedSerials({MakeSerial(4), MakeSerial(2)}));
+	EXPECT_EQ(std::vector<int32_t>({2}), table.GetUnspentSetIds());
+
+	EXPECT_EQ(1u, table.MarkUsedSerials({MakeSerial(3)}));
+	EXPECT_TRUE(table.GetUnspentSetIds().empty());
+	EXPECT_TRUE(table.Get(COIN_FILTER_UNSPENT).empty());
+	EXPECT_TRUE(table.GetUnspentSerials().empty());
+
+	// used coins stay findable by serial
+	EXPECT_EQ(std::vector<int32_t>({2, 3}), table.FindSerials({MakeSerial(4), MakeSerial(3)}));
+}
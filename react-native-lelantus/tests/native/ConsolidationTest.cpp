@@ -0,0 +1,62 @@
+#include "Consolidation.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <vector>
+
+static const uint64_t MILLI = 100000;
+
+TEST(ConsolidationTest, FeeHasNoTransparentOutput) {
+	EXPECT_EQ(EstimateJoinSplitSize({3, 1, 0, 1}), EstimateConsolidationFee(3, 1));
+	EXPECT_EQ(EstimateJoinSplitSize(3, 1) - 34, EstimateConsolidationFee(3, 1));
+}
+
+TEST(ConsolidationTest, MergesSmallestCoinsOfCrowdedSets) {
+	std::vector<SelectionCoin> coins = {
+			{30 * MILLI, 1, 10},
+			{10 * MILLI, 1, 11},
+			{50 * MILLI, 1, 12},
+			{20 * MILLI, 1, 13},
+			{40 * MILLI, 1, 14},
+			// worth less than the fee it adds to a spend
+			{1000, 1, 15},
+			// alone in its set
+			{10 * MILLI, 2, 16},
+	};
+	std::map<int32_t, size_t> setSizes = {{1, 5000}};
+
+	std::vector<ConsolidationStep> steps = PlanConsolidation(coins, setSizes, 3, 2);
+	ASSERT_EQ(2u, steps.size());
+
+	EXPECT_EQ(std::vector<size_t>({1, 3}), steps[0].selected);
+	EXPECT_EQ(1, steps[0].anonymitySetId);
+	EXPECT_EQ(EstimateConsolidationFee(2, 1), steps[0].fee);
+	EXPECT_EQ(30 * MILLI - steps[0].fee, steps[0].mintValue);
+	EXPECT_EQ(5000u, steps[0].provingCost.deserializedPoints);
+	EXPECT_EQ(10000u, steps[0].provingCost.provedPoints);
+
+	// the largest coin is left, a step of one coin merges nothing
+	EXPECT_EQ(std::vector<size_t>({0, 4}), steps[1].selected);
+	EXPECT_EQ(70 * MILLI - steps[1].fee, steps[1].mintValue);
+}
+
+TEST(ConsolidationTest, SkipsSetsWithFewCoins) {
+	std::vector<SelectionCoin> coins = {{10 * MILLI, 1, 10}, {10 * MILLI, 1, 11}, {10 * MILLI, 2, 12}};
+	EXPECT_TRUE(PlanConsolidation(coins, {}, 3, 10).empty());
+
+	// fewer than two coins never makes a step
+	std::vector<ConsolidationStep> steps = PlanConsolidation(coins, {}, 0, 0);
+	ASSERT_EQ(1u, steps.size());
+	EXPECT_EQ(std::vector<size_t>({0, 1}), steps[0].selected);
+	// set 1 is not in the sizes and counts as full
+	EXPECT_EQ(65000u, steps[0].provingCost.deserializedPoints);
+}
+
+TEST(ConsolidationTest, SkipsStepsTheFeeWouldEat) {
+	// each coin is worth more than an input, the two together not more than the whole fee
+	uint64_t amount = EstimateConsolidationFee(2, 1) / 2 - 1;
+	ASSERT_GT(amount, EstimateConsolidationFee(2, 1) - EstimateConsolidationFee(1, 1));
+	std::vector<SelectionCoin> coins = {{amount, 1, 10}, {amount, 1, 11}};
+	EXPECT_TRUE(PlanConsolidation(coins, {}, 2, 10).empty());
+}
@@ -0,0 +1,175 @@
+#include "JoinSplitParser.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+typedef std::vector<unsigned char> Bytes;
+
+// Serializes a transaction the way firo does, amounts and sequences are zero.
+class TransactionWriter {
+public:
+	TransactionWriter(int16_t version, uint16_t type) {
+		WriteUInt32((uint32_t) (uint16_t) version | (uint32_t) type << 16);
+	}
+
+	TransactionWriter &Inputs(const std::vector<Bytes> &scripts) {
+		WriteCompactSize(scripts.size());
+		for (const Bytes &script : scripts) {
+			data.insert(data.end(), 36, 0x11);
+			WriteBytes(script);
+			WriteUInt32(0xffffffff);
+		}
+		return *this;
+	}
+
+	TransactionWriter &Outputs(const std::vector<Bytes> &scripts) {
+		WriteCompactSize(scripts.size());
+		for (const Bytes &script : scripts) {
+			data.insert(data.end(), 8, 0);
+			WriteBytes(script);
+		}
+		return *this;
+	}
+
+	TransactionWriter &LockTime() {
+		WriteUInt32(0);
+		return *this;
+	}
+
+	TransactionWriter &Payload(const Bytes &payload) {
+		WriteBytes(payload);
+		return *this;
+	}
+
+	Bytes data;
+
+private:
+	void WriteUInt32(uint32_t value) {
+		for (size_t i = 0; i < 4; i++) {
+			data.push_back((unsigned char) (value >> (8 * i)));
+		}
+	}
+
+	void WriteCompactSize(uint64_t value) {
+		if (value < 0xfd) {
+			data.push_back((unsigned char) value);
+			return;
+		}
+		data.push_back(0xfd);
+		data.push_back((unsigned char) value);
+		data.push_back((unsigned char) (value >> 8));
+	}
+
+	void WriteBytes(const Bytes &bytes) {
+		WriteCompactSize(bytes.size());
+		data.insert(data.end(), bytes.begin(), bytes.end());
+	}
+};
+
+static Bytes JMintScript(unsigned char fill, size_t encryptedValueSize) {
+	Bytes script = {OP_LELANTUSJMINT};
+	script.insert(script.end(), 34, fill);
+	script.insert(script.end(), encryptedValueSize, (unsigned char) (fill + 1));
+	return script;
+}
+
+static const Bytes P2PKH_SCRIPT = {0x76, 0xa9, 0x14, 0x01, 0x02, 0x88, 0xac};
+
+static bool Parse(const Bytes &data, RawTransaction &tx) {
+	return ParseRawTransaction(data.data(), data.size(), tx);
+}
+
+TEST(JoinSplitParserTest, ReadsJoinSplitOfSpecialTransaction) {
+	Bytes joinSplit(300, 0x42);
+	Bytes data = TransactionWriter(3, TRANSACTION_LELANTUS)
+			.Inputs({{OP_LELANTUSJOINSPLITPAYLOAD}})
+			.Outputs({P2PKH_SCRIPT, JMintScript(0x20, 16)})
+			.LockTime()
+			.Payload(joinSplit)
+			.data;
+
+	RawTransaction tx;
+	ASSERT_TRUE(Parse(data, tx));
+	EXPECT_EQ(3, tx.version);
+	EXPECT_EQ(TRANSACTION_LELANTUS, tx.type);
+	ASSERT_EQ(2u, tx.outputScripts.size());
+	EXPECT_EQ(P2PKH_SCRIPT, tx.outputScripts[0]);
+
+	Bytes read;
+	ASSERT_TRUE(GetJoinSplitData(tx, read));
+	EXPECT_EQ(joinSplit, read);
+}
+
+TEST(JoinSplitParserTest, ReadsJoinSplitOfInputScript) {
+	Bytes script = {OP_LELANTUSJOINSPLIT};
+	script.insert(script.end(), 300, 0x42);
+	Bytes data = TransactionWriter(2, 0)
+			.Inputs({script})
+			.Outputs({P2PKH_SCRIPT})
+			.LockTime()
+			.data;
+
+	RawTransaction tx;
+	ASSERT_TRUE(Parse(data, tx));
+	EXPECT_TRUE(tx.extraPayload.empty());
+	Bytes read;
+	ASSERT_TRUE(GetJoinSplitData(tx, read));
+	EXPECT_EQ(Bytes(script.begin() + 1, script.end()), read);
+}
+
+TEST(JoinSplitParserTest, IgnoresOtherTransactions) {
+	RawTransaction tx;
+	Bytes read;
+
+	ASSERT_TRUE(Parse(TransactionWriter(2, 0).Inputs({{0x47, 0x30}}).Outputs({P2PKH_SCRIPT})
+							  .LockTime().data, tx));
+	EXPECT_FALSE(GetJoinSplitData(tx, read));
+
+	// a JoinSplit has exactly one input
+	ASSERT_TRUE(Parse(TransactionWriter(2, 0).Inputs({{OP_LELANTUSJOINSPLIT, 1}, {OP_LELANTUSJOINSPLIT, 1}})
+							  .Outputs({}).LockTime().data, tx));
+	EXPECT_FALSE(GetJoinSplitData(tx, read));
+
+	// the payload opcode needs the payload
+	ASSERT_TRUE(Parse(TransactionWriter(3, TRANSACTION_LELANTUS).Inputs({{OP_LELANTUSJOINSPLITPAYLOAD}})
+							  .Outputs({}).LockTime().Payload({}).data, tx));
+	EXPECT_FALSE(GetJoinSplitData(tx, read));
+}
+
+TEST(JoinSplitParserTest, RejectsMalformedTransactions) {
+	Bytes data = TransactionWriter(2, 0)
+			.Inputs({{OP_LELANTUSJOINSPLIT, 1, 2, 3}})
+			.Outputs({P2PKH_SCRIPT})
+			.LockTime()
+			.data;
+	RawTransaction tx;
+	ASSERT_TRUE(Parse(data, tx));
+
+	for (size_t size = 0; size < data.size(); size++) {
+		EXPECT_FALSE(ParseRawTransaction(data.data(), size, tx)) << "truncated to " << size;
+	}
+	Bytes trailing(data);
+	trailing.push_back(0);
+	EXPECT_FALSE(Parse(trailing, tx));
+
+	// an input count no transaction of this size can hold
+	Bytes huge = {2, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f};
+	EXPECT_FALSE(Parse(huge, tx));
+}
+
+TEST(JoinSplitParserTest, SplitsJMintScript) {
+	PublicCoinKey publicCoin;
+	Bytes encryptedValue;
+	ASSERT_TRUE(ParseJMintScript(JMintScript(0x20, 16), publicCoin, encryptedValue));
+	for (unsigned char byte : publicCoin) {
+		EXPECT_EQ(0x20, byte);
+	}
+	EXPECT_EQ(Bytes(16, 0x21), encryptedValue);
+
+	EXPECT_TRUE(ParseJMintScript(JMintScript(0x20, sizeof(SetCoin::value)), publicCoin, encryptedValue));
+	EXPECT_FALSE(ParseJMintScript(JMintScript(0x20, sizeof(SetCoin::value) + 1), publicCoin, encryptedValue));
+	EXPECT_FALSE(ParseJMintScript(JMintScript(0x20, 0), publicCoin, encryptedValue));
+	EXPECT_FALSE(ParseJMintScript(P2PKH_SCRIPT, publicCoin, encryptedValue));
+}
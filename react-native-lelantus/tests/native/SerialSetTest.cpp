@@ -0,0 +1,131 @@
+#include "SerialSet.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static Serial MakeSerial(unsigned int seed) {
+	Serial serial;
+	for (size_t i = 0; i < serial.size(); i++) {
+		serial[i] = (unsigned char) (i + 1);
+	}
+	// the hash reads bytes 8 to 16, vary the others too
+	for (size_t i = 0; i < 4; i++) {
+		serial[i] = serial[8 + i] = serial[20 + i] = (unsigned char) (seed >> (8 * i));
+	}
+	return serial;
+}
+
+class SerialSetTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		path = ::testing::TempDir() + "serials_test.bin";
+		remove(path.c_str());
+	}
+
+	void TearDown() override {
+		remove(path.c_str());
+	}
+
+	std::string path;
+};
+
+TEST_F(SerialSetTest, OpenCreatesEmptySet) {
+	SerialSet set;
+	ASSERT_TRUE(set.Open(path));
+	EXPECT_EQ(0u, set.GetCount());
+	EXPECT_FALSE(set.Contains(MakeSerial(1)));
+}
+
+TEST_F(SerialSetTest, AppendedSerialsAreFound) {
+	SerialSet set;
+	ASSERT_TRUE(set.Open(path));
+	std::vector<Serial> serials;
+	for (unsigned int i = 0; i < 5000; i++) {
+		serials.push_back(MakeSerial(i));
+	}
+	set.Append(serials);
+
+	EXPECT_EQ(serials.size(), set.GetCount());
+	for (const Serial &serial : serials) {
+		EXPECT_TRUE(set.Contains(serial));
+	}
+	EXPECT_FALSE(set.Contains(MakeSerial(5000)));
+}
+
+TEST_F(SerialSetTest, DuplicatesAndEmptySerialsAreCounted) {
+	SerialSet set;
+	ASSERT_TRUE(set.Open(path));
+	set.Append({MakeSerial(1), MakeSerial(1), Serial()});
+
+	// the count is the offset for the next fetch, so every record counts
+	EXPECT_EQ(3u, set.GetCount());
+	EXPECT_TRUE(set.Contains(MakeSerial(1)));
+	EXPECT_FALSE(set.Contains(Serial()));
+}
+
+TEST_F(SerialSetTest, ReopenReadsAppendedSerials) {
+	{
+		SerialSet set;
+		ASSERT_TRUE(set.Open(path));
+		set.Append({MakeSerial(1), MakeSerial(2)});
+		set.Append({MakeSerial(3)});
+	}
+
+	SerialSet set;
+	ASSERT_TRUE(set.Open(path));
+	EXPECT_EQ(3u, set.GetCount());
+	EXPECT_TRUE(set.Contains(MakeSerial(1)));
+	EXPECT_TRUE(set.Contains(MakeSerial(2)));
+	EXPECT_TRUE(set.Contains(MakeSerial(3)));
+	EXPECT_FALSE(set.Contains(MakeSerial(4)));
+}
+
+TEST_F(SerialSetTest, TruncatedFileKeepsWholeRecords) {
+	{
+		SerialSet set;
+		ASSERT_TRUE(set.Open(path));
+		set.Append({MakeSerial(1), MakeSerial(2), MakeSerial(3)});
+	}
+	// cut the last record in half, the header still claims three
+	FILE *file = fopen(path.c_str(), "r+b");
+	ASSERT_NE(nullptr, file);
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fclose(file);
+	ASSERT_EQ(0, truncate(path.c_str(), size - 16));
+
+	SerialSet set;
+	ASSERT_TRUE(set.Open(path));
+	EXPECT_EQ(2u, set.GetCount());
+	EXPECT_TRUE(set.Contains(MakeSerial(1)));
+	EXPECT_TRUE(set.Contains(MakeSerial(2)));
+	EXPECT_FALSE(set.Contains(MakeSerial(3)));
+}
+
+TEST_F(SerialSetTest, BrokenFileStartsOver) {
+	FILE *file = fopen(path.c_str(), "wb");
+	ASSERT_NE(nullptr, file);
+	fputs("not a serial set", file);
+	fclose(file);
+
+	SerialSet set;
+	ASSERT_TRUE(set.Open(path));
+	EXPECT_EQ(0u, set.GetCount());
+	set.Append({MakeSerial(1)});
+	EXPECT_TRUE(set.Contains(MakeSerial(1)));
+}
+
+TEST_F(SerialSetTest, DecodesBase64Serials) {
+	Serial serial;
+	// 32 bytes of 0x00..0x1f
+	ASSERT_TRUE(DecodeSerialBase64("AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8=", serial));
+	for (size_t i = 0; i < serial.size(); i++) {
+		EXPECT_EQ(i, serial[i]);
+	}
+	EXPECT_FALSE(DecodeSerialBase64("AAEC", serial));
+	EXPECT_FALSE(DecodeSerialBase64("AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8!", serial));
+}
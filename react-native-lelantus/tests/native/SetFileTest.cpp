@@ -0,0 +1,254 @@
+#include "SetFile.h"
+#include "SetStore.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static const std::string SET_HASH(64, 'a');
+static const std::string BLOCK_HASH(64, 'b');
+
+static SetCoin MakeCoin(unsigned int seed) {
+	SetCoin coin;
+	memset(&coin, 0, sizeof(coin));
+	for (size_t i = 0; i < 4; i++) {
+		coin.publicCoin[i] = coin.tag[i] = coin.txId[i] = (unsigned char) (seed >> (8 * i));
+	}
+	coin.publicCoin[33] = 1;
+	coin.value[0] = (unsigned char) seed;
+	return coin;
+}
+
+static std::vector<SetCoin> MakeCoins(unsigned int first, size_t count) {
+	std::vector<SetCoin> coins;
+	for (size_t i = 0; i < count; i++) {
+		coins.push_back(MakeCoin(first + (unsigned int) i));
+	}
+	return coins;
+}
+
+static StoredAnonymitySet MakeSet(int32_t setId, size_t count) {
+	StoredAnonymitySet set;
+	set.setId = setId;
+	set.setHash = SET_HASH;
+	set.blockHash = BLOCK_HASH;
+	set.coins = MakeCoins(1, count);
+	set.hashState.Reset();
+	set.hashState.Append(set.coins.data(), set.coins.size());
+	return set;
+}
+
+static bool SameCoins(const std::vector<SetCoin> &a, const std::vector<SetCoin> &b) {
+	return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(SetCoin)) == 0;
+}
+
+class SetFileTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		directory = ::testing::TempDir() + "set_file_test";
+		path = directory + "/set_7.bin";
+		mkdir(directory.c_str(), 0700);
+		remove(path.c_str());
+	}
+
+	void TearDown() override {
+		remove(path.c_str());
+		rmdir(directory.c_str());
+	}
+
+	std::string directory;
+	std::string path;
+};
+
+TEST_F(SetFileTest, WrittenSetReadsBack) {
+	StoredAnonymitySet set = MakeSet(7, 100);
+	ASSERT_TRUE(WriteSetFile(path, set));
+
+	StoredAnonymitySet read;
+	ASSERT_TRUE(ReadSetFile(path, read));
+	EXPECT_EQ(7, read.setId);
+	EXPECT_EQ(SET_HASH, read.setHash);
+	EXPECT_EQ(BLOCK_HASH, read.blockHash);
+	EXPECT_TRUE(SameCoins(set.coins, read.coins));
+	EXPECT_EQ(set.hashState.GetDigest(), read.hashState.GetDigest());
+
+	SetCoin coin;
+	ASSERT_TRUE(ReadSetFileCoin(path, 42, coin));
+	EXPECT_EQ(0, memcmp(&set.coins[42], &coin, sizeof(coin)));
+	EXPECT_FALSE(ReadSetFileCoin(path, 100, coin));
+}
+
+TEST_F(SetFileTest, AppendedCoinsReadBack) {
+	StoredAnonymitySet set = MakeSet(7, 10);
+	ASSERT_TRUE(WriteSetFile(path, set));
+	std::vector<SetCoin> more = MakeCoins(100, 5);
+	set.coins.insert(set.coins.end(), more.begin(), more.end());
+	set.hashState.Append(more.data(), more.size());
+	ASSERT_TRUE(AppendSetFile(path, set, 10));
+
+	StoredAnonymitySet read;
+	ASSERT_TRUE(ReadSetFile(path, read));
+	EXPECT_TRUE(SameCoins(set.coins, read.coins));
+	EXPECT_EQ(set.hashState.GetDigest(), read.hashState.GetDigest());
+}
+
+TEST_F(SetFileTest, TornAppendLosesNewCoinsOnly) {
+	StoredAnonymitySet set = MakeSet(7, 10);
+	ASSERT_TRUE(WriteSetFile(path, set));
+	// coins written without the header update that follows them
+	std::vector<SetCoin> more = MakeCoins(100, 3);
+	FILE *file = fopen(path.c_str(), "ab");
+	ASSERT_NE(nullptr, file);
+	fwrite(more.data(), sizeof(SetCoin), more.size(), file);
+	fclose(file);
+
+	StoredAnonymitySet read;
+	ASSERT_TRUE(ReadSetFile(path, read));
+	EXPECT_TRUE(SameCoins(set.coins, read.coins));
+}
+
+TEST_F(SetFileTest, BrokenFilesAreRejected) {
+	StoredAnonymitySet read;
+	EXPECT_FALSE(ReadSetFile(path, read));
+
+	FILE *file = fopen(path.c_str(), "wb");
+	ASSERT_NE(nullptr, file);
+	std::string junk(200, 'x');
+	fwrite(junk.data(), 1, junk.size(), file);
+	fclose(file);
+	EXPECT_FALSE(ReadSetFile(path, read));
+
+	// a header claiming more coins than the file holds
+	StoredAnonymitySet set = MakeSet(7, 10);
+	ASSERT_TRUE(WriteSetFile(path, set));
+	struct stat info;
+	ASSERT_EQ(0, stat(path.c_str(), &info));
+	ASSERT_EQ(0, truncate(path.c_str(), info.st_size - (off_t) sizeof(SetCoin)));
+	EXPECT_FALSE(ReadSetFile(path, read));
+
+	// a version this build does not know
+	ASSERT_TRUE(WriteSetFile(path, set));
+	file = fopen(path.c_str(), "r+b");
+	ASSERT_NE(nullptr, file);
+	uint32_t version = 2;
+	fseek(file, 4, SEEK_SET);
+	fwrite(&version, sizeof(version), 1, file);
+	fclose(file);
+	EXPECT_FALSE(ReadSetFile(path, read));
+}
+
+TEST_F(SetFileTest, StoreReopensSetsFromDirectory) {
+	{
+		SetStore store;
+		ASSERT_TRUE(store.Open(directory));
+		store.Append(7, SET_HASH, BLOCK_HASH, MakeCoins(1, 20));
+		store.Append(7, SET_HASH, BLOCK_HASH, MakeCoins(21, 5));
+	}
+
+	SetStore store;
+	ASSERT_TRUE(store.Open(directory));
+	std::string setHash;
+	std::string blockHash;
+	size_t count = 0;
+	ASSERT_TRUE(store.GetSetInfo(7, setHash, blockHash, count));
+	EXPECT_EQ(25u, count);
+	EXPECT_EQ(0u, store.GetLoadedBytes());
+
+	MintTag tag = {};
+	memcpy(tag.data(), MakeCoin(22).tag, tag.size());
+	int32_t setId;
+	SetCoin coin;
+	ASSERT_TRUE(store.FindByTag(tag, setId, coin));
+	EXPECT_EQ(7, setId);
+	EXPECT_EQ(0, memcmp(MakeCoin(22).publicCoin, coin.publicCoin, sizeof(coin.publicCoin)));
+
+	const StoredAnonymitySet *set = store.GetSet(7);
+	ASSERT_NE(nullptr, set);
+	EXPECT_TRUE(SameCoins(MakeCoins(1, 25), set->coins));
+	EXPECT_TRUE(store.Verify(7));
+}
+
+TEST_F(SetFileTest, IndexesCountAgainstMemoryBudget) {
+	SetStore store;
+	ASSERT_TRUE(store.Open(directory));
+	store.Append(7, SET_HASH, BLOCK_HASH, MakeCoins(1, 25));
+	store.Append(8, SET_HASH, BLOCK_HASH, MakeCoins(101, 25));
+	EXPECT_GT(store.GetIndexBytes(), 0u);
+	EXPECT_EQ(50 * sizeof(SetCoin), store.GetLoadedBytes());
+
+	// room for the indexes and one set only
+	store.SetMemoryBudget(store.GetIndexBytes() + 30 * sizeof(SetCoin));
+	EXPECT_EQ(25 * sizeof(SetCoin), store.GetLoadedBytes());
+	ASSERT_NE(nullptr, store.GetSet(7));
+	EXPECT_EQ(25 * sizeof(SetCoin), store.GetLoadedBytes());
+
+	// the indexes alone are over budget, only the set asked for is loaded
+	store.SetMemoryBudget(store.GetIndexBytes() / 2);
+	EXPECT_EQ(0u, store.GetLoadedBytes());
+	ASSERT_NE(nullptr, store.GetSet(8));
+	EXPECT_EQ(25 * sizeof(SetCoin), store.GetLoadedBytes());
+
+	MintTag tag = {};
+	memcpy(tag.data(), MakeCoin(3).tag, tag.size());
+	EXPECT_TRUE(store.ContainsTag(tag));
+	store.Remove(8);
+}
+
+TEST(SetHashStateTest, SerializedStateResumes) {
+	std::vector<SetCoin> coins = MakeCoins(1, 10);
+	SetHashState whole;
+	whole.Reset();
+	whole.Append(coins.data(), coins.size());
+
+	// 3 records end in the middle of a block, so the buffer is carried over
+	SetHashState first;
+	first.Reset();
+	first.Append(coins.data(), 3);
+	unsigned char serialized[SetHashState::SERIALIZED_SIZE];
+	first.Serialize(serialized);
+
+	SetHashState resumed;
+	ASSERT_TRUE(resumed.Deserialize(serialized));
+	EXPECT_EQ(first.GetDigest(), resumed.GetDigest());
+	resumed.Append(coins.data() + 3, coins.size() - 3);
+	EXPECT_EQ(whole.GetDigest(), resumed.GetDigest());
+}
+
+TEST(SetHashStateTest, RejectsBufferedCountOutOfRange) {
+	std::vector<SetCoin> coins = MakeCoins(1, 3);
+	SetHashState state;
+	state.Reset();
+	state.Append(coins.data(), coins.size());
+	unsigned char serialized[SetHashState::SERIALIZED_SIZE];
+	state.Serialize(serialized);
+
+	SetHashState read;
+	serialized[40] = 64;
+	EXPECT_FALSE(read.Deserialize(serialized));
+	// the buffered bytes have to match the message length
+	serialized[40] = (unsigned char) ((3 * sizeof(SetCoin) + 1) % 64);
+	EXPECT_FALSE(read.Deserialize(serialized));
+}
+
+TEST_F(SetFileTest, ChangedCoinsFailVerify) {
+	{
+		SetStore store;
+		ASSERT_TRUE(store.Open(directory));
+		store.Append(7, SET_HASH, BLOCK_HASH, MakeCoins(1, 10));
+	}
+	// flip a byte of the last coin behind the store's back
+	FILE *file = fopen(path.c_str(), "r+b");
+	ASSERT_NE(nullptr, file);
+	fseek(file, -1, SEEK_END);
+	fputc(0xff, file);
+	fclose(file);
+
+	SetStore store;
+	ASSERT_TRUE(store.Open(directory));
+	EXPECT_FALSE(store.Verify(7));
+}
@@ -0,0 +1,54 @@
+#include "ThreadPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+	ThreadPool pool(4);
+	std::vector<std::atomic<int>> visits(1000);
+	pool.ParallelFor(0, visits.size(), [&visits](size_t i) {
+		visits[i]++;
+	});
+	for (const auto &count : visits) {
+		EXPECT_EQ(1, count.load());
+	}
+}
+
+TEST(ThreadPoolTest, ParallelForWithEmptyRangeDoesNothing) {
+	ThreadPool pool(2);
+	bool called = false;
+	pool.ParallelFor(5, 5, [&called](size_t) {
+		called = true;
+	});
+	EXPECT_FALSE(called);
+}
+
+TEST(ThreadPoolTest, ParallelForRethrowsAfterEveryChunkFinished) {
+	ThreadPool pool(4);
+	std::atomic<size_t> visited(0);
+	// every chunk throws, the others have to run to the end before fn goes away
+	EXPECT_THROW(pool.ParallelFor(0, 400, [&visited](size_t i) {
+		visited++;
+		if (i % 100 == 99) {
+			throw std::runtime_error("chunk failed");
+		}
+	}), std::runtime_error);
+	EXPECT_EQ(400u, visited.load());
+
+	// the pool is still usable
+	std::atomic<size_t> sum(0);
+	pool.ParallelFor(0, 10, [&sum](size_t i) {
+		sum += i;
+	});
+	EXPECT_EQ(45u, sum.load());
+}
+
+TEST(ThreadPoolTest, SubmitRunsTask) {
+	ThreadPool pool(1);
+	int value = 0;
+	pool.Submit([&value]() { value = 42; }).get();
+	EXPECT_EQ(42, value);
+}
@@ -171,7 +171,11 @@ export class AppStorage {
 
         const realm = await this.getRealm();
         this.inflateTransactionsFromRealm(realm, unserializedWallet);
+        await this.migrateUsedCoinsFromRealm(realm, unserializedWallet);
+        await this.migrateAnonymitySetsFromRealm(realm, unserializedWallet);
         realm.close();
+        await unserializedWallet.openSetStore();
+        await unserializedWallet.openCoinTable();
 
         return unserializedWallet;
       } else {
@@ -257,8 +261,18 @@ export class AppStorage {
         Logger.warn('storage:inflateTransactionsFromRealm', error);
       }
     }
+  }
 
+  /**
+   * Anonymity sets moved to native binary files, hand the ones stored by older
+   * versions over to the native set store once and drop them from realm
+   */
+  async migrateAnonymitySetsFromRealm(realm: typeof Realm, wallet: FiroWallet) {
     const realmAnonymitySetData = realm.objects('AnonymitySet');
+    if (realmAnonymitySetData.length == 0) {
+      return;
+    }
+    const anonymitySets: AnonymitySet[] = [];
     for (const realmAnonymitySet of realmAnonymitySetData) {
       try {
         const anonytmiySet = new AnonymitySet();
@@ -266,20 +280,38 @@ export class AppStorage {
         anonytmiySet.blockHash = realmAnonymitySet.block_hash;
         anonytmiySet.setHash = realmAnonymitySet.set_hash;
         anonytmiySet.coins = JSON.parse(realmAnonymitySet.public_coins);
-        wallet._anonymity_sets.push(anonytmiySet);
+        anonymitySets.push(anonytmiySet);
       } catch (error) {
-        Logger.warn('storage:inflateAnonymitySetsFromRealm', error);
+        Logger.warn('storage:migrateAnonymitySetsFromRealm', error);
       }
     }
+    await wallet.migrateAnonymitySets(anonymitySets);
+    realm.write(() => {
+      realm.delete(realmAnonymitySetData);
+    });
+  }
 
+  /**
+   * Used serials moved to a native set, hand the ones stored by older
+   * versions over to it once and drop them from realm
+   */
+  async migrateUsedCoinsFromRealm(realm: typeof Realm, wallet: FiroWallet) {
     const realmUsedCoinData = realm.objects('UsedCoin');
+    if (realmUsedCoinData.length == 0) {
+      return;
+    }
     for (const realmUsedCoin of realmUsedCoinData) {
       try {
-        wallet._used_serial_numbers = JSON.parse(realmUsedCoin.serial_number);
+        await wallet.migrateUsedSerialNumbers(
+          JSON.parse(realmUsedCoin.serial_number),
+        );
       } catch (error) {
-        Logger.warn('storage:inflateUsedCoinsFromRealm', error);
+        Logger.warn('storage:migrateUsedCoinsFromRealm', error);
       }
     }
+    realm.write(() => {
+      realm.delete(realmUsedCoinData);
+    });
   }
 
   offloadWalletToRealm(realm: typeof Realm, wallet: AbstractWallet) {
@@ -295,28 +327,6 @@ export class AppStorage {
         },
         Realm.UpdateMode.Modified,
       );
-
-      wallet._anonymity_sets.forEach(anonymitySet => {
-        realm.create(
-          'AnonymitySet',
-          {
-            set_id: anonymitySet.setId,
-            block_hash: anonymitySet.blockHash,
-            set_hash: anonymitySet.setHash,
-            public_coins: JSON.stringify(anonymitySet.coins),
-          },
-          Realm.UpdateMode.Modified,
-        );
-      });
-
-      realm.create(
-        'UsedCoin',
-        {
-          id: 1,
-          serial_number: JSON.stringify(wallet._used_serial_numbers),
-        },
-        Realm.UpdateMode.Modified,
-      );
     });
   }
 
@@ -51,12 +51,6 @@ export class FullTransactionModel {
   confirmations: number = 0;
 }
 
-export type AnonymitySetModel = {
-  coins: string[][];
-  blockHash: string;
-  setHash: string;
-};
-
 export type UsedSerialsModel = {
   serials: string[];
 };
@@ -107,10 +101,7 @@ export interface AbstractElectrum {
   addChangeListener(onChange: () => void): void;
   removeChangeListener(onChange: () => void): void;
 
-  getAnonymitySet(
-    setId: number,
-    startBlockHash: string,
-  ): Promise<AnonymitySetModel>;
+  getAnonymitySetJson(setId: number, startBlockHash: string): Promise<string>;
 
   getLatestSetId(): Promise<number>;
 
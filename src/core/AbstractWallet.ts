@@ -1,7 +1,6 @@
 import BigNumber from 'bignumber.js';
 import {BalanceData} from '../data/BalanceData';
 import {TransactionItem} from '../data/TransactionItem';
-import {AnonymitySet} from '../data/AnonymitySet';
 
 export type LelantusMintTxParams = {
   utxos: {
@@ -16,18 +15,49 @@ export type LelantusMintTxParams = {
 export type LelantusSpendFeeParams = {
   spendAmount: number;
   subtractFeeFromAmount: boolean;
+  // transparent outputs paid by the spend, 1 when missing, quickEstimateFee assumes 1
+  outputCount?: number;
+};
+
+export type SpendProvingCost = {
+  deserializedPoints: number;
+  provedPoints: number;
+  setBytes: number;
 };
 
 export type FiroTxFeeReturn = {
   fee: number;
   chageToMint: number;
   spendCoinIndexes: number[];
+  provingCost: SpendProvingCost;
 };
 
 export type LelantusSpendTxParams = {
   spendAmount: number;
   address: string;
   subtractFeeFromAmount: boolean;
+  // the latest block height when missing
+  locktime?: number;
+};
+
+export type LelantusSpendOutput = {
+  address: string;
+  value: number;
+};
+
+// a spend to several outputs with a single proof, the fee is paid on top
+export type LelantusPayoutTxParams = {
+  outputs: LelantusSpendOutput[];
+  // the latest block height when missing
+  locktime?: number;
+};
+
+// a self-spend merging coins of one anonymity set into one jmint
+export type FiroConsolidationStep = {
+  spendCoinIndexes: number[];
+  fee: number;
+  mintValue: number;
+  provingCost: SpendProvingCost;
 };
 
 export type FiroMintTxReturn = {
@@ -63,8 +93,6 @@ export interface AbstractWallet {
   _balances_by_internal_index: Array<BalanceData>;
   _txs_by_external_index: TransactionItem[];
   _txs_by_internal_index: TransactionItem[];
-  _anonymity_sets: AnonymitySet[];
-  _used_serial_numbers: string[];
 
   generate(): Promise<void>;
   setSecret(secret: string): Promise<void>;
@@ -89,11 +117,22 @@ export interface AbstractWallet {
   estimateJoinSplitFee(
     params: LelantusSpendFeeParams,
   ): Promise<FiroTxFeeReturn>;
+  quickEstimateFee(params: LelantusSpendFeeParams): Promise<number>;
   createLelantusSpendTx(
     params: LelantusSpendTxParams,
   ): Promise<FiroSpendTxReturn>;
-  addLelantusMintToCache(txId: string, value: number, publicCoin: string, index: number): void;
-  markCoinsSpend(spendCoinIndexes: number[]): void;
+  createLelantusPayoutTx(
+    params: LelantusPayoutTxParams,
+  ): Promise<FiroSpendTxReturn>;
+  planConsolidation(): Promise<FiroConsolidationStep[]>;
+  createConsolidationTx(
+    step: FiroConsolidationStep,
+  ): Promise<FiroSpendTxReturn>;
+  startSpeculativeSpend(params: LelantusSpendTxParams): Promise<number>;
+  discardSpeculativeSpend(): Promise<void>;
+  isSpendPending(): boolean;
+  addLelantusMintToCache(txId: string, value: number, publicCoin: string, index: number): Promise<void>;
+  markCoinsSpend(spendCoinIndexes: number[]): Promise<void>;
   addMintTxToCache(
     txId: string,
     value: number,
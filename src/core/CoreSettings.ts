@@ -1,4 +1,6 @@
 export interface CoreSettings {
   notificationsEnabled: boolean;
   defaultCurrency: 'usd' | 'eur' | 'gbp' | 'aud' | 'btc';
+  // self-spends merging small coins, off unless the user turns them on
+  consolidationEnabled?: boolean;
 }
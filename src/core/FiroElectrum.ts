@@ -4,7 +4,6 @@ import {
   BalanceModel,
   TransactionModel,
   FullTransactionModel,
-  AnonymitySetModel,
   UsedSerialsModel,
 } from './AbstractElectrum';
 import {network} from './FiroNetwork';
@@ -558,34 +557,25 @@ export default class FiroElectrum implements AbstractElectrum {
     return broadcast;
   }
 
-  async getAnonymitySet(
+  /**
+   * Result of lelantus.getanonymityset as JSON text, the coins are decoded by the
+   * native set store. electrum-client hands over parsed results only, so the text
+   * is serialized again here.
+   */
+  async getAnonymitySetJson(
     setId: number,
     startBlockHash: string,
-  ): Promise<AnonymitySetModel> {
-    this.checkConnection('getAnonymitySet');
+  ): Promise<string> {
+    this.checkConnection('getAnonymitySetJson');
 
     const param = [];
     param.push(setId + '');
     param.push(startBlockHash);
-    const result: AnonymitySetModel = await this.mainClient.request(
+    const result = await this.mainClient.request(
       'lelantus.getanonymityset',
       param,
     );
-    result.blockHash = Buffer.from(result.blockHash, "base64").reverse().toString('hex')
-    result.setHash = Buffer.from(result.setHash, "base64").toString('hex')
-    result.coins = result.coins.map(coinData => {
-      let amount = coinData[2];
-      if (typeof amount !== 'number') {
-        amount = Buffer.from(amount, "base64").toString('hex');
-      }
-      return [
-        Buffer.from(coinData[0], "base64").toString('hex'),
-        Buffer.from(coinData[1], "base64").reverse().toString('hex'),
-        amount,
-        Buffer.from(coinData[3], "base64").reverse().toString('hex')
-      ]
-    });
-    return result;
+    return JSON.stringify(result);
   }
 
   async getLatestSetId(): Promise<number> {
@@ -604,7 +594,6 @@ export default class FiroElectrum implements AbstractElectrum {
       'lelantus.getusedcoinserials',
       param,
     );
-    result.serials = result.serials.map(serialBase64 => Buffer.from(serialBase64, "base64").toString('hex'));
 
     return result;
   }
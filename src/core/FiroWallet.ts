@@ -1,10 +1,13 @@
 import {
   AbstractWallet,
+  FiroConsolidationStep,
   FiroMintTxReturn,
   FiroSpendTxReturn,
   FiroTxFeeReturn,
   LelantusMintTxParams,
+  LelantusPayoutTxParams,
   LelantusSpendFeeParams,
+  LelantusSpendOutput,
   LelantusSpendTxParams,
 } from './AbstractWallet';
 import {network, Network} from './FiroNetwork';
@@ -14,12 +17,17 @@ import {TransactionItem} from '../data/TransactionItem';
 import {BalanceData} from '../data/BalanceData';
 import {firoElectrum} from './FiroElectrum';
 import {BIP32Interface} from 'bip32/types/bip32';
-import {LelantusWrapper} from './LelantusWrapper';
+import {
+  CoinFilter,
+  CoinSelectionStrategy,
+  LelantusWrapper,
+} from './LelantusWrapper';
 import {LelantusCoin} from '../data/LelantusCoin';
 import {LelantusEntry} from '../data/LelantusEntry';
 import Logger from '../utils/logger';
 import {Transaction} from 'bitcoinjs-lib/types/transaction';
 import {AnonymitySet} from '../data/AnonymitySet';
+import RNFS from 'react-native-fs';
 
 const bitcoin = require('bitcoinjs-lib');
 const bip32 = require('bip32');
@@ -28,7 +36,6 @@ const bip39 = require('bip39');
 const EXTERNAL_INDEX = 0;
 const INTERNAL_INDEX = 1;
 const MINT_INDEX = 2;
-const JMINT_INDEX = 5;
 
 const ANONYMITY_SET_EMPTY_ID = 0;
 
@@ -36,6 +43,15 @@ const TRANSACTION_LELANTUS = 8;
 
 const MINT_LIMIT = 500100000000;
 
+const USED_SERIALS_FILE = 'used_serials.bin';
+const ANONYMITY_SETS_DIRECTORY = 'anonymity_sets';
+// coins and indexes of anonymity sets kept in native memory, sets not used lately stay on disk
+const ANONYMITY_SETS_MEMORY_BUDGET_MB = 64;
+
+// sets holding fewer of the wallet's coins are not worth a self-spend
+const CONSOLIDATION_MIN_COINS = 10;
+const CONSOLIDATION_MAX_INPUTS = 8;
+
 export const SATOSHI = new BigNumber(100000000);
 
 export const TX_DATE_FORMAT = {
@@ -68,6 +84,16 @@ export class FiroWallet implements AbstractWallet {
   balance: number = 0;
   unconfirmed_balance: number = 0;
   _lelantus_coins_list: LelantusCoin[] = [];
+  // snapshots of the native coin table, not serialized
+  _unspent_coins: LelantusCoin[] = [];
+  _unconfirmed_coins: LelantusCoin[] = [];
+  _coin_table_loaded: boolean = false;
+  // spends, payouts and consolidations being built, not serialized
+  _spends_in_progress: number = 0;
+  // a speculative proof runs until it is discarded, not serialized
+  _speculative_spend: boolean = false;
+  // coins of the consolidation being built, kept out of spends, not serialized
+  _consolidating_coin_indexes: number[] = [];
   _lelantus_coins: {
     [txId: string]: LelantusCoin;
   } = {};
@@ -82,8 +108,6 @@ export class FiroWallet implements AbstractWallet {
     [key: string]: string;
   } = {};
 
-  _anonymity_sets: AnonymitySet[] = [];
-  _used_serial_numbers: string[] = [];
 
   next_free_address_index = 0;
   next_free_change_address_index = 0;
@@ -220,39 +244,49 @@ export class FiroWallet implements AbstractWallet {
 
   private async createMintsFromAmount(total: number) {
     let tmpTotal = new BigNumber(total);
-    let counter = 0;
-    const mints = [];
+    const values: number[] = [];
     while (tmpTotal.toNumber() > 0) {
-      const index = this.next_free_mint_index + counter;
-      const mintKeyPair = this._getNode(
-        MINT_INDEX,
-        index,
-      );
+      values.push(Math.min(tmpTotal.toNumber(), MINT_LIMIT));
+      tmpTotal = tmpTotal.minus(MINT_LIMIT);
+    }
 
-      const mintTag = await LelantusWrapper.getMintTag(
-        mintKeyPair,
-        index,
+    // indexes whose tag is already on chain are skipped, checked a window at a time
+    const xprv = this._getAccountXprv();
+    const indexes: number[] = [];
+    let nextIndex = this.next_free_mint_index;
+    while (indexes.length < values.length) {
+      const count = values.length - indexes.length;
+      const tags = await LelantusWrapper.getMintTagBatch(
+        xprv,
+        nextIndex,
+        count,
       );
-      
-      if (this._anonymity_sets.find(set => set.coins.find(coin => coin[1] == mintTag) !== undefined) === undefined) {
-        const mintValue = Math.min(tmpTotal.toNumber(), MINT_LIMIT);
-        const mint = await LelantusWrapper.lelantusMint(
-          mintKeyPair,
-          index,
-          mintValue,
-        );
-        mints.push({
-          value: mintValue,
-          script: mint.script,
-          publicCoin: mint.publicCoin,
-          index: index,
-        });
-        tmpTotal = tmpTotal.minus(MINT_LIMIT);
-      }
-
-      counter++;
+      const usedFlags = await LelantusWrapper.containsMintTags(tags);
+      usedFlags.forEach((isTagUsed, i) => {
+        if (!isTagUsed) {
+          indexes.push(nextIndex + i);
+        }
+      });
+      nextIndex += count;
     }
-    return mints;
+
+    // all mints are derived natively in parallel, in one bridge call
+    const bundles = await LelantusWrapper.createMintsBatch(
+      xprv,
+      indexes,
+      values,
+    );
+    return bundles.map((mint, i) => {
+      if (mint.script === '') {
+        throw Error(`can't derive mint ${indexes[i]}`);
+      }
+      return {
+        value: values[i],
+        script: mint.script,
+        publicCoin: mint.publicCoin,
+        index: indexes[i],
+      };
+    });
   }
 
   private createMintTx({inputs, mints}: MintTxData): Transaction {
@@ -291,15 +325,44 @@ export class FiroWallet implements AbstractWallet {
   ): Promise<FiroTxFeeReturn> {
     let spendAmount = params.spendAmount;
 
-    const lelantusEntries = this._getLelantusEntry();
-
-    const estimateFeeData = await LelantusWrapper.estimateJoinSplitFee(
+    // selection needs amounts and set ids only, mint keys are derived for the spend itself,
+    // coins a running consolidation merges are left out
+    const lelantusCoins = this._getUnspentCoins().filter(
+      coin => !this._consolidating_coin_indexes.includes(coin.index),
+    );
+    const selection = await LelantusWrapper.selectSpendCoins(
+      lelantusCoins.map(coin => coin.value),
+      lelantusCoins.map(coin => coin.anonymitySetId),
+      lelantusCoins.map(() => 0),
       spendAmount,
       params.subtractFeeFromAmount,
-      lelantusEntries,
+      CoinSelectionStrategy.SetAware,
+      params.outputCount ?? 1,
     );
+    const provingCost = await LelantusWrapper.getSpendProvingCost(
+      selection.positions.map(
+        position => lelantusCoins[position].anonymitySetId,
+      ),
+    );
+
+    return {
+      fee: selection.fee,
+      chageToMint: selection.chageToMint,
+      spendCoinIndexes: selection.positions.map(
+        position => lelantusCoins[position].index,
+      ),
+      provingCost,
+    };
+  }
 
-    return estimateFeeData;
+  async quickEstimateFee(params: LelantusSpendFeeParams): Promise<number> {
+    const lelantusCoins = this._getUnspentCoins();
+    return LelantusWrapper.quickEstimateFee(
+      lelantusCoins.map(coin => coin.value),
+      lelantusCoins.map(coin => coin.anonymitySetId),
+      params.spendAmount,
+      params.subtractFeeFromAmount,
+    );
   }
 
   _getLelantusEntry(): LelantusEntry[] {
@@ -323,139 +386,139 @@ export class FiroWallet implements AbstractWallet {
     return lelantusEntries;
   }
 
-  async createLelantusSpendTx(
-    params: LelantusSpendTxParams,
-  ): Promise<FiroSpendTxReturn> {
-    let spendAmount = params.spendAmount;
-    let lelantusEntries = this._getLelantusEntry();
-
+  /**
+   * Everything of a spend but its proof, the tx hash the proof commits to is the one
+   * of the tx with an empty payload. Only a spend to one output can subtract the fee
+   */
+  private async prepareLelantusSpend(
+    outputs: LelantusSpendOutput[],
+    subtractFeeFromAmount: boolean,
+    locktime: number,
+  ) {
+    const spendAmount = outputs.reduce((sum, output) => sum + output.value, 0);
+
+    // selection and proving both read the sets from the native store
+    await this.openSetStore();
     const estimateJoinSplitFee = await this.estimateJoinSplitFee({
       spendAmount,
-      subtractFeeFromAmount: params.subtractFeeFromAmount,
+      subtractFeeFromAmount,
+      outputCount: outputs.length,
     });
     let chageToMint = estimateJoinSplitFee.chageToMint;
     let fee = estimateJoinSplitFee.fee;
     let spendCoinIndexes = estimateJoinSplitFee.spendCoinIndexes;
-
-    const tx = new bitcoin.Psbt({network: this.network});
-    tx.setLocktime(firoElectrum.getLatestBlockHeight());
-
-    // lelantusjoinsplitbuilder.cpp, lines 299-305
-    tx.setVersion(3 | (TRANSACTION_LELANTUS << 16));
-
-    tx.addInput({
-      hash: '0000000000000000000000000000000000000000000000000000000000000000',
-      index: 4294967295,
-      sequence: 4294967295,
-      // eslint-disable-next-line no-undef
-      finalScriptSig: Buffer.alloc(0),
-    });
+    if (spendCoinIndexes.length === 0) {
+      throw Error('Insufficient funds');
+    }
+    // the proof spends exactly the coins the fee and the change were estimated for
+    const lelantusEntries = this._getLelantusEntry().filter(entry =>
+      spendCoinIndexes.includes(entry.index),
+    );
 
     const index = this.next_free_mint_index;
     const jmintKeyPair = this._getNode(MINT_INDEX, index);
-    const keyPath = await LelantusWrapper.getMintKeyPath(
-      chageToMint,
-      jmintKeyPair,
+
+    // the mint and its aes key are derived natively from one private coin
+    const jmintData = await LelantusWrapper.createJMintBundle(
+      this._getAccountXprv(),
       index,
+      chageToMint,
     );
-
-    const aesKeyPair = this._getNode(JMINT_INDEX, keyPath);
-    const aesPrivateKey = aesKeyPair.privateKey?.toString('hex');
-    if (aesPrivateKey === undefined) {
+    if (jmintData.script === '') {
       Logger.error(
         'firo_wallet:createLelantusSpendTx',
-        'key pair is undefuned',
+        'jmint keys are not derived',
       );
-      throw Error("Can't generate aes private key");
+      throw Error("Can't generate jmint");
     }
 
-    const jmintData = await LelantusWrapper.lelantusJMint(
-      chageToMint,
-      jmintKeyPair,
-      index,
-      aesPrivateKey,
+    const paidOutputs = outputs.map(output => ({
+      address: output.address,
+      value: subtractFeeFromAmount ? output.value - fee : output.value,
+    }));
+    const amount = paidOutputs.reduce((sum, output) => sum + output.value, 0);
+
+    const extractedTx = this.buildLelantusSpendTx(
+      locktime,
+      '',
+      jmintData.script,
+      paidOutputs,
     );
 
-    tx.addOutput({
-      // eslint-disable-next-line no-undef
-      script: Buffer.from(jmintData.script, 'hex'),
-      value: 0,
-    });
-
-    let amount = spendAmount;
-    if (params.subtractFeeFromAmount) {
-      amount -= fee;
-    }
-    tx.addOutput({
-      address: params.address,
-      value: amount,
-    });
-
-    const extractedTx = tx.extractTransaction(true);
-
     // eslint-disable-next-line no-undef
     extractedTx.setPayload(Buffer.alloc(0));
     const txHash = extractedTx.getId();
 
-    const setIds: number[] = [];
-    const anonimitySets: string[][] = [];
-    const anonymitySetHashes: string[] = [];
-    const groupBlockHashes: string[] = [];
-    for (let i = 0; i < lelantusEntries.length; i++) {
-      const anonymitySetId = lelantusEntries[i].anonymitySetId;
-
-      if (!setIds.includes(anonymitySetId)) {
-        setIds.push(anonymitySetId);
-        const anonymitySet = this._anonymity_sets.find(
-          set => set.setId === anonymitySetId,
-        );
-        if (anonymitySet) {
-          anonimitySets.push([...anonymitySet.coins.map(coin => coin[0])]);
-          anonymitySetHashes.push(anonymitySet.setHash);
-          groupBlockHashes.push(anonymitySet.blockHash);
-        }
-      }
-    }
-
-    const spendScript = await LelantusWrapper.lelantusSpend(
-      spendAmount,
-      params.subtractFeeFromAmount,
-      jmintKeyPair,
-      index,
+    return {
       lelantusEntries,
-      txHash.toString('hex'),
-      setIds,
-      anonimitySets,
-      anonymitySetHashes,
-      groupBlockHashes,
-    );
+      chageToMint,
+      fee,
+      spendCoinIndexes,
+      index,
+      jmintKeyPair,
+      jmintData,
+      outputs: paidOutputs,
+      amount,
+      txHash: txHash.toString('hex'),
+    };
+  }
 
-    const finalTx = new bitcoin.Psbt({network: this.network});
-    finalTx.setLocktime(firoElectrum.getLatestBlockHeight());
+  // the change jmint comes first, then the outputs in the given order
+  private buildLelantusSpendTx(
+    locktime: number,
+    scriptSig: string,
+    jmintScript: string,
+    outputs: LelantusSpendOutput[],
+  ) {
+    const tx = new bitcoin.Psbt({network: this.network});
+    tx.setLocktime(locktime);
 
     // lelantusjoinsplitbuilder.cpp, lines 299-305
-    finalTx.setVersion(3 | (TRANSACTION_LELANTUS << 16));
+    tx.setVersion(3 | (TRANSACTION_LELANTUS << 16));
 
-    finalTx.addInput({
+    tx.addInput({
       hash: '0000000000000000000000000000000000000000000000000000000000000000',
       index: 4294967295,
       sequence: 4294967295,
       // eslint-disable-next-line no-undef
-      finalScriptSig: Buffer.from('c9', 'hex'),
+      finalScriptSig: Buffer.from(scriptSig, 'hex'),
     });
 
-    finalTx.addOutput({
+    tx.addOutput({
       // eslint-disable-next-line no-undef
-      script: Buffer.from(jmintData.script, 'hex'),
+      script: Buffer.from(jmintScript, 'hex'),
       value: 0,
     });
 
-    finalTx.addOutput({
-      address: params.address,
-      value: amount,
+    outputs.forEach(output => {
+      tx.addOutput({
+        address: output.address,
+        value: output.value,
+      });
     });
 
-    const extTx = finalTx.extractTransaction(true);
+    return tx.extractTransaction(true);
+  }
+
+  private finishLelantusSpendTx(
+    spend: {
+      jmintData: {script: string; publicCoin: string};
+      outputs: LelantusSpendOutput[];
+      amount: number;
+      fee: number;
+      chageToMint: number;
+      index: number;
+      spendCoinIndexes: number[];
+    },
+    spendScript: string,
+    locktime: number,
+  ): FiroSpendTxReturn {
+    const extTx = this.buildLelantusSpendTx(
+      locktime,
+      'c9',
+      spend.jmintData.script,
+      spend.outputs,
+    );
 
     //eslint-disable-next-line no-undef
     extTx.setPayload(Buffer.from(spendScript, 'hex'));
@@ -466,38 +529,244 @@ export class FiroWallet implements AbstractWallet {
     return {
       txId: txId,
       txHex: txHex,
-      value: amount,
-      fee: fee,
-      jmintValue: chageToMint,
-      publicCoin: jmintData.publicCoin,
-      mintIndex: index,
-      spendCoinIndexes: spendCoinIndexes,
+      value: spend.amount,
+      fee: spend.fee,
+      jmintValue: spend.chageToMint,
+      publicCoin: spend.jmintData.publicCoin,
+      mintIndex: spend.index,
+      spendCoinIndexes: spend.spendCoinIndexes,
     };
   }
 
-  addLelantusMintToCache(
+  async createLelantusSpendTx(
+    params: LelantusSpendTxParams,
+  ): Promise<FiroSpendTxReturn> {
+    this._spends_in_progress++;
+    try {
+      const locktime = params.locktime ?? firoElectrum.getLatestBlockHeight();
+      const spend = await this.prepareLelantusSpend(
+        [{address: params.address, value: params.spendAmount}],
+        params.subtractFeeFromAmount,
+        locktime,
+      );
+
+      // takes over the speculative proof of the same spend
+      const spendScript = await LelantusWrapper.lelantusSpend(
+        params.spendAmount,
+        params.subtractFeeFromAmount,
+        spend.fee,
+        spend.jmintKeyPair,
+        spend.index,
+        spend.lelantusEntries,
+        spend.txHash,
+      );
+
+      return this.finishLelantusSpendTx(spend, spendScript, locktime);
+    } finally {
+      this._spends_in_progress--;
+    }
+  }
+
+  /**
+   * Pays every output from one JoinSplit, so the proof over the anonymity sets is
+   * built once instead of once per recipient
+   */
+  async createLelantusPayoutTx(
+    params: LelantusPayoutTxParams,
+  ): Promise<FiroSpendTxReturn> {
+    if (params.outputs.length === 0) {
+      throw Error('No outputs to pay');
+    }
+    this._spends_in_progress++;
+    try {
+      const locktime = params.locktime ?? firoElectrum.getLatestBlockHeight();
+      const spend = await this.prepareLelantusSpend(
+        params.outputs,
+        false,
+        locktime,
+      );
+
+      const spendScript = await LelantusWrapper.lelantusMultiRecipientSpend(
+        spend.outputs.map(output => output.value),
+        spend.fee,
+        spend.jmintKeyPair,
+        spend.index,
+        spend.lelantusEntries,
+        spend.txHash,
+      );
+
+      return this.finishLelantusSpendTx(spend, spendScript, locktime);
+    } finally {
+      this._spends_in_progress--;
+    }
+  }
+
+  /**
+   * Self-spends merging the coins of sets the wallet holds many of, each into one
+   * jmint, so later spends need fewer inputs and proofs
+   */
+  async planConsolidation(): Promise<FiroConsolidationStep[]> {
+    // the proving costs are read from the stored set sizes
+    await this.openSetStore();
+    const lelantusCoins = this._getUnspentCoins();
+    const steps = await LelantusWrapper.planConsolidation(
+      lelantusCoins.map(coin => coin.value),
+      lelantusCoins.map(coin => coin.anonymitySetId),
+      CONSOLIDATION_MIN_COINS,
+      CONSOLIDATION_MAX_INPUTS,
+    );
+    return steps.map(step => ({
+      spendCoinIndexes: step.positions.map(
+        position => lelantusCoins[position].index,
+      ),
+      fee: step.fee,
+      mintValue: step.mintValue,
+      provingCost: step.provingCost,
+    }));
+  }
+
+  async createConsolidationTx(
+    step: FiroConsolidationStep,
+  ): Promise<FiroSpendTxReturn> {
+    const lelantusEntries = this._getLelantusEntry().filter(entry =>
+      step.spendCoinIndexes.includes(entry.index),
+    );
+    if (lelantusEntries.length !== step.spendCoinIndexes.length) {
+      throw Error('Consolidated coins are not unspent');
+    }
+    this._spends_in_progress++;
+    this._consolidating_coin_indexes = step.spendCoinIndexes;
+    try {
+      return await this.proveConsolidation(step, lelantusEntries);
+    } finally {
+      this._consolidating_coin_indexes = [];
+      this._spends_in_progress--;
+    }
+  }
+
+  private async proveConsolidation(
+    step: FiroConsolidationStep,
+    lelantusEntries: LelantusEntry[],
+  ): Promise<FiroSpendTxReturn> {
+    await this.openSetStore();
+
+    const locktime = firoElectrum.getLatestBlockHeight();
+    const index = this.next_free_mint_index;
+    const jmintKeyPair = this._getNode(MINT_INDEX, index);
+    const jmintData = await LelantusWrapper.createJMintBundle(
+      this._getAccountXprv(),
+      index,
+      step.mintValue,
+    );
+    if (jmintData.script === '') {
+      Logger.error(
+        'firo_wallet:createConsolidationTx',
+        'jmint keys are not derived',
+      );
+      throw Error("Can't generate jmint");
+    }
+
+    const extractedTx = this.buildLelantusSpendTx(
+      locktime,
+      '',
+      jmintData.script,
+      [],
+    );
+    // eslint-disable-next-line no-undef
+    extractedTx.setPayload(Buffer.alloc(0));
+    const txHash = extractedTx.getId();
+
+    const spendScript = await LelantusWrapper.consolidationSpend(
+      jmintKeyPair,
+      index,
+      lelantusEntries,
+      txHash.toString('hex'),
+    );
+
+    return this.finishLelantusSpendTx(
+      {
+        jmintData,
+        outputs: [],
+        amount: 0,
+        fee: step.fee,
+        chageToMint: step.mintValue,
+        index,
+        spendCoinIndexes: step.spendCoinIndexes,
+      },
+      spendScript,
+      locktime,
+    );
+  }
+
+  /**
+   * Starts proving the spend natively while the user reviews it. Resolves with the
+   * locktime, createLelantusSpendTx with it in the same params takes the proof over
+   */
+  async startSpeculativeSpend(params: LelantusSpendTxParams): Promise<number> {
+    this._speculative_spend = true;
+    try {
+      const locktime = params.locktime ?? firoElectrum.getLatestBlockHeight();
+      const spend = await this.prepareLelantusSpend(
+        [{address: params.address, value: params.spendAmount}],
+        params.subtractFeeFromAmount,
+        locktime,
+      );
+      await LelantusWrapper.startSpeculativeSpend(
+        params.spendAmount,
+        params.subtractFeeFromAmount,
+        spend.fee,
+        spend.jmintKeyPair,
+        spend.index,
+        spend.lelantusEntries,
+        spend.txHash,
+      );
+      return locktime;
+    } catch (e) {
+      this._speculative_spend = false;
+      throw e;
+    }
+  }
+
+  async discardSpeculativeSpend(): Promise<void> {
+    this._speculative_spend = false;
+    await LelantusWrapper.discardSpeculativeSpend();
+  }
+
+  /**
+   * True while a spend, payout or consolidation is built and until a speculative
+   * proof is discarded, a consolidation then could spend the same coins or drop
+   * the proof. Only the operation that made it pending clears it
+   */
+  isSpendPending(): boolean {
+    return this._spends_in_progress > 0 || this._speculative_spend;
+  }
+
+  async addLelantusMintToCache(
     txId: string,
     value: number,
     publicCoin: string,
     index: number,
-  ): void {
-    this._lelantus_coins_list.push({
-      index: index,
-      value: value,
-      publicCoin: publicCoin,
-      txId: txId,
-      anonymitySetId: ANONYMITY_SET_EMPTY_ID,
-      isUsed: false,
-    });
+  ): Promise<void> {
+    await this.openCoinTable();
+    await LelantusWrapper.putWalletCoins([
+      {
+        index: index,
+        value: value,
+        publicCoin: publicCoin,
+        txId: txId,
+        anonymitySetId: ANONYMITY_SET_EMPTY_ID,
+        isUsed: false,
+      },
+    ]);
+    await this.refreshCoins();
     this.next_free_mint_index = Math.max(index + 1, this.next_free_mint_index);
   }
 
-  markCoinsSpend(spendCoinIndexes: number[]): void {
-    this._lelantus_coins_list.forEach(coin => {
-      if (spendCoinIndexes.includes(coin.index)) {
-        coin.isUsed = true;
-      }
-    });
+  async markCoinsSpend(spendCoinIndexes: number[]): Promise<void> {
+    await this.openCoinTable();
+    if (await LelantusWrapper.markWalletCoinsUsed(spendCoinIndexes)) {
+      await this.refreshCoins();
+    }
   }
 
   addMintTxToCache(txId: string, value: number, fee: number, address: string) {
@@ -525,41 +794,59 @@ export class FiroWallet implements AbstractWallet {
   }
 
   async updateMintMetadata(): Promise<boolean> {
-    let hasUpdate = false;
-    const unconfirmedCoins = this._getUnconfirmedCoins();
-    if (unconfirmedCoins.length > 0) {
-      this._anonymity_sets.forEach(set => {
-        unconfirmedCoins.forEach(coin => {
-          if (coin.anonymitySetId < set.setId && set.coins.filter(c => c[0] == coin.publicCoin).length > 0) {
-            hasUpdate = true;
-            coin.anonymitySetId = set.setId;
-            this._updateSendTxStatus(coin);
-          }
-        });
-      });
+    await this.openCoinTable();
+    const movedTxIds = await LelantusWrapper.updateWalletCoinSetIds();
+    if (movedTxIds.length === 0) {
+      return false;
     }
-    return hasUpdate;
+    await this.refreshCoins();
+    new Set(movedTxIds).forEach(txId => this._updateSendTxStatus(txId));
+    return true;
   }
 
-  _updateSendTxStatus(coin: LelantusCoin) {
-    const tx = this._txs_by_external_index.find(
-      item => item.txId === coin.txId,
-    );
+  // the coins of the tx are in a set now
+  _updateSendTxStatus(txId: string) {
+    const tx = this._txs_by_external_index.find(item => item.txId === txId);
     if (tx && tx.isMint === false) {
-      tx.confirmed = coin.anonymitySetId !== ANONYMITY_SET_EMPTY_ID;
+      tx.confirmed = true;
     }
   }
 
+  /**
+   * Loads the persisted coin list into the native coin table once per wallet
+   * object, duplicate mint indexes are dropped there. Resolves with true if the
+   * list changed
+   */
+  async openCoinTable(): Promise<boolean> {
+    if (this._coin_table_loaded) {
+      return false;
+    }
+    const dropped = await LelantusWrapper.loadWalletCoins(
+      this._lelantus_coins_list,
+    );
+    this._coin_table_loaded = true;
+    await this.refreshCoins();
+    return dropped > 0;
+  }
+
+  private async refreshCoins(): Promise<void> {
+    this._lelantus_coins_list = await LelantusWrapper.getWalletCoins(
+      CoinFilter.All,
+    );
+    this._unspent_coins = await LelantusWrapper.getWalletCoins(
+      CoinFilter.Unspent,
+    );
+    this._unconfirmed_coins = await LelantusWrapper.getWalletCoins(
+      CoinFilter.Unconfirmed,
+    );
+  }
+
   _getUnconfirmedCoins(): LelantusCoin[] {
-    return this._lelantus_coins_list.filter(coin => {
-      return !coin.isUsed && coin.anonymitySetId === ANONYMITY_SET_EMPTY_ID;
-    });
+    return this._unconfirmed_coins;
   }
 
   _getUnspentCoins(): LelantusCoin[] {
-    return this._lelantus_coins_list.filter(coin => {
-      return !coin.isUsed && coin.anonymitySetId !== ANONYMITY_SET_EMPTY_ID && coin.value > 0;
-    });
+    return this._unspent_coins;
   }
 
   async _getWifForAddress(address: string): Promise<string> {
@@ -633,6 +920,20 @@ export class FiroWallet implements AbstractWallet {
     return child.toWIF();
   }
 
+  /**
+   * Base58 xprv of m/44'/136'/0', handed to the native side so mint keys
+   * are derived there instead of one `_getNode` call per index
+   */
+  _getAccountXprv(): string {
+    if (!this.secret) {
+      throw Error('illegal state secret is null');
+    }
+
+    // eslint-disable-next-line no-undef
+    const root = bip32.fromSeed(Buffer.from(this.seed, 'hex'), this.network);
+    return root.derivePath("m/44'/136'/0'").toBase58();
+  }
+
   _getNode(node: number, index: number): BIP32Interface {
     if (!this.secret) {
       throw Error('illegal state secret is null');
@@ -903,69 +1204,112 @@ export class FiroWallet implements AbstractWallet {
 
   async fetchAnonymitySets(): Promise<boolean> {
     let hasChanges = false;
+    await this.openSetStore();
     const latestSetId = await firoElectrum.getLatestSetId();
     for (let setId = 1; setId <= latestSetId; setId++) {
-      let anonymitySet = this._anonymity_sets.find(set => set.setId === setId);
-      if (!anonymitySet) {
-        anonymitySet = new AnonymitySet();
-        anonymitySet.setId = setId;
-        this._anonymity_sets.push(anonymitySet);
-      }
-      const fetchedAnonymitySet = await firoElectrum.getAnonymitySet(
-        anonymitySet.setId,
-        anonymitySet.blockHash,
+      const storedSet = await LelantusWrapper.getAnonymitySetInfo(setId);
+      // the response goes to the native set store undecoded
+      const response = await firoElectrum.getAnonymitySetJson(
+        setId,
+        storedSet.blockHash,
       );
-      if (
-        fetchedAnonymitySet.setHash !== '' &&
-        anonymitySet.setHash !== fetchedAnonymitySet.setHash
-      ) {
-        anonymitySet.setHash = fetchedAnonymitySet.setHash;
-        anonymitySet.blockHash = fetchedAnonymitySet.blockHash;
-        fetchedAnonymitySet.coins.reverse().forEach(coin => {
-          anonymitySet?.coins.unshift(coin);
-        });
+      // appended natively, only the new coins are indexed
+      const newCoins = await LelantusWrapper.mergeAnonymitySetResponse(
+        setId,
+        response,
+      );
+      if (!newCoins) {
+        Logger.warn('firo_wallet:fetchAnonymitySets', `malformed set ${setId}`);
+      } else if (newCoins.count > 0) {
         hasChanges = true;
       }
     }
     return hasChanges;
   }
 
-  private async fixDuplicateCoinIssue(): Promise<boolean> {
-    let hasChanges = false;
-    let unspentCoins = this._getUnspentCoins();
-    unspentCoins.forEach(coin => {
-      let duplicateCoins = this._lelantus_coins_list.filter(c => c.index == coin.index);
-      if (duplicateCoins.length > 1) {
-        let maxSetId = Math.max(...duplicateCoins.map(c => c.anonymitySetId));
-        this._lelantus_coins_list = this._lelantus_coins_list.filter(c => c.index != coin.index || c.anonymitySetId == maxSetId)
-        hasChanges = true;
+  /**
+   * Anonymity sets are kept by the native side in binary files shared by all wallets,
+   * returns the ids of the stored sets
+   */
+  async openSetStore(): Promise<number[]> {
+    return LelantusWrapper.openAnonymitySetStore(
+      RNFS.DocumentDirectoryPath + '/' + ANONYMITY_SETS_DIRECTORY,
+      ANONYMITY_SETS_MEMORY_BUDGET_MB,
+    );
+  }
+
+  /**
+   * Moves anonymity sets stored by older versions into the native set store
+   */
+  async migrateAnonymitySets(anonymitySets: AnonymitySet[]): Promise<void> {
+    const setIds = await this.openSetStore();
+    for (const anonymitySet of anonymitySets) {
+      if (!setIds.includes(anonymitySet.setId)) {
+        await LelantusWrapper.updateAnonymitySet(anonymitySet);
       }
-    })
-    unspentCoins = this._getUnspentCoins();
-    unspentCoins.forEach(coin => {
-      this._anonymity_sets.forEach(set => {
-        if (coin.anonymitySetId < set.setId) {
-          const foundCoin = set.coins.find(setCoin => setCoin[0] === coin.publicCoin);
-          if (foundCoin) {
-            coin.anonymitySetId = set.setId;
-            hasChanges = true;
-          }
-        }
-      })
-    })
+    }
+  }
+
+  /**
+   * Keeps the decompressed public coins of the sets holding our unspent coins, so
+   * spends from them don't decompress the whole set again, and starts building
+   * their group elements in the background for the next spend
+   */
+  async prepareSpendableSets(): Promise<void> {
+    const setIds = await LelantusWrapper.getUnspentCoinSetIds();
+    if (setIds.length > 0) {
+      await LelantusWrapper.cacheAnonymitySetPoints(setIds);
+    }
+    await LelantusWrapper.startSpendPrewarm(setIds);
+  }
+
+  private async fixDuplicateCoinIssue(): Promise<boolean> {
+    // duplicates are dropped by the coin table when it is loaded
+    let hasChanges = await this.openCoinTable();
+    const movedTxIds = await LelantusWrapper.updateWalletCoinSetIds();
+    if (movedTxIds.length > 0) {
+      await this.refreshCoins();
+      hasChanges = true;
+    }
     return hasChanges;
   }
 
   async fetchUsedCoins(): Promise<boolean> {
     let hasChanges = false;
+    const usedSerialsCount = await this.openUsedSerialSet();
     const usedSerialNumbers = (
-      await firoElectrum.getUsedCoinSerials(this._used_serial_numbers.length)
+      await firoElectrum.getUsedCoinSerials(usedSerialsCount)
     ).serials;
     hasChanges = usedSerialNumbers.length > 0;
-    this._used_serial_numbers = [...this._used_serial_numbers, ...usedSerialNumbers];
+    if (hasChanges) {
+      await LelantusWrapper.appendUsedSerials(usedSerialNumbers);
+    }
     return hasChanges;
   }
 
+  /**
+   * Used serials are kept by the native side in a file shared by all wallets,
+   * returns the number of serials already fetched from the server
+   */
+  async openUsedSerialSet(): Promise<number> {
+    return LelantusWrapper.openUsedSerialSet(
+      RNFS.DocumentDirectoryPath + '/' + USED_SERIALS_FILE,
+    );
+  }
+
+  /**
+   * Moves hex serials stored by older versions into the native used serial set
+   */
+  async migrateUsedSerialNumbers(serialNumbers: string[]): Promise<void> {
+    const usedSerialsCount = await this.openUsedSerialSet();
+    if (usedSerialsCount > 0 || serialNumbers.length == 0) {
+      return;
+    }
+    await LelantusWrapper.appendUsedSerials(
+      serialNumbers.map(serial => Buffer.from(serial, 'hex').toString('base64')),
+    );
+  }
+
   async sync(callback: () => void): Promise<void> {
     if (await this.fetchTransactions()) {
       callback();
@@ -990,6 +1334,8 @@ export class FiroWallet implements AbstractWallet {
       }
       callback();
     }
+
+    await this.prepareSpendableSets();
   }
 
   async restore(
@@ -1020,17 +1366,7 @@ export class FiroWallet implements AbstractWallet {
     hasChanges: boolean;
     spendTxIds: string[];
   }> {
-    let hasChanges = false;
-
-    const latestSetId = Math.max(...this._anonymity_sets.map(set => set.setId));
-    const setDataMap: {
-      [key: number]: AnonymitySet;
-    } = {};
-    this._anonymity_sets.forEach(set => {
-      setDataMap[set.setId] = set;
-    })
-
-    const unspentCoins = this._getUnspentCoins();
+    let hasChanges = await this.openCoinTable();
 
     const spendTxIds: string[] = [];
 
@@ -1042,75 +1378,37 @@ export class FiroWallet implements AbstractWallet {
       }
     }
 
-    let lastFoundIndex = this.next_free_mint_index - 1;
-    let currentIndex = this.next_free_mint_index;
-    while (currentIndex < lastFoundIndex + this.mint_index_gap_limit) {
-      const mintKeyPair = this._getNode(MINT_INDEX, currentIndex);
-      const mintTag = await LelantusWrapper.getMintTag(
-        mintKeyPair,
-        currentIndex,
-      );
+    const xprv = this._getAccountXprv();
 
-      let coinSetId = 0;
-      for (let setId = latestSetId; setId >= 1; setId--) {
-        const setData = setDataMap[setId];
-        const foundCoin = setData.coins.find(coin => coin[1] === mintTag);
-        if (foundCoin && coinSetId == 0) {
-          hasChanges = true;
-          coinSetId = setId;
-          if (typeof foundCoin[2] === 'number') {
-            // mint
-            lastFoundIndex = currentIndex;
-            const amount = foundCoin[2];
-            const serialNumber = await LelantusWrapper.getSerialNumber(
-              mintKeyPair,
-              currentIndex,
-              amount,
-            );
-            this._lelantus_coins_list.push({
-              index: currentIndex,
-              value: amount,
-              publicCoin: foundCoin[0],
-              txId: foundCoin[3],
-              anonymitySetId: setId,
-              isUsed: this._used_serial_numbers.includes(serialNumber),
-            });
-          } else {
-            // jmint
-            lastFoundIndex = currentIndex;
-
-            const keyPath = await LelantusWrapper.getAesKeyPath(foundCoin[0]);
-            const aesKeyPair = this._getNode(JMINT_INDEX, keyPath);
-            const aesPrivateKey = aesKeyPair.privateKey?.toString('hex');
-            if (aesPrivateKey !== undefined) {
-              const amount = await LelantusWrapper.decryptMintAmount(
-                aesPrivateKey,
-                foundCoin[2],
-              );
-
-              const serialNumber = await LelantusWrapper.getSerialNumber(
-                mintKeyPair,
-                currentIndex,
-                amount,
-              );
-
-              this._lelantus_coins_list.push({
-                index: currentIndex,
-                value: amount,
-                publicCoin: foundCoin[0],
-                txId: foundCoin[3],
-                anonymitySetId: setId,
-                isUsed: this._used_serial_numbers.includes(serialNumber),
-              });
-
-              spendTxIds.push(foundCoin[3]);
-            }
-          }
-        }
+    await this.openSetStore();
+    await this.openUsedSerialSet();
+
+    // the whole gap limit scan, including jmint decryption and spent checks, runs natively
+    const scannedMints = await LelantusWrapper.scanMints(
+      xprv,
+      this.next_free_mint_index,
+      this.mint_index_gap_limit,
+    );
+
+    let lastFoundIndex = this.next_free_mint_index - 1;
+    const foundCoins: LelantusCoin[] = [];
+    scannedMints.forEach(mint => {
+      hasChanges = true;
+      lastFoundIndex = mint.index;
+      foundCoins.push({
+        index: mint.index,
+        value: mint.value,
+        publicCoin: mint.publicCoin,
+        txId: mint.txId,
+        anonymitySetId: mint.anonymitySetId,
+        isUsed: mint.isUsed,
+      });
+      if (mint.isJMint) {
+        spendTxIds.push(mint.txId);
       }
+    });
 
-      currentIndex++;
-    }
+    await LelantusWrapper.putWalletCoins(foundCoins);
 
     this.next_free_mint_index = lastFoundIndex + 1;
 
@@ -1119,21 +1417,28 @@ export class FiroWallet implements AbstractWallet {
       this.mint_index_gap_limit = 20;
     }
 
-    if (spendTxIds.length > 0) {
-      for (let index = 0; index < unspentCoins.length; index++) {
-        const coin = unspentCoins[index];
-        if (this._used_serial_numbers.includes(coin.publicCoin)) {
-          coin.isUsed = true;
-        }
-      }
+    // serials are derived once per coin, later used serials mark coins by index
+    if ((await LelantusWrapper.markSpentWalletCoins(xprv)) > 0) {
+      hasChanges = true;
     }
+    await this.refreshCoins();
 
     return {hasChanges: hasChanges, spendTxIds: spendTxIds};
   }
 
   private async fetchSpendTxs(spendTxIds: string[]): Promise<void> {
-    const spendTxs = await firoElectrum.multiGetTransactionByTxid(spendTxIds);
-    for (const [txid, tx] of Object.entries(spendTxs)) {
+    const spendTxs = Object.entries(
+      await firoElectrum.multiGetTransactionByTxid(spendTxIds),
+    );
+    // serials and fees are read from the raw txs natively
+    const joinSplits = await LelantusWrapper.parseJoinSplits(
+      spendTxs.map(([, tx]) => tx.hex),
+    );
+    const spentCoinIndexes: number[] = [];
+    for (const [i, [txid, tx]] of spendTxs.entries()) {
+      const joinSplit = joinSplits[i];
+      spentCoinIndexes.push(...joinSplit.spentCoinIndexes);
+
       const foundTxs = this._txs_by_external_index.filter(
         item => item.txId === tx.txid,
       );
@@ -1151,11 +1456,18 @@ export class FiroWallet implements AbstractWallet {
           }
         });
         transactionItem.txId = txid;
-        tx.vin.forEach(vin => (transactionItem.fee += vin.nFees));
+        if (joinSplit.valid) {
+          transactionItem.fee = new BigNumber(joinSplit.fee).div(SATOSHI).toNumber();
+        } else {
+          tx.vin.forEach(vin => (transactionItem.fee += vin.nFees));
+        }
         this._txs_by_external_index.unshift(transactionItem);
       }
     }
 
+    if (spentCoinIndexes.length > 0) {
+      await this.markCoinsSpend(spentCoinIndexes);
+    }
     this.sortTransactions();
   }
 
@@ -1163,9 +1475,12 @@ export class FiroWallet implements AbstractWallet {
     this._txs_by_external_index = [];
     this._txs_by_internal_index = [];
 
-    this._anonymity_sets = [];
-
-    this._used_serial_numbers = [];
+    this._unspent_coins = [];
+    this._unconfirmed_coins = [];
+    this._coin_table_loaded = false;
+    this._spends_in_progress = 0;
+    this._speculative_spend = false;
+    this._consolidating_coin_indexes = [];
 
     // this.internal_addresses_cache = {};
     // this.external_addresses_cache = {};
@@ -1,6 +1,25 @@
 import {BIP32Interface} from 'bip32/types/bip32';
 import RNLelantus from '../../react-native-lelantus';
+import {LelantusCoin} from '../data/LelantusCoin';
 import {LelantusEntry} from '../data/LelantusEntry';
+import {ScannedMint} from '../data/ScannedMint';
+import {ParsedJoinSplit} from '../data/ParsedJoinSplit';
+import {ConsolidationStep} from '../data/ConsolidationStep';
+import {AnonymitySet} from '../data/AnonymitySet';
+
+export enum CoinSelectionStrategy {
+  Default = 0,
+  MinInputs = 1,
+  MinSets = 2,
+  ExactMatch = 3,
+  SetAware = 4,
+}
+
+export enum CoinFilter {
+  All = 0,
+  Unspent = 1,
+  Unconfirmed = 2,
+}
 
 export class LelantusWrapper {
   static async lelantusMint(
@@ -123,34 +142,108 @@ export class LelantusWrapper {
     });
   }
 
+  static async createJMintBundle(
+    xprv: string,
+    index: number,
+    value: number,
+  ): Promise<{
+    script: string;
+    publicCoin: string;
+    tag: string;
+    serialNumber: string;
+    keyPath: number;
+  }> {
+    return new Promise(resolve => {
+      RNLelantus.getJMintBundle(
+        value,
+        xprv,
+        index,
+        (
+          script: string,
+          publicCoin: string,
+          tag: string,
+          serialNumber: string,
+          keyPath: number,
+        ) => {
+          resolve({script, publicCoin, tag, serialNumber, keyPath});
+        },
+      );
+    });
+  }
+
+  // spends every coin given, those selectSpendCoins picked for the fee
   static async lelantusSpend(
     value: number,
     subtractFeeFromAmount: boolean,
+    fee: number,
     keypair: BIP32Interface,
     index: number,
     coins: LelantusEntry[],
     txHash: string,
-    setIds: number[],
-    anonymitySets: string[][],
-    anonymitySetHashes: string[],
-    groupBlockHashes: string[],
   ) {
-    return new Promise<string>(resolve => {
-      RNLelantus.getSpendScript(
-        value,
-        subtractFeeFromAmount,
-        keypair.privateKey?.toString('hex'),
-        index,
-        coins,
-        txHash,
-        setIds,
-        anonymitySets,
-        anonymitySetHashes,
-        groupBlockHashes,
-        (script: string) => {
-          resolve(script);
-        },
-      );
+    // anonymity sets are read from the native set store, rejects when the
+    // spend can't be built
+    const script: string = await RNLelantus.getSpendScript(
+      value,
+      subtractFeeFromAmount,
+      fee,
+      keypair.privateKey?.toString('hex'),
+      index,
+      coins,
+      txHash,
+    );
+    return script;
+  }
+
+  // one proof paying every value to its own output, the fee on top
+  static async lelantusMultiRecipientSpend(
+    outputValues: number[],
+    fee: number,
+    keypair: BIP32Interface,
+    index: number,
+    coins: LelantusEntry[],
+    txHash: string,
+  ) {
+    const script: string = await RNLelantus.getMultiRecipientSpendScript(
+      outputValues,
+      fee,
+      keypair.privateKey?.toString('hex'),
+      index,
+      coins,
+      txHash,
+    );
+    return script;
+  }
+
+  /**
+   * Starts proving the spend natively, lelantusSpend with the same arguments
+   * takes the script over
+   */
+  static async startSpeculativeSpend(
+    value: number,
+    subtractFeeFromAmount: boolean,
+    fee: number,
+    keypair: BIP32Interface,
+    index: number,
+    coins: LelantusEntry[],
+    txHash: string,
+  ): Promise<void> {
+    await RNLelantus.startSpeculativeSpend(
+      value,
+      subtractFeeFromAmount,
+      fee,
+      keypair.privateKey?.toString('hex'),
+      index,
+      coins,
+      txHash,
+    );
+  }
+
+  static async discardSpeculativeSpend(): Promise<void> {
+    return new Promise(resolve => {
+      RNLelantus.discardSpeculativeSpend(() => {
+        resolve();
+      });
     });
   }
 
@@ -168,4 +261,357 @@ export class LelantusWrapper {
       );
     });
   }
+
+  static async getMintTagBatch(
+    xprv: string,
+    startIndex: number,
+    count: number,
+  ): Promise<string[]> {
+    return new Promise(resolve => {
+      RNLelantus.getMintTagBatch(
+        xprv,
+        startIndex,
+        count,
+        (tags: string[]) => {
+          resolve(tags);
+        },
+      );
+    });
+  }
+
+  static async createMintsBatch(
+    xprv: string,
+    indexes: number[],
+    values: number[],
+  ): Promise<
+    {
+      script: string;
+      publicCoin: string;
+      tag: string;
+      serialNumber: string;
+      keyPath: number;
+    }[]
+  > {
+    return new Promise(resolve => {
+      RNLelantus.createMintsBatch(
+        xprv,
+        indexes,
+        values,
+        (
+          bundles: {
+            script: string;
+            publicCoin: string;
+            tag: string;
+            serialNumber: string;
+            keyPath: number;
+          }[],
+        ) => {
+          resolve(bundles);
+        },
+      );
+    });
+  }
+
+  static async openUsedSerialSet(path: string): Promise<number> {
+    return new Promise(resolve => {
+      RNLelantus.openUsedSerialSet(path, (count: number) => {
+        resolve(count);
+      });
+    });
+  }
+
+  static async appendUsedSerials(serialsBase64: string[]): Promise<number> {
+    return new Promise(resolve => {
+      RNLelantus.appendUsedSerials(serialsBase64, (count: number) => {
+        resolve(count);
+      });
+    });
+  }
+
+  static async getAnonymitySetInfo(setId: number) {
+    return new Promise<{setHash: string; blockHash: string; size: number}>(
+      resolve => {
+        RNLelantus.getAnonymitySetInfo(
+          setId,
+          (setHash: string, blockHash: string, size: number) => {
+            resolve({setHash, blockHash, size});
+          },
+        );
+      },
+    );
+  }
+
+  /**
+   * Takes the JSON text of a lelantus.getanonymityset result, resolves with the
+   * positions of the new coins in the native store, undefined if it is malformed
+   */
+  static async mergeAnonymitySetResponse(setId: number, response: string) {
+    return new Promise<{first: number; count: number} | undefined>(resolve => {
+      RNLelantus.mergeAnonymitySetResponse(
+        setId,
+        response,
+        (first?: number, count?: number) => {
+          if (first === undefined || count === undefined) {
+            resolve(undefined);
+            return;
+          }
+          resolve({first, count});
+        },
+      );
+    });
+  }
+
+  static async openAnonymitySetStore(
+    directory: string,
+    memoryBudgetMb: number,
+  ): Promise<number[]> {
+    return new Promise(resolve => {
+      RNLelantus.openAnonymitySetStore(
+        directory,
+        memoryBudgetMb,
+        (setIds: number[]) => {
+          resolve(setIds);
+        },
+      );
+    });
+  }
+
+  static async updateAnonymitySet(anonymitySet: AnonymitySet): Promise<void> {
+    return new Promise(resolve => {
+      RNLelantus.updateAnonymitySet(
+        anonymitySet.setId,
+        anonymitySet.setHash,
+        anonymitySet.blockHash,
+        anonymitySet.coins,
+        () => {
+          resolve();
+        },
+      );
+    });
+  }
+
+  static async scanMints(
+    xprv: string,
+    startIndex: number,
+    gapLimit: number,
+  ): Promise<ScannedMint[]> {
+    return new Promise(resolve => {
+      RNLelantus.scanMints(
+        xprv,
+        startIndex,
+        gapLimit,
+        (mints: ScannedMint[]) => {
+          resolve(mints);
+        },
+      );
+    });
+  }
+
+  static async selectSpendCoins(
+    amounts: number[],
+    setIds: number[],
+    heights: number[],
+    spendAmount: number,
+    subtractFeeFromAmount: boolean,
+    strategy: CoinSelectionStrategy,
+    outputCount: number,
+  ) {
+    return new Promise<{
+      fee: number;
+      chageToMint: number;
+      positions: number[];
+    }>(resolve => {
+      RNLelantus.selectSpendCoins(
+        amounts,
+        setIds,
+        heights,
+        spendAmount,
+        subtractFeeFromAmount,
+        strategy,
+        outputCount,
+        (fee: number, chageToMint: number, positions: number[]) => {
+          resolve({fee, chageToMint, positions});
+        },
+      );
+    });
+  }
+
+  static async benchmarkCoinSelection(
+    coinCount: number,
+    rounds: number,
+  ): Promise<string> {
+    return new Promise(resolve => {
+      RNLelantus.benchmarkCoinSelection(coinCount, rounds, (report: string) => {
+        resolve(report);
+      });
+    });
+  }
+
+  static async quickEstimateFee(
+    amounts: number[],
+    setIds: number[],
+    spendAmount: number,
+    subtractFeeFromAmount: boolean,
+  ): Promise<number> {
+    return new Promise(resolve => {
+      RNLelantus.quickEstimateFee(
+        amounts,
+        setIds,
+        spendAmount,
+        subtractFeeFromAmount,
+        (fee: number) => {
+          resolve(fee);
+        },
+      );
+    });
+  }
+
+  static async getSpendProvingCost(setIds: number[]) {
+    return new Promise<{
+      deserializedPoints: number;
+      provedPoints: number;
+      setBytes: number;
+    }>(resolve => {
+      RNLelantus.getSpendProvingCost(
+        setIds,
+        (
+          deserializedPoints: number,
+          provedPoints: number,
+          setBytes: number,
+        ) => {
+          resolve({deserializedPoints, provedPoints, setBytes});
+        },
+      );
+    });
+  }
+
+  static async containsMintTags(tags: string[]): Promise<boolean[]> {
+    return new Promise(resolve => {
+      RNLelantus.containsMintTags(tags, (contains: boolean[]) => {
+        resolve(contains);
+      });
+    });
+  }
+
+  // resolves with the number of cached points of the sets
+  static async cacheAnonymitySetPoints(setIds: number[]): Promise<number> {
+    return new Promise(resolve => {
+      RNLelantus.cacheAnonymitySetPoints(setIds, (cached: number) => {
+        resolve(cached);
+      });
+    });
+  }
+
+  // resolves at once, the sets are built natively in the background
+  static async startSpendPrewarm(setIds: number[]): Promise<void> {
+    return new Promise(resolve => {
+      RNLelantus.startSpendPrewarm(setIds, () => {
+        resolve();
+      });
+    });
+  }
+
+  // resolves with the number of duplicate coins dropped
+  static async loadWalletCoins(coins: LelantusCoin[]): Promise<number> {
+    return new Promise(resolve => {
+      RNLelantus.loadWalletCoins(coins, (dropped: number) => {
+        resolve(dropped);
+      });
+    });
+  }
+
+  // resolves with the number of added or changed coins
+  static async putWalletCoins(coins: LelantusCoin[]): Promise<number> {
+    return new Promise(resolve => {
+      RNLelantus.putWalletCoins(coins, (changed: number) => {
+        resolve(changed);
+      });
+    });
+  }
+
+  static async markWalletCoinsUsed(indexes: number[]): Promise<number> {
+    return new Promise(resolve => {
+      RNLelantus.markWalletCoinsUsed(indexes, (marked: number) => {
+        resolve(marked);
+      });
+    });
+  }
+
+  static async markSpentWalletCoins(xprv: string): Promise<number> {
+    return new Promise(resolve => {
+      RNLelantus.markSpentWalletCoins(xprv, (marked: number) => {
+        resolve(marked);
+      });
+    });
+  }
+
+  // resolves with the tx ids of the coins that moved to a newer set
+  static async updateWalletCoinSetIds(): Promise<string[]> {
+    return new Promise(resolve => {
+      RNLelantus.updateWalletCoinSetIds((txIds: string[]) => {
+        resolve(txIds);
+      });
+    });
+  }
+
+  static async getWalletCoins(filter: CoinFilter): Promise<LelantusCoin[]> {
+    return new Promise(resolve => {
+      RNLelantus.getWalletCoins(filter, (coins: LelantusCoin[]) => {
+        resolve(coins);
+      });
+    });
+  }
+
+  static async getUnspentCoinSetIds(): Promise<number[]> {
+    return new Promise(resolve => {
+      RNLelantus.getUnspentCoinSetIds((setIds: number[]) => {
+        resolve(setIds);
+      });
+    });
+  }
+
+  // one entry per raw tx hex, entries of txs that are no lelantus spend are not valid
+  static async parseJoinSplits(rawTxs: string[]): Promise<ParsedJoinSplit[]> {
+    return new Promise(resolve => {
+      RNLelantus.parseJoinSplits(rawTxs, (joinSplits: ParsedJoinSplit[]) => {
+        resolve(joinSplits);
+      });
+    });
+  }
+
+  // self-spends merging the coins of crowded sets, positions refer to amounts
+  static async planConsolidation(
+    amounts: number[],
+    setIds: number[],
+    minCoins: number,
+    maxInputs: number,
+  ): Promise<ConsolidationStep[]> {
+    return new Promise(resolve => {
+      RNLelantus.planConsolidation(
+        amounts,
+        setIds,
+        minCoins,
+        maxInputs,
+        (steps: ConsolidationStep[]) => {
+          resolve(steps);
+        },
+      );
+    });
+  }
+
+  // proves a self-spend of every coin into the jmint at index
+  static async consolidationSpend(
+    keypair: BIP32Interface,
+    index: number,
+    coins: LelantusEntry[],
+    txHash: string,
+  ) {
+    const script: string = await RNLelantus.getConsolidationScript(
+      keypair.privateKey?.toString('hex'),
+      index,
+      coins,
+      txHash,
+    );
+    return script;
+  }
 }
@@ -0,0 +1,12 @@
+export class ConsolidationStep {
+  // positions of the merged coins in the coins passed to the planner
+  positions: number[] = [];
+  anonymitySetId: number = 0;
+  fee: number = 0;
+  mintValue: number = 0;
+  provingCost: {
+    deserializedPoints: number;
+    provedPoints: number;
+    setBytes: number;
+  } = {deserializedPoints: 0, provedPoints: 0, setBytes: 0};
+}
@@ -0,0 +1,8 @@
+export class ParsedJoinSplit {
+  valid: boolean = false;
+  fee: number = 0;
+  serialNumbers: string[] = [];
+  spentCoinIndexes: number[] = [];
+  publicCoins: string[] = [];
+  encryptedValues: string[] = [];
+}
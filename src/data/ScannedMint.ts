@@ -0,0 +1,5 @@
+import {LelantusCoin} from './LelantusCoin';
+
+export class ScannedMint extends LelantusCoin {
+  isJMint: boolean = false;
+}
@@ -183,6 +183,8 @@ export interface IString extends LocalizedStringsMethods {
 
   my_wallet_screen: {
     title: string;
+    title_consolidation: string;
+    description_consolidation: string;
   };
 
   address_details_screen: {
@@ -226,6 +228,8 @@ export interface IString extends LocalizedStringsMethods {
     description_currency: string;
     title_notification: string;
     description_notification: string;
+    title_consolidation: string;
+    description_consolidation: string;
     title_passphrase: string;
     description_passphrase: string;
     title_mnemonic: string;
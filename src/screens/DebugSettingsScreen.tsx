@@ -9,6 +9,7 @@ import {CurrentFiroTheme} from '../Themes';
 import {FiroToolbar} from '../components/Toolbar';
 import Logger from '../utils/logger';
 import { FiroStatusBar } from '../components/FiroStatusBar';
+import {LelantusWrapper} from '../core/LelantusWrapper';
 
 const { colors, } = CurrentFiroTheme;
 
@@ -21,6 +22,11 @@ const DebugSettingsScreen = () => {
     Logger.shareAndroid();
   };
 
+  const benchmarkCoinSelection = async () => {
+    const report = await LelantusWrapper.benchmarkCoinSelection(10000, 10);
+    Logger.info('debug_settings:benchmarkCoinSelection', report);
+  };
+
   return (
     <View>
       <FiroToolbar title={'Debug Settings'} />
@@ -40,6 +46,16 @@ const DebugSettingsScreen = () => {
             <Text style={styles.title}>Clear Logs</Text>
           </View>
         </TouchableHighlight>
+        <TouchableHighlight
+          underlayColor={colors.highlight}
+          onPress={benchmarkCoinSelection}>
+          <View style={styles.section}>
+            <Text style={styles.title}>Benchmark Coin Selection</Text>
+            <Text style={styles.description}>
+              Results are written to the log file
+            </Text>
+          </View>
+        </TouchableHighlight>
       </View>
     </View>
   );
@@ -1,5 +1,5 @@
 import React, {useContext, useState, useEffect} from 'react';
-import {StyleSheet, View} from 'react-native';
+import {Alert, StyleSheet, View} from 'react-native';
 import {FiroToolbarWithoutBack} from '../components/Toolbar';
 import {BalanceCard} from '../components/BalanceCard';
 import {TransactionList} from '../components/TransactionList';
@@ -14,11 +14,16 @@ import {useFocusEffect} from '@react-navigation/native';
 import BigNumber from 'bignumber.js';
 import Logger from '../utils/logger';
 import {FiroStatusBar} from '../components/FiroStatusBar';
+import {isBatteryCharging} from 'react-native-device-info';
+import {FiroConsolidationStep} from '../core/AbstractWallet';
 
 const {colors} = CurrentFiroTheme;
 
+// a consolidation is offered at most once at a time, and not again once declined
+let consolidationOffered = false;
+
 const MyWalletScreen = () => {
-  const {getWallet} = useContext(FiroContext);
+  const {getWallet, getSettings} = useContext(FiroContext);
   const [balance, setBalance] = useState(new BigNumber(0));
   const [unconfirmedBalance, setUnconfirmedBalance] = useState(
     new BigNumber(0),
@@ -72,9 +77,9 @@ const MyWalletScreen = () => {
         const txId = await firoElectrum.broadcast(mintTxResult.txHex);
 
         if (txId === mintTxResult.txId) {
-          mintTxResult.mints.forEach(mint => {
-            wallet.addLelantusMintToCache(txId, mint.value, mint.publicCoin, mint.index);
-          });
+          for (const mint of mintTxResult.mints) {
+            await wallet.addLelantusMintToCache(txId, mint.value, mint.publicCoin, mint.index);
+          }
           wallet.addMintTxToCache(
             txId,
             new BigNumber(mintTxResult.value).div(SATOSHI).toNumber(),
@@ -118,6 +123,81 @@ const MyWalletScreen = () => {
     }
   };
 
+  // offered while charging when the user turned it on, and nothing is unconfirmed or being sent
+  const offerConsolidation = async () => {
+    const wallet = getWallet();
+    if (!wallet || synced !== true || consolidationOffered) {
+      return;
+    }
+    if (getSettings().consolidationEnabled !== true) {
+      return;
+    }
+    try {
+      // a send in progress may be proving over the same coins
+      if (wallet.isSpendPending() || !wallet.getUnconfirmedBalance().isZero()) {
+        return;
+      }
+      if (!(await isBatteryCharging())) {
+        return;
+      }
+      const steps = await wallet.planConsolidation();
+      if (steps.length === 0) {
+        return;
+      }
+      const step = steps[0];
+
+      // the fee is paid from the wallet, nothing is signed before the user agrees
+      consolidationOffered = true;
+      Alert.alert(
+        localization.my_wallet_screen.title_consolidation,
+        localization.formatString(
+          localization.my_wallet_screen.description_consolidation,
+          step.spendCoinIndexes.length,
+          new BigNumber(step.fee).div(SATOSHI).toString(),
+        ) as string,
+        [
+          {text: localization.component_button.cancel, style: 'cancel'},
+          {
+            text: localization.component_button.ok,
+            onPress: () => {
+              consolidateCoins(step).finally(() => {
+                consolidationOffered = false;
+              });
+            },
+          },
+        ],
+      );
+    } catch (e) {
+      Logger.error('my_wallet_screen:offerConsolidation', e);
+    }
+  };
+
+  const consolidateCoins = async (step: FiroConsolidationStep) => {
+    const wallet = getWallet();
+    // a send may have started while the dialog was open
+    if (!wallet || wallet.isSpendPending()) {
+      return;
+    }
+    try {
+      const spendData = await wallet.createConsolidationTx(step);
+      const txId = await firoElectrum.broadcast(spendData.txHex);
+      if (txId === spendData.txId) {
+        await wallet.addLelantusMintToCache(
+          txId,
+          spendData.jmintValue,
+          spendData.publicCoin,
+          spendData.mintIndex,
+        );
+        await wallet.markCoinsSpend(spendData.spendCoinIndexes);
+        await saveToDisk();
+      } else {
+        Logger.error('my_wallet_screen:consolidateCoins', 'wrong txIds received');
+      }
+    } catch (e) {
+      Logger.error('my_wallet_screen:consolidateCoins', e);
+    }
+  };
+
   const updateMintMetadata = async () => {
     const wallet = getWallet();
     if (!wallet) {
@@ -169,6 +249,7 @@ const MyWalletScreen = () => {
     await syncWallet();
     await updateMintMetadata();
     await mintUnspentTransactions();
+    await offerConsolidation();
     updating = false;
     setSync(false);
     updateBalance();
@@ -1,4 +1,4 @@
-import React, {FC, useState} from 'react';
+import React, {FC, useRef, useState} from 'react';
 import {RouteProp} from '@react-navigation/native';
 import {
   View,
@@ -60,6 +60,8 @@ const SendConfirmScreen: FC<SendConfirmProps> = props => {
     saveToDisk,
   } = useContext(FiroContext);
   const [processing, setProcessing] = useState(false);
+  // locktime of the spend proved while the screen is shown
+  const speculativeLocktime = useRef<number | undefined>(undefined);
   const [bottomSheetViewMode, changeBottomSheetViewMode] = useState(
     BottomSheetViewMode.None,
   );
@@ -111,6 +113,7 @@ const SendConfirmScreen: FC<SendConfirmProps> = props => {
         spendAmount: amount,
         subtractFeeFromAmount,
         address: address,
+        locktime: speculativeLocktime.current,
       });
 
       const txId = await firoElectrum.broadcast(spendData.txHex);
@@ -123,13 +126,13 @@ const SendConfirmScreen: FC<SendConfirmProps> = props => {
           new BigNumber(spendData.fee).div(SATOSHI).toNumber(),
           address,
         );
-        wallet?.addLelantusMintToCache(
+        await wallet?.addLelantusMintToCache(
           txId,
           spendData.jmintValue,
           spendData.publicCoin,
           spendData.mintIndex
         );
-        wallet?.markCoinsSpend(spendData.spendCoinIndexes);
+        await wallet?.markCoinsSpend(spendData.spendCoinIndexes);
         await saveToDisk();
       } else {
         Logger.error('send_confirm_screen:doSpend', 'wrong txIds received');
@@ -227,6 +230,36 @@ const SendConfirmScreen: FC<SendConfirmProps> = props => {
       e.preventDefault();
     }
   };
+  useEffect(() => {
+    // the proof starts while the user reviews the spend, confirming takes it over
+    const wallet = getWallet();
+    const {amount, reduceFeeFromAmount, address} = props.route.params.data;
+    let cancelled = false;
+    if (wallet && amount <= SPEND_LIMIT && wallet.validate(address)) {
+      wallet
+        .startSpeculativeSpend({
+          spendAmount: amount,
+          subtractFeeFromAmount: reduceFeeFromAmount,
+          address,
+        })
+        .then(locktime => {
+          speculativeLocktime.current = locktime;
+        })
+        .catch(e => {
+          Logger.warn('send_confirm_screen:startSpeculativeSpend', e);
+        })
+        .finally(() => {
+          // the discard on leaving can run before the proof reached native code
+          if (cancelled) {
+            wallet.discardSpeculativeSpend();
+          }
+        });
+    }
+    return () => {
+      cancelled = true;
+      wallet?.discardSpeculativeSpend();
+    };
+  }, []);
   useEffect(() => {
     props.navigation.addListener('beforeRemove', navBeforeRemove);
     return () =>
@@ -21,7 +21,7 @@ import {FiroStatusBar} from '../components/FiroStatusBar';
 import { Card } from '../components/Card';
 
 const {colors} = CurrentFiroTheme;
-var timerHandler: number = -1;
+let estimateRequest = 0;
 let changeAmountCallback: (amount: string) => void;
 let changeAddressCallback: (address: string) => void;
 
@@ -40,40 +40,40 @@ const SendScreen = () => {
   ];
 
   const rate = getFiroRate();
-  const estimateFee = (amount: number, subtractFeeFromAmount: boolean) => {
-    if (timerHandler !== -1) {
-      clearTimeout(timerHandler);
+  const estimateFee = async (amount: number, subtractFeeFromAmount: boolean) => {
+    // the fee is computed natively from amounts only, so it is recomputed on every
+    // change, results of older requests are dropped
+    const request = ++estimateRequest;
+    setIsValid(false);
+    const wallet = getWallet();
+    if (!wallet) {
+      return;
     }
-    timerHandler = setTimeout(async () => {
-      setIsValid(false);
-      const wallet = getWallet();
-      if (!wallet) {
-        return;
-      }
-      if (amount === 0) {
-        setFee(0);
-        setTotal(0);
+    if (amount === 0) {
+      setFee(0);
+      setTotal(0);
+      return;
+    }
+    try {
+      const changedFee = await wallet.quickEstimateFee({
+        spendAmount: amount,
+        subtractFeeFromAmount,
+      });
+      if (request !== estimateRequest) {
         return;
       }
-      try {
-        const estimate = await wallet.estimateJoinSplitFee({
-          spendAmount: amount,
-          subtractFeeFromAmount,
-        });
-        const changedFee = estimate.fee;
 
-        setFee(changedFee);
-        if (changedFee === 0) {
-          setTotal(0);
-        } else {
-          const sub = subtractFeeFromAmount ? 0 : 1;
-          setTotal(amount + sub * changedFee);
-        }
-        checkIsValid(changedFee, sendAddress);
-      } catch (e) {
-        Logger.error('send_screen:estimateFee', e);
+      setFee(changedFee);
+      if (changedFee === 0) {
+        setTotal(0);
+      } else {
+        const sub = subtractFeeFromAmount ? 0 : 1;
+        setTotal(amount + sub * changedFee);
       }
-    }, 300);
+      checkIsValid(changedFee, sendAddress);
+    } catch (e) {
+      Logger.error('send_screen:estimateFee', e);
+    }
   };
 
   const checkIsValid = (fee: number, address: string) => {
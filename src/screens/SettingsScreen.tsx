@@ -121,6 +121,39 @@ const SettingsScreen = () => {
           </View>
         </View>
       </TouchableHighlight>
+      <View style={styles.section}>
+        <View
+          style={{
+            display: 'flex',
+            flexDirection: 'row',
+            alignItems: 'flex-start',
+          }}>
+          <View style={{ flex: 1 }}>
+            <Text style={styles.title}>
+              {localization.settings.title_consolidation}
+            </Text>
+            <Text style={styles.description}>
+              {localization.settings.description_consolidation}
+            </Text>
+          </View>
+          <Switch
+            value={getSettings().consolidationEnabled === true}
+            thumbColor={colors.switchThumb}
+            trackColor={{
+              false: colors.switchTrackFalse,
+              true: colors.switchTrackTrue,
+            }}
+            disabled={saveInProgress}
+            onValueChange={enable => {
+              changeSaveProgress(true);
+              setSettings({
+                ...getSettings(),
+                consolidationEnabled: enable,
+              }).finally(() => changeSaveProgress(false));
+            }}
+          />
+        </View>
+      </View>
       {/* <TouchableHighlight
         disabled={saveInProgress}
         underlayColor={colors.highlight}